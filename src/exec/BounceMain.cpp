@@ -7,7 +7,7 @@
 class Simulator
 {
 public:
-    explicit Simulator(int, int, sim::SimData *pSimData)
+    explicit Simulator(int width, int height, sim::SimData *pSimData)
         : renderer_{sim::PosNormTexMesh(sim::create_sphere_mesh_data<sim::PosNormTexVertex>)}, simData_{*pSimData}
     {
         simData_.cameraMover.setUsingOrbitMode(true);
@@ -17,41 +17,27 @@ public:
 
         simData_.paused = true;
 
-        prevCam_ = simData_.camera();
+        renderer_.resize(width, height);
 
         model_ = glm::translate(glm::mat4{1}, {0, 0, 0}) * glm::scale(glm::mat4{1}, glm::vec3(0.9f, 0.5f, 0.5f));
-        renderer_.setModelMatrix(model_);
+        modelState_ = simData_.interpolator.addMatrix(model_);
     }
 
     void onUpdate(double, double timeStep)
     {
-        prevCam_ = simData_.camera();
         simData_.cameraMover.yaw(static_cast<float>(timeStep * 25));
+        simData_.interpolator.setMatrix(modelState_, model_);
     }
 
     void onRender(int, int, double alpha)
     {
-        auto a = static_cast<float>(alpha);
-
-        if (simData_.paused) {
-            renderer_.render(a, simData_.camera());
-        } else {
-            sim::Camera &currCam = simData_.camera();
-            sim::Camera camera;
-
-            glm::vec3 eye{glm::mix(prevCam_.getEyeVector(), currCam.getEyeVector(), a)};
-            glm::vec3 look{glm::mix(prevCam_.getLookVector(), currCam.getLookVector(), a)};
-            glm::vec3 up{glm::mix(prevCam_.getUpVector(), currCam.getUpVector(), a)};
-
-            float aspect{glm::mix(prevCam_.getAspectRatio(), currCam.getAspectRatio(), a)};
-
-            camera.lookAt(eye, eye + look, up);
-            camera.perspective(currCam.getFovYDegrees(), aspect, currCam.getNearPlane(), currCam.getFarPlane());
-
-            renderer_.render(a, camera);
-        }
+        renderer_.setModelMatrix(simData_.interpolator.getMatrix(modelState_));
+        renderer_.update(simData_.renderCamera());
+        renderer_.render(static_cast<float>(alpha), simData_.renderCamera());
     }
 
+    void framebufferSizeCallback(GLFWwindow *, int width, int height) { renderer_.resize(width, height); }
+
     void onGuiRender(int, int)
     {
         ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, 0.0f);
@@ -74,9 +60,9 @@ public:
 private:
     sim::MeshRenderer renderer_;
     sim::SimData &simData_;
-    sim::Camera prevCam_;
 
     glm::mat4 model_{1};
+    sim::StateInterpolator::MatrixHandle modelState_{};
     glm::vec3 gravity_{0, -9.8f, 0};
 };
 
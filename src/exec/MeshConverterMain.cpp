@@ -0,0 +1,71 @@
+#include <sim-driver/meshes/MeshFile.hpp>
+#include <sim-driver/meshes/MeshImport.hpp>
+#include <sim-driver/meshes/MeshOptimizer.hpp>
+#include <sim-driver/meshes/MeshSimplifier.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+void print_usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " <input.obj|input.ply> <output.simmesh> [--lods N] [--ratio R]\n"
+              << "  --lods N   number of simplified levels to add (default 0)\n"
+              << "  --ratio R  triangle ratio between consecutive levels (default 0.5)\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const std::string input = argv[1];
+    const std::string output = argv[2];
+    int numLods = 0;
+    float ratio = 0.5f;
+
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--lods") == 0 && i + 1 < argc) {
+            numLods = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--ratio") == 0 && i + 1 < argc) {
+            ratio = static_cast<float>(std::atof(argv[++i]));
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    try {
+        sim::PosNormTexData data = sim::import_mesh(input);
+        std::cout << input << ": " << data.vbo.size() << " vertices, " << data.ibo.size() / 3 << " triangles"
+                  << std::endl;
+
+        if (numLods > 0) {
+            std::vector<std::size_t> targets = sim::make_lod_targets(data.ibo.size() / 3, numLods, ratio);
+            std::vector<sim::MeshLod> lods = sim::create_lod_chain(data, GL_TRIANGLES, targets);
+
+            for (std::size_t i = 0; i < lods.size(); ++i) {
+                std::cout << "  level " << i << ": " << lods[i].data.ibo.size() / 3 << " triangles, error "
+                          << lods[i].error << std::endl;
+            }
+            sim::write_mesh_file(output, lods);
+        } else {
+            sim::optimize_mesh(&data, GL_TRIANGLES);
+            sim::write_mesh_file(output, data, GL_TRIANGLES);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Wrote " << output << std::endl;
+    return EXIT_SUCCESS;
+}
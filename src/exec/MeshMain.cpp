@@ -6,7 +6,7 @@
 class Simulator
 {
 public:
-    explicit Simulator(int, int, sim::SimData *pSimData)
+    explicit Simulator(int width, int height, sim::SimData *pSimData)
         : renderer_{sim::PosNormTexMesh(sim::create_sphere_mesh_data<sim::PosNormTexVertex>)}, simData_{*pSimData}
     {
         simData_.camera().setNearPlane(0.1f);
@@ -15,38 +15,22 @@ public:
         simData_.cameraMover.setOrbitOrigin({0, 0, 0});
         simData_.cameraMover.setOrbitOffsetDistance(5);
 
-        prevCam_ = simData_.camera();
+        renderer_.resize(width, height);
     }
 
     void onUpdate(double, double timeStep)
     {
-        prevCam_ = simData_.camera();
         simData_.cameraMover.yaw(static_cast<float>(timeStep * 25.0));
     }
 
     void onRender(int, int, double alpha)
     {
-        auto a = static_cast<float>(alpha);
-
-        if (simData_.paused) {
-            renderer_.render(a, simData_.camera());
-        } else {
-            sim::Camera &currCam = simData_.camera();
-            sim::Camera camera;
-
-            glm::vec3 eye{glm::mix(prevCam_.getEyeVector(), currCam.getEyeVector(), a)};
-            glm::vec3 look{glm::mix(prevCam_.getLookVector(), currCam.getLookVector(), a)};
-            glm::vec3 up{glm::mix(prevCam_.getUpVector(), currCam.getUpVector(), a)};
-
-            float aspect{glm::mix(prevCam_.getAspectRatio(), currCam.getAspectRatio(), a)};
-
-            camera.lookAt(eye, eye + look, up);
-            camera.perspective(currCam.getFovYDegrees(), aspect, currCam.getNearPlane(), currCam.getFarPlane());
-
-            renderer_.render(a, camera);
-        }
+        renderer_.update(simData_.renderCamera());
+        renderer_.render(static_cast<float>(alpha), simData_.renderCamera());
     }
 
+    void framebufferSizeCallback(GLFWwindow *, int width, int height) { renderer_.resize(width, height); }
+
     void onGuiRender(int, int)
     {
         ImGui::SetNextWindowPos(ImVec2(0, 0));
@@ -60,7 +44,6 @@ public:
 private:
     sim::MeshRenderer renderer_;
     sim::SimData &simData_;
-    sim::Camera prevCam_;
 };
 
 int main()
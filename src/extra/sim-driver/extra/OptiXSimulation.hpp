@@ -113,13 +113,11 @@ OptiXSimulation<Child>::OptiXSimulation(const SimInitData &initData, Args... arg
     this->setCallbackClass(&callbacks_);
 
     renderer_.setDataFun([] {
-        sim::PosNormTexData data;
-        data.vbo = {{{-1, -1, 0}, {0, 0, 1}, {0, 1}},
-                    {{1, -1, 0}, {0, 0, 1}, {1, 1}},
-                    {{-1, 1, 0}, {0, 0, 1}, {0, 0}},
-                    {{1, 1, 0}, {0, 0, 1}, {1, 0}}};
-        data.vaoElements = sim::posNormTexVaoElements();
-        return data;
+        static const sim::PosNormTexVertex quad[] = {{{-1, -1, 0}, {0, 0, 1}, {0, 1}},
+                                                     {{1, -1, 0}, {0, 0, 1}, {1, 1}},
+                                                     {{-1, 1, 0}, {0, 0, 1}, {0, 0}},
+                                                     {{1, 1, 0}, {0, 0, 1}, {1, 0}}};
+        return sim::PosNormTexDataView(quad, 4);
     });
 
     renderer_.setDisplayMode(4);
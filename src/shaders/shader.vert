@@ -14,6 +14,7 @@ out Vertex
     vec3 world_position;
     vec3 world_normal;
     vec2 tex_coords;
+    vec3 color;
 } vertex;
 
 out gl_PerVertex
@@ -26,6 +27,7 @@ void main(void)
     vertex.world_position = vec3(world_from_local * vec4(local_position, 1.0));
     vertex.world_normal = normalize(world_from_local_normals * local_normal);
     vertex.tex_coords = tex_coords;
+    vertex.color = vec3(1.0);
 
     gl_Position = screen_from_world * vec4(vertex.world_position, 1.0);
 }
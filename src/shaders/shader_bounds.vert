@@ -0,0 +1,18 @@
+#version 410
+#extension GL_ARB_separate_shader_objects : enable
+
+// corners of the unit cube
+layout(location = 0) in vec3 local_position;
+
+uniform mat4 screen_from_world = mat4(1.0);
+uniform mat4 world_from_box = mat4(1.0);
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+};
+
+void main(void)
+{
+    gl_Position = screen_from_world * world_from_box * vec4(local_position, 1.0);
+}
@@ -0,0 +1,7 @@
+#version 410
+#extension GL_ARB_separate_shader_objects : enable
+
+// depth pre-pass: color writes are masked so there is nothing to shade
+void main(void)
+{
+}
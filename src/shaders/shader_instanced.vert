@@ -0,0 +1,38 @@
+#version 410
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec3 local_position;
+layout(location = 1) in vec3 local_normal;
+layout(location = 2) in vec2 tex_coords;
+
+// InstanceData: advanced once per instance (divisor 1)
+layout(location = 3) in mat4 world_from_local; // occupies locations 3 - 6
+layout(location = 7) in vec4 instance_color;
+
+uniform mat4 screen_from_world    = mat4(1.0);
+uniform mat4 local_from_quantized = mat4(1.0); // identity unless the mesh is quantized
+
+out Vertex
+{
+    vec3 world_position;
+    vec3 world_normal;
+    vec2 tex_coords;
+    vec3 color;
+} vertex;
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+};
+
+void main(void)
+{
+    mat3 world_from_local_normals = transpose(inverse(mat3(world_from_local)));
+
+    vertex.world_position = vec3(world_from_local * local_from_quantized * vec4(local_position, 1.0));
+    vertex.world_normal = normalize(world_from_local_normals * local_normal);
+    vertex.tex_coords = tex_coords;
+    vertex.color = instance_color.rgb;
+
+    gl_Position = screen_from_world * vec4(vertex.world_position, 1.0);
+}
@@ -6,13 +6,22 @@ in Vertex
     vec3 world_position;
     vec3 world_normal;
     vec2 tex_coords;
+    vec3 color;
 } vertex;
 
 const float PI = 3.141592653589793;
 
+// Specialized variants are compiled with DISPLAY_MODE (and HAS_TEXTURE) defined so only
+// one branch is kept. Without DISPLAY_MODE the mode is picked at runtime.
+#if !defined(DISPLAY_MODE) || defined(HAS_TEXTURE)
+#define USE_TEXTURE
+#endif
+
 uniform int displayMode = 5;
 uniform vec3 shapeColor = vec3(1, 0.9, 0.7);
+#ifdef USE_TEXTURE
 uniform sampler2D tex;
+#endif
 uniform vec3 lightDir = normalize(vec3(0.7, 0.85, 1.0));
 
 uniform float roughness = 0.2;
@@ -20,8 +29,10 @@ uniform vec3  IOR = vec3(1.5145, 1.5208, 1.5232);
 uniform vec3  eye;
 
 uniform float alpha = 1.0;
+uniform uint object_id = 0xffffffffu; // IdBuffer::no_object
 
 layout(location = 0) out vec4 outColor;
+layout(location = 1) out uvec2 outId; // only stored when rendering into an IdBuffer
 
 
 ////////////non-polaraized and non-magnetic////////////
@@ -58,7 +69,8 @@ float fresnel(in  vec3  w_i,
 ////////////Cook-Torrance////////////
 vec3 calcBRDF(in vec3 V,
               in vec3 N,
-              in vec3 L)
+              in vec3 L,
+              in vec3 baseColor)
 {
     // roughness == m in cook-torrance lingo
     float m = roughness;
@@ -85,11 +97,11 @@ vec3 calcBRDF(in vec3 V,
     float D = ( 1.0 / ( PI * mPo2 * cosNHPow2 * cosNHPow2 ) )
               * exp( ( cosNHPow2 - 1.0 ) / ( mPo2 * cosNHPow2 ) );
 
-    // return shapeColor * ( F * D * G ) / ( PI * cosNL * cosNV );
-    // return shapeColor * F;
-    vec3 specular = shapeColor * ( F * D * G ) / ( PI * cosNL * cosNV );
+    // return baseColor * ( F * D * G ) / ( PI * cosNL * cosNV );
+    // return baseColor * F;
+    vec3 specular = baseColor * ( F * D * G ) / ( PI * cosNL * cosNV );
 
-    vec3 diffuse = shapeColor * ( 1.0 - F ) / PI;
+    vec3 diffuse = baseColor * ( 1.0 - F ) / PI;
 
     return diffuse + specular;
 }
@@ -97,10 +109,17 @@ vec3 calcBRDF(in vec3 V,
 void main(void)
 {
     vec3 color = vec3(1);
+    vec3 baseColor = shapeColor * vertex.color; // vertex color is a per instance tint
 
     vec3 normal = normalize(gl_FrontFacing ? vertex.world_normal : -vertex.world_normal);
 
-    switch(displayMode)
+#ifdef DISPLAY_MODE
+    const int mode = DISPLAY_MODE;
+#else
+    int mode = displayMode;
+#endif
+
+    switch(mode)
     {
     case 0:
         color = vertex.world_position;
@@ -112,16 +131,20 @@ void main(void)
         color = vec3(vertex.tex_coords, 1.0);
         break;
     case 3:
-        color = shapeColor;
+        color = baseColor;
         break;
     case 4:
+#ifdef USE_TEXTURE
         color = texture(tex, vertex.tex_coords).rgb;
+#else
+        color = vec3(0.0); // nothing bound to sample
+#endif
         break;
     case 5:
     {
         float ambient = 0.1;
         float intensity = max(ambient, dot(normal, lightDir));
-        color = shapeColor * intensity;
+        color = baseColor * intensity;
     }
         break;
     case 6:
@@ -133,11 +156,11 @@ void main(void)
         {
             vec3 w_l = lightDir;
 
-            intensity += calcBRDF(w_v, normal, w_l)
+            intensity += calcBRDF(w_v, normal, w_l, baseColor)
                          * 0.8
                          * max(0.0, dot(normal, w_l));
         }
-        color = shapeColor * intensity;
+        color = baseColor * intensity;
     }
         break;
     default:
@@ -145,4 +168,5 @@ void main(void)
     }
 
     outColor = vec4(color, alpha);
+    outId = uvec2(object_id, uint(gl_PrimitiveID));
 }
@@ -0,0 +1,40 @@
+#version 410
+#extension GL_ARB_separate_shader_objects : enable
+
+// PackedPosNormTexVertex: the vertex fetch already converts the normalized
+// integer attributes to floats so only the positions and texture coordinates
+// need to be rescaled
+layout(location = 0) in vec3 quantized_position; // UNORM16 over the mesh bounds
+layout(location = 1) in vec4 packed_normal;      // GL_INT_2_10_10_10_REV snorm
+layout(location = 2) in vec2 tex_coords;         // UNORM16 over the texture range
+
+uniform mat4 screen_from_world        = mat4(1.0);
+uniform mat4 world_from_local         = mat4(1.0);
+uniform mat3 world_from_local_normals = mat3(1.0);
+uniform mat4 local_from_quantized     = mat4(1.0);
+uniform vec4 tex_from_quantized       = vec4(1.0, 1.0, 0.0, 0.0); // scale (xy), offset (zw)
+
+out Vertex
+{
+    vec3 world_position;
+    vec3 world_normal;
+    vec2 tex_coords;
+    vec3 color;
+} vertex;
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+};
+
+void main(void)
+{
+    vec4 local_position = local_from_quantized * vec4(quantized_position, 1.0);
+
+    vertex.world_position = vec3(world_from_local * local_position);
+    vertex.world_normal = normalize(world_from_local_normals * packed_normal.xyz);
+    vertex.tex_coords = tex_coords * tex_from_quantized.xy + tex_from_quantized.zw;
+    vertex.color = vec3(1.0);
+
+    gl_Position = screen_from_world * vec4(vertex.world_position, 1.0);
+}
@@ -0,0 +1,49 @@
+#version 410
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shader_storage_buffer_object : require
+#extension GL_ARB_shader_draw_parameters : require
+
+layout(location = 0) in vec3 local_position;
+layout(location = 1) in vec3 local_normal;
+layout(location = 2) in vec2 tex_coords;
+
+// matches sim::InstanceData
+struct DrawData
+{
+    mat4 world_from_local;
+    vec4 color;
+};
+
+// one entry per indirect command of the MeshPool
+layout(std430, binding = 1) readonly buffer drawData
+{
+    DrawData draws[];
+};
+
+uniform mat4 screen_from_world = mat4(1.0);
+
+out Vertex
+{
+    vec3 world_position;
+    vec3 world_normal;
+    vec2 tex_coords;
+    vec3 color;
+} vertex;
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+};
+
+void main(void)
+{
+    DrawData draw = draws[gl_DrawIDARB];
+    mat3 world_from_local_normals = transpose(inverse(mat3(draw.world_from_local)));
+
+    vertex.world_position = vec3(draw.world_from_local * vec4(local_position, 1.0));
+    vertex.world_normal = normalize(world_from_local_normals * local_normal);
+    vertex.tex_coords = tex_coords;
+    vertex.color = draw.color.rgb;
+
+    gl_Position = screen_from_world * vec4(vertex.world_position, 1.0);
+}
@@ -0,0 +1,103 @@
+#include <sim-driver/Bounds.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <algorithm>
+
+namespace sim {
+
+namespace {
+
+template <typename Vertex>
+glm::vec3 attribute_position(const Vertex &vertex)
+{
+    return {vertex.position[0], vertex.position[1], vertex.position[2]};
+}
+
+/// As seen by the shader (normalized) before the local from quantized matrix is applied
+glm::vec3 attribute_position(const sim::PackedPosNormTexVertex &vertex)
+{
+    return {sim::unpack_unorm16(vertex.position[0]),
+            sim::unpack_unorm16(vertex.position[1]),
+            sim::unpack_unorm16(vertex.position[2])};
+}
+
+} // namespace
+
+void AABB::expand(const glm::vec3 &point)
+{
+    lower = glm::min(lower, point);
+    upper = glm::max(upper, point);
+}
+
+void AABB::expand(const AABB &box)
+{
+    lower = glm::min(lower, box.lower);
+    upper = glm::max(upper, box.upper);
+}
+
+bool AABB::isEmpty() const
+{
+    return lower.x > upper.x || lower.y > upper.y || lower.z > upper.z;
+}
+
+glm::vec3 AABB::center() const
+{
+    return (lower + upper) * 0.5f;
+}
+
+glm::vec3 AABB::extents() const
+{
+    return (upper - lower) * 0.5f;
+}
+
+template <typename Vertex>
+AABB compute_bounds(const Vertex *pVertices, std::size_t numVertices)
+{
+    AABB box;
+    for (std::size_t i = 0; i < numVertices; ++i) {
+        box.expand(attribute_position(pVertices[i]));
+    }
+    return box;
+}
+
+BoundingSphere bounding_sphere(const AABB &box)
+{
+    if (box.isEmpty()) {
+        return {};
+    }
+    return {box.center(), glm::length(box.extents())};
+}
+
+float max_scale(const glm::mat4 &matrix)
+{
+    float scaleX = glm::length(glm::vec3(matrix[0]));
+    float scaleY = glm::length(glm::vec3(matrix[1]));
+    float scaleZ = glm::length(glm::vec3(matrix[2]));
+    return std::max(scaleX, std::max(scaleY, scaleZ));
+}
+
+BoundingSphere transform_sphere(const BoundingSphere &sphere, const glm::mat4 &matrix)
+{
+    return {glm::vec3(matrix * glm::vec4(sphere.center, 1.0f)), sphere.radius * max_scale(matrix)};
+}
+
+AABB transform_box(const AABB &box, const glm::mat4 &matrix)
+{
+    AABB result;
+    if (box.isEmpty()) {
+        return result;
+    }
+
+    for (int corner = 0; corner < 8; ++corner) {
+        glm::vec3 point{(corner & 1) ? box.upper.x : box.lower.x,
+                        (corner & 2) ? box.upper.y : box.lower.y,
+                        (corner & 4) ? box.upper.z : box.lower.z};
+        result.expand(glm::vec3(matrix * glm::vec4(point, 1.0f)));
+    }
+    return result;
+}
+
+template AABB compute_bounds(const sim::PosNormTexVertex *pVertices, std::size_t numVertices);
+template AABB compute_bounds(const sim::PosVertex *pVertices, std::size_t numVertices);
+template AABB compute_bounds(const sim::PackedPosNormTexVertex *pVertices, std::size_t numVertices);
+
+} // namespace sim
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <limits>
+
+namespace sim {
+
+/// Axis aligned bounding box. Default constructed boxes are empty.
+struct AABB
+{
+    glm::vec3 lower{std::numeric_limits<float>::max()};
+    glm::vec3 upper{-std::numeric_limits<float>::max()};
+
+    void expand(const glm::vec3 &point);
+    void expand(const AABB &box);
+
+    bool isEmpty() const;
+    glm::vec3 center() const;
+    glm::vec3 extents() const; // half the size
+};
+
+struct BoundingSphere
+{
+    glm::vec3 center{0.0f};
+    float radius{0.0f};
+};
+
+/// Bounds of the 'position' member of 'numVertices' vertices. Packed positions are
+/// normalized to [0, 1] like the shader sees them.
+template <typename Vertex>
+AABB compute_bounds(const Vertex *pVertices, std::size_t numVertices);
+
+BoundingSphere bounding_sphere(const AABB &box);
+
+/// Largest factor 'matrix' scales a vector by (the longest basis vector)
+float max_scale(const glm::mat4 &matrix);
+
+/// Conservative bounds of 'sphere' after a transformation that may scale non-uniformly
+BoundingSphere transform_sphere(const BoundingSphere &sphere, const glm::mat4 &matrix);
+
+/// Corners are transformed so the result is a (possibly loose) box around the transformed box
+AABB transform_box(const AABB &box, const glm::mat4 &matrix);
+
+} // namespace sim
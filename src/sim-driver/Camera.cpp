@@ -9,6 +9,56 @@
 
 namespace sim {
 
+template <typename T>
+TCameraUpdate<T> &TCameraUpdate<T>::eye(const glm::tvec3<T> &eyeVector)
+{
+    eye_ = eyeVector;
+    fields_ |= Eye;
+    return *this;
+}
+template <typename T>
+TCameraUpdate<T> &TCameraUpdate<T>::look(const glm::tvec3<T> &lookVector)
+{
+    look_ = lookVector;
+    fields_ |= Look;
+    return *this;
+}
+template <typename T>
+TCameraUpdate<T> &TCameraUpdate<T>::up(const glm::tvec3<T> &upVector)
+{
+    up_ = upVector;
+    fields_ |= Up;
+    return *this;
+}
+template <typename T>
+TCameraUpdate<T> &TCameraUpdate<T>::fovYDegrees(T fovYDegrees)
+{
+    fovYDegrees_ = fovYDegrees;
+    fields_ |= FovY;
+    return *this;
+}
+template <typename T>
+TCameraUpdate<T> &TCameraUpdate<T>::aspectRatio(T aspectRatio)
+{
+    aspectRatio_ = aspectRatio;
+    fields_ |= Aspect;
+    return *this;
+}
+template <typename T>
+TCameraUpdate<T> &TCameraUpdate<T>::nearPlane(T nearPlane)
+{
+    nearPlane_ = nearPlane;
+    fields_ |= Near;
+    return *this;
+}
+template <typename T>
+TCameraUpdate<T> &TCameraUpdate<T>::farPlane(T farPlane)
+{
+    farPlane_ = farPlane;
+    fields_ |= Far;
+    return *this;
+}
+
 template <typename T>
 TCamera<T>::TCamera()
 {
@@ -17,6 +67,48 @@ TCamera<T>::TCamera()
     ortho(-1, 1, -1, 1);
 }
 
+template <typename T>
+TCamera<T>::TCamera(const TCamera &other)
+{
+    *this = other;
+}
+
+template <typename T>
+TCamera<T> &TCamera<T>::operator=(const TCamera &other)
+{
+    if (this == &other) {
+        return *this;
+    }
+
+    // brings the source up to date so the matrices can be copied as they are
+    other.updateMatrices();
+
+    eyeVector_ = other.eyeVector_;
+    lookVector_ = other.lookVector_;
+    upVector_ = other.upVector_;
+    rightVector_ = other.rightVector_;
+    viewFromWorldMatrix_ = other.viewFromWorldMatrix_;
+
+    fovYDegrees_ = other.fovYDegrees_;
+    fovYRadians_ = other.fovYRadians_;
+    aspectRatio_ = other.aspectRatio_;
+    nearPlane_ = other.nearPlane_;
+    farPlane_ = other.farPlane_;
+    perspectiveScreenFromViewMatrix_ = other.perspectiveScreenFromViewMatrix_;
+
+    orthoLeft_ = other.orthoLeft_;
+    orthoRight_ = other.orthoRight_;
+    orthoBottom_ = other.orthoBottom_;
+    orthoTop_ = other.orthoTop_;
+    orthographicScreenFromViewMatrix_ = other.orthographicScreenFromViewMatrix_;
+
+    perspectiveScreenFromWorldMatrix_ = other.perspectiveScreenFromWorldMatrix_;
+    orthoScreenFromWorldMatrix_ = other.orthoScreenFromWorldMatrix_;
+
+    dirty_.store(0, std::memory_order_release);
+    return *this;
+}
+
 template <typename T>
 void TCamera<T>::lookAt(const glm::tvec3<T> &eye, const glm::tvec3<T> &point, const glm::tvec3<T> &up)
 {
@@ -24,9 +116,7 @@ void TCamera<T>::lookAt(const glm::tvec3<T> &eye, const glm::tvec3<T> &point, co
     lookVector_ = glm::normalize(point - eyeVector_);
     upVector_ = up;
     rightVector_ = glm::cross(lookVector_, upVector_);
-    viewFromWorldMatrix_ = glm::lookAt(eyeVector_, point, upVector_);
-
-    perspectiveScreenFromWorldMatrix_ = perspectiveScreenFromViewMatrix_ * viewFromWorldMatrix_;
+    markDirty(ViewDirty);
 }
 
 template <typename T>
@@ -37,9 +127,7 @@ void TCamera<T>::perspective(T fovyDegrees, T aspect, T zNear, T zFar)
     aspectRatio_ = aspect;
     nearPlane_ = zNear;
     farPlane_ = zFar;
-    perspectiveScreenFromViewMatrix_ = glm::perspective(fovYRadians_, aspectRatio_, nearPlane_, farPlane_);
-
-    perspectiveScreenFromWorldMatrix_ = perspectiveScreenFromViewMatrix_ * viewFromWorldMatrix_;
+    markDirty(PerspectiveDirty);
 }
 
 template <typename T>
@@ -49,9 +137,7 @@ void TCamera<T>::ortho(T left, T right, T bottom, T top)
     orthoRight_ = right;
     orthoBottom_ = bottom;
     orthoTop_ = top;
-    orthographicScreenFromViewMatrix_ = glm::ortho(orthoLeft_, orthoRight_, orthoBottom_, orthoTop_);
-
-    perspectiveScreenFromWorldMatrix_ = perspectiveScreenFromViewMatrix_ * viewFromWorldMatrix_;
+    markDirty(OrthoDirty);
 }
 
 template <typename T>
@@ -77,6 +163,7 @@ const glm::tvec3<T> &TCamera<T>::getRightVector() const
 template <typename T>
 const glm::tmat4x4<T> &TCamera<T>::getViewFromWorldMatrix() const
 {
+    updateMatrices();
     return viewFromWorldMatrix_;
 }
 template <typename T>
@@ -107,6 +194,7 @@ T TCamera<T>::getFarPlane() const
 template <typename T>
 const glm::tmat4x4<T> &TCamera<T>::getPerspectiveScreenFromViewMatrix() const
 {
+    updateMatrices();
     return perspectiveScreenFromViewMatrix_;
 }
 template <typename T>
@@ -132,16 +220,19 @@ T TCamera<T>::getOrthoTop() const
 template <typename T>
 const glm::tmat4x4<T> &TCamera<T>::getOrthographicScreenFromViewMatrix() const
 {
+    updateMatrices();
     return orthographicScreenFromViewMatrix_;
 }
 template <typename T>
 const glm::tmat4x4<T> &TCamera<T>::getPerspectiveScreenFromWorldMatrix() const
 {
+    updateMatrices();
     return perspectiveScreenFromWorldMatrix_;
 }
 template <typename T>
 const glm::tmat4x4<T> &TCamera<T>::getOrthoScreenFromWorldMatrix() const
 {
+    updateMatrices();
     return orthoScreenFromWorldMatrix_;
 }
 
@@ -201,6 +292,65 @@ void TCamera<T>::setOrthoTop(T orthoTop)
     ortho(orthoLeft_, orthoRight_, orthoBottom_, orthoTop);
 }
 
+template <typename T>
+void TCamera<T>::set(const TCameraUpdate<T> &update)
+{
+    using Update = TCameraUpdate<T>;
+
+    if (update.fields_ & (Update::Eye | Update::Look | Update::Up)) {
+        glm::tvec3<T> eye = (update.fields_ & Update::Eye) ? update.eye_ : eyeVector_;
+        glm::tvec3<T> look = (update.fields_ & Update::Look) ? update.look_ : lookVector_;
+        glm::tvec3<T> up = (update.fields_ & Update::Up) ? update.up_ : upVector_;
+        lookAt(eye, eye + look, up);
+    }
+
+    if (update.fields_ & (Update::FovY | Update::Aspect | Update::Near | Update::Far)) {
+        perspective((update.fields_ & Update::FovY) ? update.fovYDegrees_ : fovYDegrees_,
+                    (update.fields_ & Update::Aspect) ? update.aspectRatio_ : aspectRatio_,
+                    (update.fields_ & Update::Near) ? update.nearPlane_ : nearPlane_,
+                    (update.fields_ & Update::Far) ? update.farPlane_ : farPlane_);
+    }
+}
+
+template <typename T>
+void TCamera<T>::markDirty(unsigned flags)
+{
+    dirty_.fetch_or(flags, std::memory_order_relaxed);
+}
+
+template <typename T>
+void TCamera<T>::updateMatrices() const
+{
+    // fast path once everything is up to date: no lock
+    if (dirty_.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    const unsigned dirty = dirty_.load(std::memory_order_relaxed);
+
+    if (dirty & ViewDirty) {
+        viewFromWorldMatrix_ = glm::lookAt(eyeVector_, eyeVector_ + lookVector_, upVector_);
+    }
+    if (dirty & PerspectiveDirty) {
+        perspectiveScreenFromViewMatrix_ = glm::perspective(fovYRadians_, aspectRatio_, nearPlane_, farPlane_);
+    }
+    if (dirty & OrthoDirty) {
+        orthographicScreenFromViewMatrix_ = glm::ortho(orthoLeft_, orthoRight_, orthoBottom_, orthoTop_);
+    }
+    if (dirty & (ViewDirty | PerspectiveDirty)) {
+        perspectiveScreenFromWorldMatrix_ = perspectiveScreenFromViewMatrix_ * viewFromWorldMatrix_;
+    }
+    if (dirty & (ViewDirty | OrthoDirty)) {
+        orthoScreenFromWorldMatrix_ = orthographicScreenFromViewMatrix_ * viewFromWorldMatrix_;
+    }
+
+    dirty_.store(0, std::memory_order_release);
+}
+
+template class TCameraUpdate<float>;
+template class TCameraUpdate<double>;
+
 template class TCamera<float>;
 
 template class TCamera<double>;
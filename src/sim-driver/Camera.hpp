@@ -1,15 +1,59 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <atomic>
+#include <mutex>
 
 namespace sim {
 
+/// Parameters changed together by TCamera::set. Only the fields that were set are applied:
+///
+///     camera.set(sim::CameraUpdate().eye(eye).look(look).aspectRatio(aspect));
+template <typename T>
+class TCameraUpdate
+{
+public:
+    TCameraUpdate &eye(const glm::tvec3<T> &eyeVector);
+    TCameraUpdate &look(const glm::tvec3<T> &lookVector);
+    TCameraUpdate &up(const glm::tvec3<T> &upVector);
+    TCameraUpdate &fovYDegrees(T fovYDegrees);
+    TCameraUpdate &aspectRatio(T aspectRatio);
+    TCameraUpdate &nearPlane(T nearPlane);
+    TCameraUpdate &farPlane(T farPlane);
+
+private:
+    template <typename>
+    friend class TCamera;
+
+    enum Field : unsigned
+    {
+        Eye = 1u << 0u,
+        Look = 1u << 1u,
+        Up = 1u << 2u,
+        FovY = 1u << 3u,
+        Aspect = 1u << 4u,
+        Near = 1u << 5u,
+        Far = 1u << 6u,
+    };
+
+    unsigned fields_{0};
+    glm::tvec3<T> eye_, look_, up_;
+    T fovYDegrees_, aspectRatio_, nearPlane_, farPlane_;
+};
+
+/// Setters only store parameters and mark the derived matrices dirty. The matrices are
+/// recomputed on the first read after a change, so setting several parameters per frame
+/// costs one update. Concurrent const reads are safe (the lazy update is locked) but
+/// setters still need exclusive access.
 template <typename T>
 class TCamera
 {
 public:
     TCamera();
 
+    TCamera(const TCamera &other);
+    TCamera &operator=(const TCamera &other);
+
     void lookAt(const glm::tvec3<T> &eye, const glm::tvec3<T> &point, const glm::tvec3<T> &up = glm::tvec3<T>(0, 1, 0));
 
     void perspective(T fovyDegrees, T aspect, T zNear, T zFar);
@@ -52,24 +96,43 @@ public:
     void setOrthoBottom(T orthoBottom);
     void setOrthoTop(T orthoTop);
 
+    /// Applies every field of 'update' at once
+    void set(const TCameraUpdate<T> &update);
+
 private:
+    enum Dirty : unsigned
+    {
+        ViewDirty = 1u << 0u,
+        PerspectiveDirty = 1u << 1u,
+        OrthoDirty = 1u << 2u,
+    };
+
     // view matrix variables
     glm::tvec3<T> eyeVector_, lookVector_, upVector_, rightVector_;
-    glm::tmat4x4<T> viewFromWorldMatrix_;
+    mutable glm::tmat4x4<T> viewFromWorldMatrix_;
 
     // projection matrix variables
     T fovYDegrees_, fovYRadians_, aspectRatio_, nearPlane_, farPlane_;
-    glm::tmat4x4<T> perspectiveScreenFromViewMatrix_;
+    mutable glm::tmat4x4<T> perspectiveScreenFromViewMatrix_;
 
     // orthographic matrix variables
     T orthoLeft_, orthoRight_, orthoBottom_, orthoTop_;
-    glm::tmat4x4<T> orthographicScreenFromViewMatrix_;
+    mutable glm::tmat4x4<T> orthographicScreenFromViewMatrix_;
+
+    mutable glm::tmat4x4<T> perspectiveScreenFromWorldMatrix_;
+    mutable glm::tmat4x4<T> orthoScreenFromWorldMatrix_;
+
+    // lazy evaluation
+    mutable std::atomic<unsigned> dirty_{ViewDirty | PerspectiveDirty | OrthoDirty};
+    mutable std::mutex updateMutex_;
 
-    glm::tmat4x4<T> perspectiveScreenFromWorldMatrix_;
-    glm::tmat4x4<T> orthoScreenFromWorldMatrix_;
+    void markDirty(unsigned flags);
+    void updateMatrices() const;
 };
 
 using Camera = TCamera<float>;
 using CameraD = TCamera<double>;
+using CameraUpdate = TCameraUpdate<float>;
+using CameraUpdateD = TCameraUpdate<double>;
 
 } // namespace sim
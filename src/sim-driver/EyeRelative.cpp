@@ -0,0 +1,31 @@
+#include <sim-driver/EyeRelative.hpp>
+#include <sim-driver/Camera.hpp>
+
+namespace sim {
+
+glm::mat4 eye_from_local(const glm::dvec3 &eye, const glm::dmat4 &worldFromLocal)
+{
+    // translate(-eye) * worldFromLocal without the matrix product (or its rounding)
+    glm::dmat4 eyeFromLocal = worldFromLocal;
+    for (int c = 0; c < 4; ++c) {
+        eyeFromLocal[c] -= glm::dvec4(eye * eyeFromLocal[c].w, 0.0);
+    }
+    return glm::mat4(eyeFromLocal);
+}
+
+glm::mat4 screen_from_eye(const CameraD &camera)
+{
+    glm::dmat4 viewRotation = camera.getViewFromWorldMatrix();
+    viewRotation[3] = glm::dvec4(0.0, 0.0, 0.0, 1.0);
+    return glm::mat4(camera.getPerspectiveScreenFromViewMatrix() * viewRotation);
+}
+
+EyeRelativeTransforms eye_relative_transforms(const CameraD &camera, const glm::dmat4 &worldFromLocal)
+{
+    EyeRelativeTransforms transforms;
+    transforms.screenFromEye = screen_from_eye(camera);
+    transforms.eyeFromLocal = eye_from_local(camera.getEyeVector(), worldFromLocal);
+    return transforms;
+}
+
+} // namespace sim
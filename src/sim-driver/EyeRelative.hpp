@@ -0,0 +1,27 @@
+#pragma once
+
+#include <sim-driver/OpenGLTypes.hpp>
+#include <glm/glm.hpp>
+
+namespace sim {
+
+/// Float matrices for rendering a double precision world relative to the camera eye. The
+/// eye is subtracted from the model translation in double on the CPU so the GPU only ever
+/// sees small numbers near the camera, no matter how far the scene is from the origin.
+/// "Eye space" here is world space translated to the eye (the axes stay world aligned).
+struct EyeRelativeTransforms
+{
+    glm::mat4 screenFromEye{1}; // projection * view rotation
+    glm::mat4 eyeFromLocal{1}; // world_from_local - eye
+    glm::vec3 eye{0}; // the eye in eye space, always the origin
+};
+
+/// 'worldFromLocal' translated by -'eye', computed in double and rounded once at the end
+glm::mat4 eye_from_local(const glm::dvec3 &eye, const glm::dmat4 &worldFromLocal);
+
+/// Perspective projection times the view matrix without its translation
+glm::mat4 screen_from_eye(const CameraD &camera);
+
+EyeRelativeTransforms eye_relative_transforms(const CameraD &camera, const glm::dmat4 &worldFromLocal);
+
+} // namespace sim
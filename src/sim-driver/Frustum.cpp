@@ -0,0 +1,126 @@
+#include <sim-driver/Frustum.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <algorithm>
+
+namespace sim {
+
+namespace {
+
+// small enough for the per block arrays to stay in L1
+constexpr std::size_t cull_block_size = 256;
+
+glm::vec4 normalize_plane(const glm::vec4 &plane)
+{
+    return plane / glm::length(glm::vec3(plane));
+}
+
+} // namespace
+
+Frustum extract_frustum(const glm::mat4 &screenFromWorld)
+{
+    // rows of the (column major) matrix
+    glm::vec4 rows[4];
+    for (int r = 0; r < 4; ++r) {
+        rows[r] = glm::vec4(screenFromWorld[0][r], screenFromWorld[1][r], screenFromWorld[2][r], screenFromWorld[3][r]);
+    }
+
+    Frustum frustum;
+    frustum.planes[0] = normalize_plane(rows[3] + rows[0]); // left
+    frustum.planes[1] = normalize_plane(rows[3] - rows[0]); // right
+    frustum.planes[2] = normalize_plane(rows[3] + rows[1]); // bottom
+    frustum.planes[3] = normalize_plane(rows[3] - rows[1]); // top
+    frustum.planes[4] = normalize_plane(rows[3] + rows[2]); // near
+    frustum.planes[5] = normalize_plane(rows[3] - rows[2]); // far
+    return frustum;
+}
+
+bool intersects(const Frustum &frustum, const BoundingSphere &sphere)
+{
+    for (const glm::vec4 &plane : frustum.planes) {
+        if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool intersects(const Frustum &frustum, const AABB &box)
+{
+    for (const glm::vec4 &plane : frustum.planes) {
+        // the corner furthest along the plane normal
+        const glm::vec3 corner{plane.x >= 0.0f ? box.upper.x : box.lower.x,
+                               plane.y >= 0.0f ? box.upper.y : box.lower.y,
+                               plane.z >= 0.0f ? box.upper.z : box.lower.z};
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t cull_spheres(const Frustum &frustum,
+                         const float *pCenterX,
+                         const float *pCenterY,
+                         const float *pCenterZ,
+                         const float *pRadius,
+                         std::size_t count,
+                         unsigned char *pVisible)
+{
+    std::size_t numVisible = 0;
+
+    for (std::size_t begin = 0; begin < count; begin += cull_block_size) {
+        const std::size_t end = std::min(count, begin + cull_block_size);
+
+        std::fill(pVisible + begin, pVisible + end, static_cast<unsigned char>(1));
+
+        for (const glm::vec4 &plane : frustum.planes) {
+            const float a = plane.x, b = plane.y, c = plane.z, d = plane.w;
+            for (std::size_t i = begin; i < end; ++i) {
+                const float distance = a * pCenterX[i] + b * pCenterY[i] + c * pCenterZ[i] + d;
+                pVisible[i] &= static_cast<unsigned char>(distance >= -pRadius[i]);
+            }
+        }
+
+        for (std::size_t i = begin; i < end; ++i) {
+            numVisible += pVisible[i];
+        }
+    }
+    return numVisible;
+}
+
+std::size_t cull_instances(const Frustum &frustum,
+                           const BoundingSphere &localSphere,
+                           const InstanceData *pInstances,
+                           std::size_t numInstances,
+                           std::vector<InstanceData> *pVisibleInstances)
+{
+    float x[cull_block_size], y[cull_block_size], z[cull_block_size], radius[cull_block_size];
+    unsigned char visible[cull_block_size];
+
+    const glm::vec4 localCenter{localSphere.center, 1.0f};
+    std::size_t numVisible = 0;
+
+    for (std::size_t begin = 0; begin < numInstances; begin += cull_block_size) {
+        const std::size_t size = std::min(numInstances - begin, cull_block_size);
+
+        for (std::size_t i = 0; i < size; ++i) {
+            const glm::mat4 &worldFromLocal = pInstances[begin + i].worldFromLocal;
+            const glm::vec4 center = worldFromLocal * localCenter;
+            x[i] = center.x;
+            y[i] = center.y;
+            z[i] = center.z;
+            radius[i] = localSphere.radius * sim::max_scale(worldFromLocal);
+        }
+
+        numVisible += cull_spheres(frustum, x, y, z, radius, size, visible);
+
+        for (std::size_t i = 0; i < size; ++i) {
+            if (visible[i]) {
+                pVisibleInstances->push_back(pInstances[begin + i]);
+            }
+        }
+    }
+    return numVisible;
+}
+
+} // namespace sim
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <sim-driver/Bounds.hpp>
+#include <sim-driver/OpenGLTypes.hpp>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace sim {
+
+/// World space view volume as six planes (left, right, bottom, top, near, far). Each plane
+/// is (normal, distance) with the normal pointing inside: dot(normal, p) + distance >= 0.
+struct Frustum
+{
+    std::array<glm::vec4, 6> planes;
+};
+
+/// Number of draws (or instances) that passed and failed the frustum test
+struct CullStats
+{
+    std::size_t visible{0};
+    std::size_t culled{0};
+};
+
+/// Extracts the normalized planes of 'screenFromWorld' (e.g. Camera::getPerspectiveScreenFromWorldMatrix)
+Frustum extract_frustum(const glm::mat4 &screenFromWorld);
+
+/// Conservative tests: false only if the volume is completely outside of one plane
+bool intersects(const Frustum &frustum, const BoundingSphere &sphere);
+bool intersects(const Frustum &frustum, const AABB &box);
+
+/// Batched sphere test over structure of arrays input. The planes are tested in blocks
+/// without branches so the loops vectorize. Sets pVisible[i] to 1 or 0 and returns the
+/// number of visible spheres.
+std::size_t cull_spheres(const Frustum &frustum,
+                         const float *pCenterX,
+                         const float *pCenterY,
+                         const float *pCenterZ,
+                         const float *pRadius,
+                         std::size_t count,
+                         unsigned char *pVisible);
+
+/// Tests 'localSphere' transformed by every instance's worldFromLocal matrix and appends
+/// the visible instances (in order) to 'pVisibleInstances'. Returns the number appended.
+std::size_t cull_instances(const Frustum &frustum,
+                           const BoundingSphere &localSphere,
+                           const InstanceData *pInstances,
+                           std::size_t numInstances,
+                           std::vector<InstanceData> *pVisibleInstances);
+
+} // namespace sim
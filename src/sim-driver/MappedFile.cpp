@@ -0,0 +1,156 @@
+#include <sim-driver/MappedFile.hpp>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif // _WIN32
+#include <stdexcept>
+#include <utility>
+
+namespace sim {
+
+namespace {
+
+void unmap(const char *pData, std::size_t size)
+{
+    if (pData) {
+#ifdef _WIN32
+        (void)size;
+        ::UnmapViewOfFile(pData);
+#else
+        ::munmap(const_cast<char *>(pData), size);
+#endif // _WIN32
+    }
+}
+
+} // namespace
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string &filename)
+{
+    HANDLE file = ::CreateFileA(filename.c_str(),
+                                GENERIC_READ,
+                                FILE_SHARE_READ,
+                                nullptr,
+                                OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL,
+                                nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open " + filename + ": error " + std::to_string(::GetLastError()));
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!::GetFileSizeEx(file, &fileSize)) {
+        DWORD error = ::GetLastError();
+        ::CloseHandle(file);
+        throw std::runtime_error("Failed to stat " + filename + ": error " + std::to_string(error));
+    }
+    size_ = static_cast<std::size_t>(fileSize.QuadPart);
+
+    // mapping zero bytes fails, empty files are simply empty
+    if (size_ > 0) {
+        HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void *pMapping = mapping ? ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        DWORD error = ::GetLastError();
+
+        if (mapping) {
+            ::CloseHandle(mapping);
+        }
+        if (!pMapping) {
+            ::CloseHandle(file);
+            throw std::runtime_error("Failed to map " + filename + ": error " + std::to_string(error));
+        }
+        pData_ = static_cast<const char *>(pMapping);
+    }
+
+    // the view stays valid after the file and mapping handles are closed
+    ::CloseHandle(file);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &filename)
+{
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open " + filename + ": " + std::strerror(errno));
+    }
+
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0) {
+        std::string error = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Failed to stat " + filename + ": " + error);
+    }
+    size_ = static_cast<std::size_t>(fileStat.st_size);
+
+    // mapping zero bytes fails, empty files are simply empty
+    if (size_ > 0) {
+        void *pMapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pMapping == MAP_FAILED) {
+            std::string error = std::strerror(errno);
+            ::close(fd);
+            throw std::runtime_error("Failed to map " + filename + ": " + error);
+        }
+        pData_ = static_cast<const char *>(pMapping);
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+#endif // _WIN32
+
+MappedFile::~MappedFile()
+{
+    unmap(pData_, size_);
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : pData_{std::exchange(other.pData_, nullptr)}, size_{std::exchange(other.size_, 0)}
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other) {
+        unmap(pData_, size_);
+        pData_ = std::exchange(other.pData_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+const char *MappedFile::data() const
+{
+    return pData_;
+}
+
+std::size_t MappedFile::size() const
+{
+    return size_;
+}
+
+void MappedFile::adviseSequential() const
+{
+#ifndef _WIN32
+    // mapped views have no access pattern advice on Windows
+    if (pData_) {
+        ::madvise(const_cast<char *>(pData_), size_, MADV_SEQUENTIAL);
+    }
+#endif // _WIN32
+}
+
+} // namespace sim
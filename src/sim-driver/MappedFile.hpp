@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace sim {
+
+/// Read-only memory mapping of a whole file (mmap, or MapViewOfFile on Windows). Pages are
+/// loaded by the OS on first access so opening is cheap regardless of the file size.
+class MappedFile
+{
+public:
+    /// Throws std::runtime_error if the file can't be opened or mapped
+    explicit MappedFile(const std::string &filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    const char *data() const;
+    std::size_t size() const;
+
+    /// Hint that the whole file will be read front to back (POSIX only, a no-op on Windows)
+    void adviseSequential() const;
+
+private:
+    const char *pData_{nullptr};
+    std::size_t size_{0};
+};
+
+} // namespace sim
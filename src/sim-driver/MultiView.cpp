@@ -0,0 +1,61 @@
+#include <sim-driver/MultiView.hpp>
+#include <sim-driver/Camera.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace sim {
+
+MultiViewBlock make_multi_view_block(const Camera *pCameras, std::size_t numCameras, MultiViewTarget target)
+{
+    if (numCameras > max_views) {
+        throw std::runtime_error("At most " + std::to_string(max_views) + " views can be rendered in one pass, got "
+                                 + std::to_string(numCameras));
+    }
+
+    MultiViewBlock block;
+    for (std::size_t i = 0; i < numCameras; ++i) {
+        block.screenFromWorld[i] = pCameras[i].getPerspectiveScreenFromWorldMatrix();
+    }
+    block.viewInfo.x = static_cast<int>(numCameras);
+    block.viewInfo.y = target == MultiViewTarget::Layers ? 1 : 0;
+    return block;
+}
+
+std::array<Camera, 6> cube_map_cameras(const glm::vec3 &center, float nearPlane, float farPlane)
+{
+    // OpenGL cube map face orientations
+    const glm::vec3 looks[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    const glm::vec3 ups[6] = {{0, -1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}, {0, -1, 0}, {0, -1, 0}};
+
+    std::array<Camera, 6> cameras;
+    for (std::size_t face = 0; face < cameras.size(); ++face) {
+        cameras[face].lookAt(center, center + looks[face], ups[face]);
+        cameras[face].perspective(90.0f, 1.0f, nearPlane, farPlane);
+    }
+    return cameras;
+}
+
+std::vector<glm::vec4> split_viewports(int width, int height, std::size_t numViews)
+{
+    std::vector<glm::vec4> viewports;
+    if (numViews == 0) {
+        return viewports;
+    }
+
+    const auto columns = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(numViews))));
+    const std::size_t rows = (numViews + columns - 1) / columns;
+
+    const float viewWidth = static_cast<float>(width) / columns;
+    const float viewHeight = static_cast<float>(height) / rows;
+
+    for (std::size_t i = 0; i < numViews; ++i) {
+        const std::size_t column = i % columns;
+        const std::size_t row = i / columns;
+        // viewport origins are at the bottom left
+        viewports.emplace_back(column * viewWidth, (rows - 1 - row) * viewHeight, viewWidth, viewHeight);
+    }
+    return viewports;
+}
+
+} // namespace sim
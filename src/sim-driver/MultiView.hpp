@@ -0,0 +1,41 @@
+#pragma once
+
+#include <sim-driver/OpenGLTypes.hpp>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace sim {
+
+/// Views drawn by one multi-view pass (one geometry shader invocation each)
+constexpr std::size_t max_views = 6;
+
+/// Where each view of a multi-view pass ends up
+enum class MultiViewTarget
+{
+    Layers, // gl_Layer: layers of a layered framebuffer (texture array or cube map faces)
+    Viewports, // gl_ViewportIndex: viewports set with glViewportArrayv (e.g. split_viewports)
+};
+
+/// std140 layout of the MultiViews uniform block in shader_multiview.geom
+struct MultiViewBlock
+{
+    glm::mat4 screenFromWorld[max_views];
+    glm::ivec4 viewInfo{0}; // x: number of views, y: 1 for MultiViewTarget::Layers
+};
+
+static_assert(sizeof(MultiViewBlock) == max_views * sizeof(glm::mat4) + sizeof(glm::ivec4),
+              "MultiViewBlock must match the std140 layout of the shader block");
+
+/// Throws if there are more than max_views cameras
+MultiViewBlock make_multi_view_block(const Camera *pCameras, std::size_t numCameras, MultiViewTarget target);
+
+/// Cameras for the faces of a cube map at 'center' in layer order (+x, -x, +y, -y, +z, -z)
+std::array<Camera, 6> cube_map_cameras(const glm::vec3 &center, float nearPlane, float farPlane);
+
+/// Splits the window into a grid of 'numViews' equal viewports (x, y, width, height) starting
+/// at the top left, ready for glViewportArrayv
+std::vector<glm::vec4> split_viewports(int width, int height, std::size_t numViews);
+
+} // namespace sim
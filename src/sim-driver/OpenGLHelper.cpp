@@ -1,6 +1,8 @@
 #include <sim-driver/OpenGLHelper.hpp>
 
 #include <sim-driver/ShaderConfig.hpp>
+#include <sim-driver/ShaderVariants.hpp>
+#include <cstdint>
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -14,6 +16,8 @@ namespace sim {
 
 namespace {
 
+thread_local bool occlusion_query_active = false; // of the context current on this thread
+
 const std::unordered_map<std::string, GLenum> &shaderTypes()
 {
     static std::unordered_map<std::string, GLenum> extMap{{".vert", GL_VERTEX_SHADER},
@@ -238,6 +242,141 @@ void create_separable_program(const std::string filePath, SeparablePrograms *pSp
     }
 } // create_separable_program
 
+////////////////////////////////////////////////////////////////////////////////
+
+constexpr std::uint32_t program_binary_magic = 0x42505344; // "DSPB"
+
+std::string &program_binary_directory()
+{
+    static std::string directory;
+    return directory;
+}
+
+// programs stay shared while something uses them without keeping them alive (or past the context)
+std::unordered_map<std::string, std::weak_ptr<GLuint>> &live_variants()
+{
+    static std::unordered_map<std::string, std::weak_ptr<GLuint>> variants;
+    return variants;
+}
+
+std::string gl_context_string()
+{
+    std::string context;
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const GLubyte *pString = glGetString(name);
+        context += pString ? reinterpret_cast<const char *>(pString) : "";
+        context += '\n';
+    }
+    return context;
+}
+
+std::shared_ptr<GLuint> make_program(GLuint program)
+{
+    return std::shared_ptr<GLuint>(new GLuint(program), [](auto *pId) {
+        glDeleteProgram(*pId);
+        delete pId;
+    });
+}
+
+bool is_linked(GLuint program)
+{
+    GLint result = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &result);
+    return result != GL_FALSE;
+}
+
+std::shared_ptr<GLuint> compile_separable_program(GLenum shaderType, const std::string &source, bool retrievable)
+{
+    std::shared_ptr<GLuint> spShader(new GLuint(glCreateShader(shaderType)), [](auto *pID) {
+        glDeleteShader(*pID);
+        delete pID;
+    });
+
+    const char *shaderSource = source.c_str();
+    glShaderSource(*spShader, 1, &shaderSource, nullptr);
+    glCompileShader(*spShader);
+
+    GLint result = GL_FALSE;
+    glGetShaderiv(*spShader, GL_COMPILE_STATUS, &result);
+
+    if (result == GL_FALSE) {
+        int logLength = 0;
+        glGetShaderiv(*spShader, GL_INFO_LOG_LENGTH, &logLength);
+        std::vector<char> shaderError(static_cast<size_t>(logLength));
+        glGetShaderInfoLog(*spShader, logLength, nullptr, shaderError.data());
+        throw std::runtime_error("(" + shaderTypeStrings().at(shaderType) + ") " + std::string(shaderError.data()));
+    }
+
+    // same as glCreateShaderProgramv but the binary hint has to be set before linking
+    std::shared_ptr<GLuint> spProgram = make_program(glCreateProgram());
+    glProgramParameteri(*spProgram, GL_PROGRAM_SEPARABLE, GL_TRUE);
+    if (retrievable) {
+        glProgramParameteri(*spProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    glAttachShader(*spProgram, *spShader);
+    glLinkProgram(*spProgram);
+    glDetachShader(*spProgram, *spShader);
+
+    if (!is_linked(*spProgram)) {
+        int logLength = 0;
+        glGetProgramiv(*spProgram, GL_INFO_LOG_LENGTH, &logLength);
+        std::vector<char> programError(static_cast<size_t>(logLength));
+        glGetProgramInfoLog(*spProgram, logLength, nullptr, programError.data());
+        throw std::runtime_error("(ShaderProgram) " + std::string(programError.data()));
+    }
+
+    return spProgram;
+} // compile_separable_program
+
+/// nullptr if there is no usable binary (e.g. the driver changed its format)
+std::shared_ptr<GLuint> load_program_binary(const std::string &filePath)
+{
+    std::ifstream file(filePath, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    std::uint32_t header[2] = {0, 0}; // magic, binary format
+    file.read(reinterpret_cast<char *>(header), sizeof(header));
+    std::vector<char> binary{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+    if (!file.good() && !file.eof()) {
+        return nullptr;
+    }
+    if (header[0] != program_binary_magic || binary.empty()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<GLuint> spProgram = make_program(glCreateProgram());
+    glProgramParameteri(*spProgram, GL_PROGRAM_SEPARABLE, GL_TRUE);
+    glProgramBinary(*spProgram, header[1], binary.data(), static_cast<GLsizei>(binary.size()));
+
+    return is_linked(*spProgram) ? spProgram : nullptr;
+} // load_program_binary
+
+/// Best effort: the program is usable whether or not its binary could be written
+void save_program_binary(GLuint program, const std::string &filePath)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(static_cast<std::size_t>(length));
+    GLenum format = 0;
+    glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+    std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return;
+    }
+    const std::uint32_t header[2] = {program_binary_magic, static_cast<std::uint32_t>(format)};
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+} // save_program_binary
+
 template <typename... Shaders>
 void create_separable_program(SeparablePrograms *pSp, const std::string filePath)
 {
@@ -253,23 +392,6 @@ void create_separable_program(SeparablePrograms *pSp, const std::string filePath
 
 } // namespace
 
-const std::vector<VAOElement> &posNormTexVaoElements()
-{
-    static std::vector<VAOElement> elements{
-        {"local_position", 3, GL_FLOAT, reinterpret_cast<void *>(offsetof(PosNormTexVertex, position))},
-        {"local_normal", 3, GL_FLOAT, reinterpret_cast<void *>(offsetof(PosNormTexVertex, normal))},
-        {"tex_coords", 2, GL_FLOAT, reinterpret_cast<void *>(offsetof(PosNormTexVertex, texCoords))},
-    };
-    return elements;
-}
-
-const std::vector<VAOElement> &posVaoElements()
-{
-    static std::vector<VAOElement> elements{
-        {"local_position", 3, GL_FLOAT, reinterpret_cast<void *>(offsetof(PosVertex, position))}};
-    return elements;
-}
-
 const unsigned &primitiveRestart()
 {
     static unsigned index = (std::numeric_limits<unsigned>::max)();
@@ -344,6 +466,59 @@ sim::SeparablePrograms OpenGLHelper::createSeparablePrograms(std::string firstSh
     return sp;
 }
 
+std::shared_ptr<GLuint> OpenGLHelper::createSeparableProgram(const std::string &filePath,
+                                                             const std::vector<std::string> &defines)
+{
+    const std::string key = shader_variant_key(filePath, defines);
+
+    auto &variants = live_variants();
+    auto live = variants.find(key);
+    if (live != variants.end()) {
+        if (std::shared_ptr<GLuint> spProgram = live->second.lock()) {
+            return spProgram;
+        }
+    }
+
+    size_t dot = filePath.find_last_of(".");
+    std::string ext = dot == std::string::npos ? "" : filePath.substr(dot);
+
+    if (shaderTypes().find(ext) == shaderTypes().end()) {
+        throw std::runtime_error("Unknown shader extension: " + ext);
+    }
+
+    const std::string source = inject_defines(read_file(filePath), defines);
+
+    std::string binaryPath;
+    if (!program_binary_directory().empty()) {
+        GLint numBinaryFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats);
+        if (numBinaryFormats > 0) {
+            binaryPath = program_binary_directory() + "/"
+                + program_binary_file_name(key, source, gl_context_string());
+        }
+    }
+
+    std::shared_ptr<GLuint> spProgram{nullptr};
+    if (!binaryPath.empty()) {
+        spProgram = load_program_binary(binaryPath);
+    }
+
+    if (!spProgram) {
+        spProgram = compile_separable_program(shaderTypes().at(ext), source, !binaryPath.empty());
+        if (!binaryPath.empty()) {
+            save_program_binary(*spProgram, binaryPath);
+        }
+    }
+
+    variants[key] = spProgram;
+    return spProgram;
+} // createSeparableProgram
+
+void OpenGLHelper::setProgramBinaryDirectory(const std::string &directory)
+{
+    program_binary_directory() = directory;
+}
+
 std::shared_ptr<GLuint> OpenGLHelper::createTextureArray(GLsizei width,
                                                          GLsizei height,
                                                          const float *pArray,
@@ -383,10 +558,10 @@ void OpenGLHelper::resetTextureArray(std::shared_ptr<GLuint> &spTexture,
     glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_FLOAT, pArray);
 } // resetTextureArray
 
-std::shared_ptr<GLuint> OpenGLHelper::createVao(const std::shared_ptr<GLuint> &spProgram,
-                                                const std::shared_ptr<GLuint> &spVbo,
+std::shared_ptr<GLuint> OpenGLHelper::createVao(const std::shared_ptr<GLuint> &spVbo,
                                                 const GLsizei totalStride,
-                                                const std::vector<VAOElement> &elements)
+                                                const VertexAttrib *pAttribs,
+                                                const std::size_t numAttribs)
 {
     GLuint vao;
     glGenVertexArrays(1, &vao);
@@ -395,68 +570,74 @@ std::shared_ptr<GLuint> OpenGLHelper::createVao(const std::shared_ptr<GLuint> &s
         delete pID;
     });
 
-    glBindVertexArray(vao);
+    addVertexAttributes(spVao, spVbo, totalStride, pAttribs, numAttribs);
+
+    return spVao;
+} // createVao
+
+void OpenGLHelper::addVertexAttributes(const std::shared_ptr<GLuint> &spVao,
+                                       const std::shared_ptr<GLuint> &spVbo,
+                                       const GLsizei totalStride,
+                                       const VertexAttrib *pAttribs,
+                                       const std::size_t numAttribs)
+{
+    glBindVertexArray(*spVao);
 
     //
-    // bind buffer and save program id for loop
+    // bind buffer for the attribute pointers
     //
     glBindBuffer(GL_ARRAY_BUFFER, *spVbo);
 
     //
-    // iterate through all elements
+    // iterate through all attributes (locations are fixed by the vertex format)
     //
-    for (const auto &vaoElmt : elements) {
-        int pos = glGetAttribLocation(*spProgram, vaoElmt.name.c_str());
-        if (pos < 0) {
-            std::stringstream msg;
-            msg << "attrib location " << vaoElmt.name << " not found for program " << *spProgram;
+    for (std::size_t i = 0; i < numAttribs; ++i) {
+        const VertexAttrib &attrib = pAttribs[i];
+        const void *pointer = reinterpret_cast<const void *>(attrib.offset);
 
-            throw std::runtime_error(msg.str());
-        }
-
-        GLuint position = static_cast<GLuint>(pos);
+        glEnableVertexAttribArray(attrib.location);
 
-        glEnableVertexAttribArray(position);
-        switch (vaoElmt.type) {
+        // normalized integer attributes are read as floats in the shader
+        switch (attrib.normalized ? GL_FLOAT : attrib.type) {
         case GL_BYTE:
         case GL_UNSIGNED_BYTE:
         case GL_SHORT:
         case GL_UNSIGNED_SHORT:
         case GL_INT:
         case GL_UNSIGNED_INT:
-            glVertexAttribIPointer(position,
-                                   vaoElmt.size, // Num coordinates per position
-                                   vaoElmt.type, // Type
+            glVertexAttribIPointer(attrib.location,
+                                   attrib.size, // Num coordinates per position
+                                   attrib.type, // Type
                                    totalStride, // Stride, 0 = tightly packed
-                                   vaoElmt.pointer // Array buffer offset
+                                   pointer // Array buffer offset
                                    );
             break;
         case GL_DOUBLE:
-            glVertexAttribLPointer(position,
-                                   vaoElmt.size, // Num coordinates per position
-                                   vaoElmt.type, // Type
+            glVertexAttribLPointer(attrib.location,
+                                   attrib.size, // Num coordinates per position
+                                   attrib.type, // Type
                                    totalStride, // Stride, 0 = tightly packed
-                                   vaoElmt.pointer // Array buffer offset
+                                   pointer // Array buffer offset
                                    );
             break;
         default:
-            glVertexAttribPointer(position,
-                                  vaoElmt.size, // Num coordinates per position
-                                  vaoElmt.type, // Type
-                                  GL_FALSE, // Normalized
+            glVertexAttribPointer(attrib.location,
+                                  attrib.size, // Num coordinates per position
+                                  attrib.type, // Type
+                                  attrib.normalized, // Normalized
                                   totalStride, // Stride, 0 = tightly packed
-                                  vaoElmt.pointer // Array buffer offset
+                                  pointer // Array buffer offset
                                   );
             break;
         }
+
+        glVertexAttribDivisor(attrib.location, attrib.divisor);
     }
 
     // Unbind buffers.
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
-
-    return spVao;
-} // createVao
+} // addVertexAttributes
 
 std::shared_ptr<GLuint> OpenGLHelper::createFramebuffer(GLsizei width,
                                                         GLsizei height,
@@ -523,6 +704,97 @@ std::shared_ptr<GLuint> OpenGLHelper::createFramebuffer(GLsizei width,
     return spFbo;
 } // createFramebuffer
 
+std::shared_ptr<GLuint> OpenGLHelper::createLayeredFramebuffer(const std::shared_ptr<GLuint> &spColorTex,
+                                                               const std::shared_ptr<GLuint> &spDepthTex)
+{
+    GLuint fbo;
+    glGenFramebuffers(1, &fbo);
+    std::shared_ptr<GLuint> spFbo(new GLuint(fbo), [](auto *pID) {
+        glDeleteFramebuffers(1, pID);
+        delete pID;
+    });
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    // glFramebufferTexture (not ...2D) attaches all layers at once
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, *spColorTex, 0);
+    if (spDepthTex) {
+        glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, *spDepthTex, 0);
+    }
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error("Layered framebuffer creation failed");
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    return spFbo;
+} // createLayeredFramebuffer
+
+std::shared_ptr<GLuint> OpenGLHelper::createLayeredTexture(GLenum target,
+                                                           GLsizei width,
+                                                           GLsizei height,
+                                                           GLsizei layers,
+                                                           GLint internalFormat,
+                                                           GLenum format,
+                                                           GLenum type)
+{
+    GLuint tex;
+    glGenTextures(1, &tex);
+    std::shared_ptr<GLuint> spTexture(new GLuint(tex), [](auto *pID) {
+        glDeleteTextures(1, pID);
+        delete pID;
+    });
+
+    glBindTexture(target, tex);
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    switch (target) {
+    case GL_TEXTURE_2D_ARRAY:
+        glTexImage3D(target, 0, internalFormat, width, height, layers, 0, format, type, nullptr);
+        break;
+
+    case GL_TEXTURE_CUBE_MAP:
+        glTexParameteri(target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        for (GLenum face = 0; face < 6; ++face) {
+            const GLenum faceTarget = GL_TEXTURE_CUBE_MAP_POSITIVE_X + face;
+            glTexImage2D(faceTarget, 0, internalFormat, width, height, 0, format, type, nullptr);
+        }
+        break;
+
+    default:
+        glBindTexture(target, 0);
+        throw std::runtime_error("Layered textures must be GL_TEXTURE_2D_ARRAY or GL_TEXTURE_CUBE_MAP");
+    }
+
+    glBindTexture(target, 0);
+
+    return spTexture;
+} // createLayeredTexture
+
+std::shared_ptr<GLuint> OpenGLHelper::createQuery()
+{
+    GLuint query;
+    glGenQueries(1, &query);
+    return std::shared_ptr<GLuint>(new GLuint(query), [](auto *pID) {
+        glDeleteQueries(1, pID);
+        delete pID;
+    });
+}
+
+void OpenGLHelper::setOcclusionQueryActive(bool active)
+{
+    occlusion_query_active = active;
+}
+
+bool OpenGLHelper::isOcclusionQueryActive()
+{
+    return occlusion_query_active;
+}
+
 StandardPipeline OpenGLHelper::createPosNormTexPipeline(const PosNormTexVertex *pData,
                                                         const size_t numElements,
                                                         std::vector<std::string> shaderFiles)
@@ -530,12 +802,7 @@ StandardPipeline OpenGLHelper::createPosNormTexPipeline(const PosNormTexVertex *
     if (shaderFiles.empty()) {
         shaderFiles = {sim::shader_path() + "shader.vert", sim::frag_shader_file()};
     }
-    sim::StandardPipeline sp = sim::OpenGLHelper::createStandardPipeline(shaderFiles,
-                                                                         pData,
-                                                                         numElements,
-                                                                         sizeof(PosNormTexVertex),
-                                                                         posNormTexVaoElements());
-    return sp;
+    return sim::OpenGLHelper::createStandardPipeline(shaderFiles, pData, numElements);
 }
 
 StandardPipeline
@@ -545,8 +812,7 @@ OpenGLHelper::createPosPipeline(const PosVertex *pData, const size_t numElements
         shaderFiles = {sim::shader_path() + "shader.vert", sim::frag_shader_file()};
     }
 
-    StandardPipeline sp
-        = OpenGLHelper::createStandardPipeline(shaderFiles, pData, numElements, sizeof(PosVertex), posVaoElements());
+    StandardPipeline sp = OpenGLHelper::createStandardPipeline(shaderFiles, pData, numElements);
     sp.vboSize = static_cast<int>(numElements);
     return sp;
 }
@@ -663,6 +929,40 @@ void OpenGLHelper::setIntUniform(const std::shared_ptr<GLuint> &spProgram,
 
 } // setIntUniform
 
+void OpenGLHelper::setUintUniform(const std::shared_ptr<GLuint> &spProgram,
+                                  const std::string &uniform,
+                                  const unsigned *pValue,
+                                  const int size,
+                                  const int count)
+{
+    switch (size) {
+
+    case 1:
+        glProgramUniform1uiv(*spProgram, glGetUniformLocation(*spProgram, uniform.c_str()), count, pValue);
+        break;
+
+    case 2:
+        glProgramUniform2uiv(*spProgram, glGetUniformLocation(*spProgram, uniform.c_str()), count, pValue);
+        break;
+
+    case 3:
+        glProgramUniform3uiv(*spProgram, glGetUniformLocation(*spProgram, uniform.c_str()), count, pValue);
+        break;
+
+    case 4:
+        glProgramUniform4uiv(*spProgram, glGetUniformLocation(*spProgram, uniform.c_str()), count, pValue);
+        break;
+
+    default:
+        std::stringstream msg;
+        msg << "Unsigned int or vector of size " << size << " does not exist";
+        throw std::runtime_error(msg.str());
+        break;
+
+    } // switch
+
+} // setUintUniform
+
 void OpenGLHelper::setFloatUniform(const std::shared_ptr<GLuint> &spProgram,
                                    const std::string &uniform,
                                    const float *pValue,
@@ -751,6 +1051,17 @@ void OpenGLHelper::setSsboUniform(const std::shared_ptr<GLuint> &spProgram,
     glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, *spSsbo, 0, sizeBytes);
 }
 
+void OpenGLHelper::setUboUniform(const std::shared_ptr<GLuint> &spProgram,
+                                 const std::shared_ptr<GLuint> &spUbo,
+                                 const std::string &uniform,
+                                 const GLuint binding)
+{
+    GLuint blockIdx = glGetUniformBlockIndex(*spProgram, uniform.c_str());
+    glUniformBlockBinding(*spProgram, blockIdx, binding);
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, *spUbo);
+}
+
 void OpenGLHelper::renderBuffer(const std::shared_ptr<GLuint> &spVao,
                                 const int start,
                                 const int verts,
@@ -772,6 +1083,46 @@ void OpenGLHelper::renderBuffer(const std::shared_ptr<GLuint> &spVao,
     glBindVertexArray(0);
 } // OpenGLHelper::renderBuffer
 
+void OpenGLHelper::renderBufferInstanced(const std::shared_ptr<GLuint> &spVao,
+                                         const int start,
+                                         const int verts,
+                                         const GLenum mode,
+                                         const int instances,
+                                         const std::shared_ptr<GLuint> &spIbo,
+                                         const void *pOffset,
+                                         const GLenum iboType)
+{
+    glBindVertexArray(*spVao);
+
+    if (spIbo) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *spIbo);
+        glDrawElementsInstanced(mode, verts, iboType, pOffset, instances);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    } else {
+        glDrawArraysInstanced(mode, start, verts, instances);
+    }
+
+    glBindVertexArray(0);
+} // OpenGLHelper::renderBufferInstanced
+
+void OpenGLHelper::renderBufferIndirect(const std::shared_ptr<GLuint> &spVao,
+                                        const GLenum mode,
+                                        const std::shared_ptr<GLuint> &spIbo,
+                                        const std::shared_ptr<GLuint> &spCommandBuffer,
+                                        const int drawCount,
+                                        const GLenum iboType)
+{
+    glBindVertexArray(*spVao);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *spIbo);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, *spCommandBuffer);
+
+    glMultiDrawElementsIndirect(mode, iboType, nullptr, drawCount, 0);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+} // OpenGLHelper::renderBufferIndirect
+
 template std::shared_ptr<GLuint> OpenGLHelper::createProgram(std::string);
 template std::shared_ptr<GLuint> OpenGLHelper::createProgram(std::string, std::string);
 template std::shared_ptr<GLuint> OpenGLHelper::createProgram(std::string, std::string, std::string);
@@ -2,7 +2,9 @@
 #pragma once
 
 #include <sim-driver/OpenGLTypes.hpp>
+#include <sim-driver/VertexFormat.hpp>
 
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -11,28 +13,6 @@
 
 namespace sim {
 
-struct VAOElement
-{
-    std::string name;
-    GLint size;
-    GLenum type;
-    void *pointer;
-};
-
-struct PosNormTexVertex
-{
-    float position[3];
-    float normal[3];
-    float texCoords[2];
-};
-
-struct PosVertex
-{
-    float position[3];
-};
-
-const std::vector<VAOElement> &posNormTexVaoElements();
-const std::vector<VAOElement> &posVaoElements();
 const unsigned &primitiveRestart();
 
 typedef std::vector<std::shared_ptr<GLuint>> IdVec;
@@ -51,6 +31,15 @@ public:
     template <typename... Shaders>
     static SeparablePrograms createSeparablePrograms(std::string firstShader, Shaders... shaders);
 
+    /// Separable program for a single shader file with 'defines' ("NAME" or "NAME=VALUE")
+    /// injected after its #version line. Variants are shared while in use and, once a binary
+    /// directory is set, their program binaries are cached on disk so later runs skip compiling.
+    static std::shared_ptr<GLuint> createSeparableProgram(const std::string &filePath,
+                                                          const std::vector<std::string> &defines = {});
+
+    /// Existing directory for the program binary cache, empty (the default) to disable it
+    static void setProgramBinaryDirectory(const std::string &directory);
+
     static std::shared_ptr<GLuint> createTextureArray(GLsizei width,
                                                       GLsizei height,
                                                       const float *pArray = nullptr,
@@ -77,22 +66,75 @@ public:
                              const T *pData,
                              GLenum bufferType);
 
-    static std::shared_ptr<GLuint> createVao(const std::shared_ptr<GLuint> &spProgram,
-                                             const std::shared_ptr<GLuint> &spVbo,
+    /// Writes 'numElements' to the start of 'spBuffer' in place. The storage is only
+    /// reallocated (growing geometrically) when the data doesn't fit in 'pCapacity'
+    /// elements. The buffer name never changes so vaos referencing it stay valid.
+    template <typename T>
+    static void writeBuffer(const std::shared_ptr<GLuint> &spBuffer,
+                            size_t *pCapacity,
+                            const T *pData,
+                            size_t numElements,
+                            GLenum type = GL_ARRAY_BUFFER,
+                            GLenum usage = GL_DYNAMIC_DRAW);
+
+    /// Orphans and refills 'spBuffer' every call so the driver never stalls on draws
+    /// still reading the previous contents. The storage only grows (geometrically)
+    /// and 'pCapacity' tracks its current size in elements.
+    template <typename T>
+    static void streamBuffer(const std::shared_ptr<GLuint> &spBuffer,
+                             size_t *pCapacity,
+                             const T *pData,
+                             size_t numElements,
+                             GLenum type = GL_ARRAY_BUFFER);
+
+    template <typename Vertex>
+    static std::shared_ptr<GLuint> createVao(const std::shared_ptr<GLuint> &spVbo);
+
+    static std::shared_ptr<GLuint> createVao(const std::shared_ptr<GLuint> &spVbo,
                                              GLsizei totalStride,
-                                             const std::vector<VAOElement> &elements);
+                                             const VertexAttrib *pAttribs,
+                                             std::size_t numAttribs);
+
+    /// Adds the attributes of a second buffer (e.g. per instance data) to an existing vao
+    template <typename Vertex>
+    static void addVertexAttributes(const std::shared_ptr<GLuint> &spVao, const std::shared_ptr<GLuint> &spVbo);
+
+    static void addVertexAttributes(const std::shared_ptr<GLuint> &spVao,
+                                    const std::shared_ptr<GLuint> &spVbo,
+                                    GLsizei totalStride,
+                                    const VertexAttrib *pAttribs,
+                                    std::size_t numAttribs);
 
     static std::shared_ptr<GLuint> createFramebuffer(GLsizei width,
                                                      GLsizei height,
                                                      const std::shared_ptr<GLuint> &spColorTex = nullptr,
                                                      const std::shared_ptr<GLuint> &spDepthTex = nullptr);
 
-    template <typename T>
+    /// Framebuffer with every layer of 'spColorTex' and 'spDepthTex' attached (e.g. from
+    /// createLayeredTexture) so gl_Layer selects the layer to draw to
+    static std::shared_ptr<GLuint> createLayeredFramebuffer(const std::shared_ptr<GLuint> &spColorTex,
+                                                            const std::shared_ptr<GLuint> &spDepthTex = nullptr);
+
+    /// GL_TEXTURE_2D_ARRAY with 'layers' layers or GL_TEXTURE_CUBE_MAP (whose 6 faces are its layers)
+    static std::shared_ptr<GLuint> createLayeredTexture(GLenum target,
+                                                        GLsizei width,
+                                                        GLsizei height,
+                                                        GLsizei layers,
+                                                        GLint internalFormat = GL_RGBA8,
+                                                        GLenum format = GL_RGBA,
+                                                        GLenum type = GL_UNSIGNED_BYTE);
+
+    static std::shared_ptr<GLuint> createQuery();
+
+    /// Only one occlusion query (GL_SAMPLES_PASSED or GL_ANY_SAMPLES_PASSED[_CONSERVATIVE]) can be
+    /// active at a time. Code wrapping draws in one sets this so the draws skip their own queries.
+    static void setOcclusionQueryActive(bool active);
+    static bool isOcclusionQueryActive();
+
+    template <typename Vertex>
     static StandardPipeline createStandardPipeline(const std::vector<std::string> &shaderFiles,
-                                                   const T *pData,
+                                                   const Vertex *pData,
                                                    size_t numElements,
-                                                   GLsizei totalStride,
-                                                   const std::vector<VAOElement> &elements,
                                                    GLenum type = GL_ARRAY_BUFFER,
                                                    GLenum usage = GL_STATIC_DRAW);
 
@@ -128,6 +170,12 @@ public:
                               int size = 1,
                               int count = 1);
 
+    static void setUintUniform(const std::shared_ptr<GLuint> &spProgram,
+                               const std::string &uniform,
+                               const unsigned *pValue,
+                               int size = 1,
+                               int count = 1);
+
     static void setFloatUniform(const std::shared_ptr<GLuint> &spProgram,
                                 const std::string &uniform,
                                 const float *pValue,
@@ -146,6 +194,11 @@ public:
                                int sizeBytes,
                                GLuint binding);
 
+    static void setUboUniform(const std::shared_ptr<GLuint> &spProgram,
+                              const std::shared_ptr<GLuint> &spUbo,
+                              const std::string &uniform,
+                              GLuint binding);
+
     static void renderBuffer(const std::shared_ptr<GLuint> &spVao,
                              int start,
                              int verts,
@@ -153,6 +206,23 @@ public:
                              const std::shared_ptr<GLuint> &spIbo = nullptr,
                              const void *pOffset = 0,
                              const GLenum iboType = GL_UNSIGNED_INT);
+
+    static void renderBufferInstanced(const std::shared_ptr<GLuint> &spVao,
+                                      int start,
+                                      int verts,
+                                      GLenum mode,
+                                      int instances,
+                                      const std::shared_ptr<GLuint> &spIbo = nullptr,
+                                      const void *pOffset = 0,
+                                      const GLenum iboType = GL_UNSIGNED_INT);
+
+    /// Submits 'drawCount' DrawElementsIndirectCommands stored in 'spCommandBuffer' with one call
+    static void renderBufferIndirect(const std::shared_ptr<GLuint> &spVao,
+                                     GLenum mode,
+                                     const std::shared_ptr<GLuint> &spIbo,
+                                     const std::shared_ptr<GLuint> &spCommandBuffer,
+                                     int drawCount,
+                                     const GLenum iboType = GL_UNSIGNED_INT);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -198,11 +268,60 @@ void OpenGLHelper::updateBuffer(const std::shared_ptr<GLuint> &upBuffer,
 } // OpenGLHelper::updateBuffer
 
 template <typename T>
+void OpenGLHelper::writeBuffer(const std::shared_ptr<GLuint> &spBuffer,
+                               size_t *pCapacity,
+                               const T *pData,
+                               const size_t numElements,
+                               const GLenum type,
+                               const GLenum usage)
+{
+    glBindBuffer(type, *spBuffer);
+
+    if (numElements > *pCapacity) {
+        *pCapacity = std::max(numElements, *pCapacity * 2);
+        glBufferData(type, static_cast<GLsizeiptr>(*pCapacity * sizeof(T)), nullptr, usage);
+    }
+    glBufferSubData(type, 0, static_cast<GLsizeiptr>(numElements * sizeof(T)), pData);
+
+    glBindBuffer(type, 0);
+} // OpenGLHelper::writeBuffer
+
+template <typename T>
+void OpenGLHelper::streamBuffer(const std::shared_ptr<GLuint> &spBuffer,
+                                size_t *pCapacity,
+                                const T *pData,
+                                const size_t numElements,
+                                const GLenum type)
+{
+    if (numElements > *pCapacity) {
+        *pCapacity = std::max(numElements, *pCapacity * 2);
+    }
+
+    glBindBuffer(type, *spBuffer);
+    glBufferData(type, static_cast<GLsizeiptr>(*pCapacity * sizeof(T)), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(type, 0, static_cast<GLsizeiptr>(numElements * sizeof(T)), pData);
+
+    glBindBuffer(type, 0);
+} // OpenGLHelper::streamBuffer
+
+template <typename Vertex>
+std::shared_ptr<GLuint> OpenGLHelper::createVao(const std::shared_ptr<GLuint> &spVbo)
+{
+    constexpr auto attributes = VertexFormat<Vertex>::attributes();
+    return OpenGLHelper::createVao(spVbo, sizeof(Vertex), attributes.data(), attributes.size());
+} // OpenGLHelper::createVao
+
+template <typename Vertex>
+void OpenGLHelper::addVertexAttributes(const std::shared_ptr<GLuint> &spVao, const std::shared_ptr<GLuint> &spVbo)
+{
+    constexpr auto attributes = VertexFormat<Vertex>::attributes();
+    OpenGLHelper::addVertexAttributes(spVao, spVbo, sizeof(Vertex), attributes.data(), attributes.size());
+} // OpenGLHelper::addVertexAttributes
+
+template <typename Vertex>
 StandardPipeline OpenGLHelper::createStandardPipeline(const std::vector<std::string> &shaderFiles,
-                                                      const T *pData,
+                                                      const Vertex *pData,
                                                       const size_t numElements,
-                                                      const GLsizei totalStride,
-                                                      const std::vector<VAOElement> &elements,
                                                       const GLenum type,
                                                       const GLenum usage)
 {
@@ -211,7 +330,7 @@ StandardPipeline OpenGLHelper::createStandardPipeline(const std::vector<std::str
 
     glIds.vbo = OpenGLHelper::createBuffer(pData, numElements, type, usage);
 
-    glIds.vao = OpenGLHelper::createVao(glIds.program, glIds.vbo, totalStride, elements);
+    glIds.vao = OpenGLHelper::createVao<Vertex>(glIds.vbo);
     glIds.vboSize = static_cast<int>(numElements);
     return glIds;
 } // OpenGLHelper::createStandardPipeline
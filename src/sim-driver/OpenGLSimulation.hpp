@@ -82,6 +82,10 @@ OpenGLSimulation<Child>::OpenGLSimulation(const SimInitData &initData, Args... a
     sim::OpenGLHelper::setDefaults();
     child_ = make_child<Child>(sim::priority_tag<2>{}, this->getWidth(), this->getHeight(), &this->simData, args...);
 
+    // start both snapshots from the camera as configured by the child
+    this->simData.interpolator.setCamera(this->simData.cameraState, this->simData.camera());
+    this->simData.interpolator.beginUpdate();
+
     callbacks_ = std::make_unique<SimCallbacks<Child>>(&this->simData, child_.get());
     this->setCallbackClass(callbacks_.get());
 }
@@ -89,7 +93,9 @@ OpenGLSimulation<Child>::OpenGLSimulation(const SimInitData &initData, Args... a
 template <typename Child>
 void OpenGLSimulation<Child>::update(const double worldTime, const double timeStep)
 {
+    this->simData.interpolator.beginUpdate();
     updateChild(*child_, worldTime, timeStep, 0);
+    this->simData.interpolator.setCamera(this->simData.cameraState, this->simData.camera());
 }
 
 template <typename Child>
@@ -108,6 +114,14 @@ void OpenGLSimulation<Child>::render(const int width, const int height, const do
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    if (paused()) {
+        // no updates are running so show the camera as it is moved
+        this->simData.interpolator.setCamera(this->simData.cameraState, this->simData.camera());
+        this->simData.interpolator.interpolate(1.0f);
+    } else {
+        this->simData.interpolator.interpolate(static_cast<float>(alpha));
+    }
+
     renderChild(*child_, width, height, alpha, 0);
     ImGui::Render();
 }
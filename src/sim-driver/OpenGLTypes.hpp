@@ -1,11 +1,12 @@
 #pragma once
 
+#include <sim-driver/Bounds.hpp>
 #include <glad/glad.h>
 #include <memory>
 
 namespace sim {
 
-struct VAOElement;
+struct VertexAttrib;
 struct VAOSettings;
 
 class OpenGLHelper;
@@ -22,14 +23,28 @@ class RendererHelper;
 template <typename T>
 struct DrawData;
 
+template <typename T>
+struct DrawDataView;
+
+template <typename Vertex>
+struct VertexFormat;
+
 struct PosNormTexVertex;
 struct PosVertex;
+struct PackedPosNormTexVertex;
+struct InstanceData;
 
 using PosNormTexRenderer = sim::RendererHelper<sim::PosNormTexVertex>;
 using PosRenderer = sim::RendererHelper<sim::PosVertex>;
+using PackedPosNormTexRenderer = sim::RendererHelper<sim::PackedPosNormTexVertex>;
 
 using PosNormTexData = sim::DrawData<sim::PosNormTexVertex>;
 using PosData = sim::DrawData<sim::PosVertex>;
+using PackedPosNormTexData = sim::DrawData<sim::PackedPosNormTexVertex>;
+
+using PosNormTexDataView = sim::DrawDataView<sim::PosNormTexVertex>;
+using PosDataView = sim::DrawDataView<sim::PosVertex>;
+using PackedPosNormTexDataView = sim::DrawDataView<sim::PackedPosNormTexVertex>;
 
 struct StandardPipeline
 {
@@ -43,6 +58,18 @@ struct StandardPipeline
     int iboSize;
 };
 
+/// GPU copy of a mesh that can be shared between renderers (see MeshCache)
+struct MeshBuffers
+{
+    std::shared_ptr<GLuint> vbo;
+    std::shared_ptr<GLuint> ibo;
+    std::shared_ptr<GLuint> vao;
+    int vboSize{0};
+    int iboSize{0};
+    GLenum iboType{GL_UNSIGNED_INT};
+    AABB bounds{}; // of the vertex positions, empty if unknown
+};
+
 struct SeparablePrograms
 {
     std::shared_ptr<GLuint> pipeline;
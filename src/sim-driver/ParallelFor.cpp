@@ -0,0 +1,109 @@
+#include <sim-driver/ParallelFor.hpp>
+#include <atomic>
+
+namespace sim {
+
+struct ParallelForPool::Job
+{
+    Job(std::size_t chunks, const std::function<void(std::size_t)> &fn) : numChunks{chunks}, task{fn} {}
+
+    /// Runs chunks until none are left to take
+    void work()
+    {
+        for (std::size_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++) {
+            task(chunk);
+
+            if (++doneChunks == numChunks) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+
+    const std::size_t numChunks;
+    const std::function<void(std::size_t)> &task; // owned by the thread waiting in run
+    std::atomic<std::size_t> nextChunk{0};
+    std::atomic<std::size_t> doneChunks{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+ParallelForPool &ParallelForPool::instance()
+{
+    static ParallelForPool pool;
+    return pool;
+}
+
+ParallelForPool::ParallelForPool()
+{
+    const unsigned numThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 1; i < numThreads; ++i) {
+        workers_.emplace_back(&ParallelForPool::workerLoop, this);
+    }
+}
+
+ParallelForPool::~ParallelForPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    jobAdded_.notify_all();
+
+    for (std::thread &worker : workers_) {
+        worker.join();
+    }
+}
+
+void ParallelForPool::run(std::size_t numChunks, const std::function<void(std::size_t)> &task)
+{
+    auto spJob = std::make_shared<Job>(numChunks, task);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(spJob);
+    }
+    jobAdded_.notify_all();
+
+    spJob->work();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find(jobs_.begin(), jobs_.end(), spJob);
+        if (it != jobs_.end()) {
+            jobs_.erase(it);
+        }
+    }
+
+    // chunks taken by workers may still be running
+    std::unique_lock<std::mutex> lock(spJob->mutex);
+    spJob->finished.wait(lock, [&spJob] { return spJob->doneChunks == spJob->numChunks; });
+}
+
+std::size_t ParallelForPool::getNumWorkers() const
+{
+    return workers_.size();
+}
+
+void ParallelForPool::workerLoop()
+{
+    for (;;) {
+        std::shared_ptr<Job> spJob;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobAdded_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (stopping_) {
+                return;
+            }
+
+            spJob = jobs_.front();
+            if (spJob->nextChunk >= spJob->numChunks) {
+                jobs_.pop_front(); // every chunk is taken, the job only waits for them to finish
+                continue;
+            }
+        }
+
+        spJob->work();
+    }
+}
+
+} // namespace sim
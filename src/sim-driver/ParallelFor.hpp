@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sim {
+
+/// Worker threads shared by every parallel_for so calls don't pay for creating threads.
+/// Started on first use with one worker less than the hardware threads.
+class ParallelForPool
+{
+public:
+    static ParallelForPool &instance();
+
+    ~ParallelForPool();
+
+    ParallelForPool(const ParallelForPool &) = delete;
+    ParallelForPool &operator=(const ParallelForPool &) = delete;
+
+    /// Calls 'task(chunk)' for every chunk in [0, numChunks) on the workers and the calling
+    /// thread and returns once all of them are done. 'task' must not throw. The caller takes
+    /// chunks itself rather than waiting for idle workers so nested calls can't deadlock.
+    void run(std::size_t numChunks, const std::function<void(std::size_t)> &task);
+
+    std::size_t getNumWorkers() const;
+
+private:
+    struct Job;
+
+    ParallelForPool();
+
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable jobAdded_;
+    std::deque<std::shared_ptr<Job>> jobs_; // with chunks left to take
+    bool stopping_{false};
+};
+
+/// Splits [begin, end) into contiguous chunks of at least 'minChunkSize' elements and
+/// calls 'fn(chunkBegin, chunkEnd)' for each chunk on the ParallelForPool, or directly
+/// when there is only one chunk. Returns once every chunk is done and rethrows the
+/// first exception thrown by 'fn'.
+template <typename Fn>
+void parallel_for(std::size_t begin, std::size_t end, std::size_t minChunkSize, const Fn &fn)
+{
+    if (end <= begin) {
+        return;
+    }
+
+    ParallelForPool &pool = ParallelForPool::instance();
+
+    const std::size_t count = end - begin;
+    const std::size_t maxChunks = pool.getNumWorkers() + 1;
+    const std::size_t maxUsefulChunks = std::max<std::size_t>(1, count / std::max<std::size_t>(1, minChunkSize));
+    const std::size_t numChunks = std::min(maxChunks, maxUsefulChunks);
+
+    if (numChunks == 1) {
+        fn(begin, end);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(numChunks);
+
+    pool.run(numChunks, [&](std::size_t chunk) {
+        try {
+            fn(begin + count * chunk / numChunks, begin + count * (chunk + 1) / numChunks);
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    });
+
+    for (const auto &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+} // namespace sim
@@ -0,0 +1,66 @@
+#include <sim-driver/ShaderVariants.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace sim {
+
+std::string inject_defines(const std::string &source, const std::vector<std::string> &defines)
+{
+    std::string defineLines;
+    for (const std::string &define : defines) {
+        if (define.empty()) {
+            throw std::runtime_error("Empty shader define");
+        }
+        std::string line = define;
+        std::replace(line.begin(), line.end(), '=', ' ');
+        defineLines += "#define " + line + "\n";
+    }
+
+    if (defineLines.empty()) {
+        return source;
+    }
+
+    // #version has to stay the first statement
+    std::size_t insert = 0;
+    const std::size_t version = source.find("#version");
+    if (version != std::string::npos) {
+        const std::size_t lineEnd = source.find('\n', version);
+        insert = lineEnd == std::string::npos ? source.size() : lineEnd + 1;
+    }
+
+    std::string result = source;
+    if (insert == result.size() && !result.empty() && result.back() != '\n') {
+        result += '\n';
+        ++insert;
+    }
+    return result.insert(insert, defineLines);
+}
+
+std::string shader_variant_key(const std::string &filePath, const std::vector<std::string> &defines)
+{
+    std::vector<std::string> sorted = defines;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::string key = filePath;
+    for (const std::string &define : sorted) {
+        key += ";" + define;
+    }
+    return key;
+}
+
+std::string program_binary_file_name(const std::string &variantKey,
+                                     const std::string &source,
+                                     const std::string &context)
+{
+    const std::size_t hash = std::hash<std::string>{}(context + '\n' + variantKey + '\n' + source);
+
+    std::stringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << static_cast<std::uint64_t>(hash) << ".glbin";
+    return name.str();
+}
+
+} // namespace sim
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace sim {
+
+/// Adds a '#define' line per entry of 'defines' ("NAME" or "NAME=VALUE") right after the
+/// #version line of 'source' (or at the top if there is none) so a single shader file can be
+/// compiled into specialized variants
+std::string inject_defines(const std::string &source, const std::vector<std::string> &defines);
+
+/// Identifies a compiled variant. The order of 'defines' doesn't matter.
+std::string shader_variant_key(const std::string &filePath, const std::vector<std::string> &defines);
+
+/// Name of the program binary cache file for a variant. 'context' (e.g. the GL renderer and
+/// version) and 'source' are hashed in so driver updates and shader edits miss the cache.
+std::string program_binary_file_name(const std::string &variantKey,
+                                     const std::string &source,
+                                     const std::string &context);
+
+} // namespace sim
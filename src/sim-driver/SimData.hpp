@@ -1,6 +1,7 @@
 #pragma once
 
 #include <sim-driver/CameraMover.hpp>
+#include <sim-driver/StateInterpolator.hpp>
 #include <string>
 
 namespace sim {
@@ -10,7 +11,15 @@ struct SimData
     CameraMover cameraMover{Camera{}};
     bool paused{false};
 
+    /// Snapshotted after every update and interpolated before every render by the driver.
+    /// Children can register their own state (e.g. model matrices) and set it in 'onUpdate'.
+    StateInterpolator interpolator{};
+    StateInterpolator::CameraHandle cameraState{interpolator.addCamera(cameraMover.camera)};
+
     Camera &camera() { return cameraMover.camera; }
+
+    /// 'camera()' interpolated for the alpha passed to the current 'onRender'
+    const Camera &renderCamera() const { return interpolator.getCamera(cameraState); }
 };
 
 struct SimInitData
@@ -0,0 +1,128 @@
+#include <sim-driver/StateInterpolator.hpp>
+#include <algorithm>
+
+namespace sim {
+
+namespace {
+
+// eye, look and up vectors followed by the perspective parameters
+constexpr std::size_t camera_floats = 13;
+
+void write_camera(const sim::Camera &camera, float *pOut)
+{
+    const glm::vec3 *vectors[] = {&camera.getEyeVector(), &camera.getLookVector(), &camera.getUpVector()};
+    for (const glm::vec3 *pVector : vectors) {
+        *pOut++ = pVector->x;
+        *pOut++ = pVector->y;
+        *pOut++ = pVector->z;
+    }
+    *pOut++ = camera.getFovYDegrees();
+    *pOut++ = camera.getAspectRatio();
+    *pOut++ = camera.getNearPlane();
+    *pOut = camera.getFarPlane();
+}
+
+} // namespace
+
+StateInterpolator::BlockHandle StateInterpolator::addBlock(const float *pInitial, std::size_t size)
+{
+    BlockHandle handle{allocate(size), size};
+    setBlock(handle, pInitial);
+    std::copy(pInitial, pInitial + size, previous_.begin() + static_cast<std::ptrdiff_t>(handle.offset));
+    std::copy(pInitial, pInitial + size, interpolated_.begin() + static_cast<std::ptrdiff_t>(handle.offset));
+    return handle;
+}
+
+StateInterpolator::MatrixHandle StateInterpolator::addMatrix(const glm::mat4 &initial)
+{
+    return {addBlock(&initial[0][0], 16).offset};
+}
+
+StateInterpolator::CameraHandle StateInterpolator::addCamera(const sim::Camera &initial)
+{
+    float values[camera_floats];
+    write_camera(initial, values);
+
+    CameraHandle handle{addBlock(values, camera_floats).offset, cameras_.size()};
+    cameras_.push_back(initial);
+    cameraOffsets_.push_back(handle.offset);
+    return handle;
+}
+
+void StateInterpolator::beginUpdate()
+{
+    previous_ = current_;
+}
+
+void StateInterpolator::setBlock(BlockHandle handle, const float *pValues)
+{
+    std::copy(pValues, pValues + handle.size, current_.begin() + static_cast<std::ptrdiff_t>(handle.offset));
+}
+
+void StateInterpolator::setMatrix(MatrixHandle handle, const glm::mat4 &matrix)
+{
+    setBlock({handle.offset, 16}, &matrix[0][0]);
+}
+
+void StateInterpolator::setCamera(CameraHandle handle, const sim::Camera &camera)
+{
+    write_camera(camera, current_.data() + handle.offset);
+}
+
+void StateInterpolator::interpolate(float alpha)
+{
+    const float *pPrevious = previous_.data();
+    const float *pCurrent = current_.data();
+    float *pOut = interpolated_.data();
+
+    // one flat loop over every registered value (auto-vectorized)
+    const std::size_t size = interpolated_.size();
+    for (std::size_t i = 0; i < size; ++i) {
+        pOut[i] = pPrevious[i] + (pCurrent[i] - pPrevious[i]) * alpha;
+    }
+
+    for (std::size_t i = 0; i < cameras_.size(); ++i) {
+        const float *pValues = pOut + cameraOffsets_[i];
+        cameras_[i].set(sim::CameraUpdate()
+                            .eye({pValues[0], pValues[1], pValues[2]})
+                            .look({pValues[3], pValues[4], pValues[5]})
+                            .up({pValues[6], pValues[7], pValues[8]})
+                            .fovYDegrees(pValues[9])
+                            .aspectRatio(pValues[10])
+                            .nearPlane(pValues[11])
+                            .farPlane(pValues[12]));
+    }
+}
+
+const float *StateInterpolator::getBlock(BlockHandle handle) const
+{
+    return interpolated_.data() + handle.offset;
+}
+
+glm::mat4 StateInterpolator::getMatrix(MatrixHandle handle) const
+{
+    glm::mat4 matrix;
+    std::copy_n(interpolated_.data() + handle.offset, 16, &matrix[0][0]);
+    return matrix;
+}
+
+const sim::Camera &StateInterpolator::getCamera(CameraHandle handle) const
+{
+    return cameras_[handle.index];
+}
+
+std::size_t StateInterpolator::getNumFloats() const
+{
+    return current_.size();
+}
+
+std::size_t StateInterpolator::allocate(std::size_t size)
+{
+    const std::size_t offset = current_.size();
+    previous_.resize(offset + size);
+    current_.resize(offset + size);
+    interpolated_.resize(offset + size);
+    return offset;
+}
+
+} // namespace sim
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <sim-driver/Camera.hpp>
+#include <glm/glm.hpp>
+#include <deque>
+#include <vector>
+
+namespace sim {
+
+/// Keeps the previous and current fixed-step values of registered state (cameras, model
+/// matrices or raw float blocks) in contiguous float buffers so the values for a render
+/// 'alpha' between two updates come out of a single lerp over the whole buffer.
+///
+///     auto model = interpolator.addMatrix(model_);          // once
+///     interpolator.setMatrix(model, model_);                // every update
+///     renderer.setModelMatrix(interpolator.getMatrix(model)); // every render
+///
+/// Matrices are interpolated per component which is fine for the small per step changes
+/// of a fixed time step but does not preserve rigidity for large rotations.
+class StateInterpolator
+{
+public:
+    struct BlockHandle
+    {
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    struct MatrixHandle
+    {
+        std::size_t offset;
+    };
+
+    struct CameraHandle
+    {
+        std::size_t offset;
+        std::size_t index;
+    };
+
+    /// Registers 'size' floats with previous = current = 'pInitial'
+    BlockHandle addBlock(const float *pInitial, std::size_t size);
+    MatrixHandle addMatrix(const glm::mat4 &initial);
+    CameraHandle addCamera(const sim::Camera &initial);
+
+    /// Starts a new fixed step: the current values become the previous values. Values
+    /// that are not set again during the step stay where they are.
+    void beginUpdate();
+
+    void setBlock(BlockHandle handle, const float *pValues);
+    void setMatrix(MatrixHandle handle, const glm::mat4 &matrix);
+    void setCamera(CameraHandle handle, const sim::Camera &camera);
+
+    /// Computes every registered value at 'alpha' in [0, 1] between the previous and
+    /// current step and refreshes the interpolated cameras.
+    void interpolate(float alpha);
+
+    /// Interpolated values as of the last call to 'interpolate'
+    const float *getBlock(BlockHandle handle) const;
+    glm::mat4 getMatrix(MatrixHandle handle) const;
+    const sim::Camera &getCamera(CameraHandle handle) const;
+
+    std::size_t getNumFloats() const;
+
+private:
+    std::vector<float> previous_;
+    std::vector<float> current_;
+    std::vector<float> interpolated_;
+
+    // deque so references returned by getCamera survive later registrations
+    std::deque<sim::Camera> cameras_;
+    std::vector<std::size_t> cameraOffsets_;
+
+    std::size_t allocate(std::size_t size);
+};
+
+} // namespace sim
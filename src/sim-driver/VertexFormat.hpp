@@ -0,0 +1,181 @@
+#pragma once
+
+#include <sim-driver/OpenGLTypes.hpp>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+
+namespace sim {
+
+struct VertexAttrib
+{
+    GLuint location;
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    std::size_t offset;
+    GLuint divisor; // 0 = per vertex, N = advance once every N instances
+};
+
+template <typename T>
+struct GLComponentType;
+
+template <>
+struct GLComponentType<float>
+{
+    static constexpr GLenum value = GL_FLOAT;
+};
+template <>
+struct GLComponentType<double>
+{
+    static constexpr GLenum value = GL_DOUBLE;
+};
+template <>
+struct GLComponentType<int>
+{
+    static constexpr GLenum value = GL_INT;
+};
+template <>
+struct GLComponentType<unsigned>
+{
+    static constexpr GLenum value = GL_UNSIGNED_INT;
+};
+template <>
+struct GLComponentType<short>
+{
+    static constexpr GLenum value = GL_SHORT;
+};
+template <>
+struct GLComponentType<unsigned short>
+{
+    static constexpr GLenum value = GL_UNSIGNED_SHORT;
+};
+template <>
+struct GLComponentType<signed char>
+{
+    static constexpr GLenum value = GL_BYTE;
+};
+template <>
+struct GLComponentType<unsigned char>
+{
+    static constexpr GLenum value = GL_UNSIGNED_BYTE;
+};
+
+/// Component count and GL type of a vertex struct member, e.g. float[3] -> {3, GL_FLOAT}
+template <typename Member>
+struct AttribTraits;
+
+template <typename T, std::size_t N>
+struct AttribTraits<T[N]>
+{
+    static_assert(N >= 1 && N <= 4, "Vertex attributes must have between 1 and 4 components");
+    static constexpr GLint size = static_cast<GLint>(N);
+    static constexpr GLenum type = GLComponentType<T>::value;
+};
+
+template <typename Member>
+constexpr VertexAttrib
+make_vertex_attrib(GLuint location, std::size_t offset, GLboolean normalized = GL_FALSE, GLuint divisor = 0)
+{
+    return {location, AttribTraits<Member>::size, AttribTraits<Member>::type, normalized, offset, divisor};
+}
+
+/// Specialize for each vertex type with a static constexpr 'attributes()' function returning
+/// a std::array of VertexAttrib. Attribute locations must match the 'layout(location = N)'
+/// qualifiers of the vertex shader.
+template <typename Vertex>
+struct VertexFormat;
+
+struct PosNormTexVertex
+{
+    float position[3];
+    float normal[3];
+    float texCoords[2];
+};
+
+struct PosVertex
+{
+    float position[3];
+};
+
+/// 16 byte alternative to PosNormTexVertex (see meshes/VertexCompression.hpp):
+/// positions are UNORM16 quantized over the mesh bounds, normals are packed
+/// GL_INT_2_10_10_10_REV snorm values and texture coordinates are UNORM16.
+struct PackedPosNormTexVertex
+{
+    unsigned short position[3];
+    unsigned short padding;
+    unsigned normal;
+    unsigned short texCoords[2];
+};
+
+/// The [0, 1] value a normalized UNORM16 attribute has in the shader
+inline float unpack_unorm16(unsigned short value)
+{
+    return static_cast<float>(value) / 65535.0f;
+}
+
+/// Per instance data for RendererHelper::onRenderInstanced
+struct InstanceData
+{
+    glm::mat4 worldFromLocal;
+    glm::vec4 color;
+};
+
+template <>
+struct VertexFormat<PosNormTexVertex>
+{
+    static constexpr std::array<VertexAttrib, 3> attributes()
+    {
+        return {{
+            make_vertex_attrib<decltype(PosNormTexVertex::position)>(0, offsetof(PosNormTexVertex, position)),
+            make_vertex_attrib<decltype(PosNormTexVertex::normal)>(1, offsetof(PosNormTexVertex, normal)),
+            make_vertex_attrib<decltype(PosNormTexVertex::texCoords)>(2, offsetof(PosNormTexVertex, texCoords)),
+        }};
+    }
+};
+
+template <>
+struct VertexFormat<PosVertex>
+{
+    static constexpr std::array<VertexAttrib, 1> attributes()
+    {
+        return {{make_vertex_attrib<decltype(PosVertex::position)>(0, offsetof(PosVertex, position))}};
+    }
+};
+
+template <>
+struct VertexFormat<PackedPosNormTexVertex>
+{
+    static constexpr std::array<VertexAttrib, 3> attributes()
+    {
+        return {{
+            make_vertex_attrib<decltype(PackedPosNormTexVertex::position)>(0,
+                                                                           offsetof(PackedPosNormTexVertex, position),
+                                                                           GL_TRUE),
+            {1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, offsetof(PackedPosNormTexVertex, normal), 0},
+            make_vertex_attrib<decltype(PackedPosNormTexVertex::texCoords)>(2,
+                                                                            offsetof(PackedPosNormTexVertex, texCoords),
+                                                                            GL_TRUE),
+        }};
+    }
+};
+
+/// Instance attributes start after the per vertex attributes (see shader_instanced.vert).
+/// The matrix occupies one location per column.
+template <>
+struct VertexFormat<InstanceData>
+{
+    static constexpr std::array<VertexAttrib, 5> attributes()
+    {
+        return {{
+            {3, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, worldFromLocal) + sizeof(glm::vec4) * 0, 1},
+            {4, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, worldFromLocal) + sizeof(glm::vec4) * 1, 1},
+            {5, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, worldFromLocal) + sizeof(glm::vec4) * 2, 1},
+            {6, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, worldFromLocal) + sizeof(glm::vec4) * 3, 1},
+            {7, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, color), 1},
+        }};
+    }
+};
+
+} // namespace sim
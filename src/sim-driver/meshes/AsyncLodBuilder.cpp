@@ -0,0 +1,105 @@
+#include <sim-driver/meshes/AsyncLodBuilder.hpp>
+#include <iostream>
+
+namespace sim {
+
+AsyncLodBuilder::AsyncLodBuilder() : worker_{&AsyncLodBuilder::run, this}
+{
+}
+
+AsyncLodBuilder::~AsyncLodBuilder()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_one();
+    worker_.join();
+}
+
+void AsyncLodBuilder::submit(BuildFun buildFun)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        request_ = std::move(buildFun);
+        ++latestRequest_;
+
+        // an older result that hasn't been polled yet is already out of date
+        hasResult_ = false;
+        result_.clear();
+    }
+    condition_.notify_one();
+}
+
+void AsyncLodBuilder::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    request_ = nullptr;
+    ++latestRequest_;
+
+    hasResult_ = false;
+    result_.clear();
+}
+
+bool AsyncLodBuilder::poll(std::vector<LodLevelData> *pLevels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!hasResult_) {
+        return false;
+    }
+
+    *pLevels = std::move(result_);
+    result_.clear();
+    hasResult_ = false;
+    return true;
+}
+
+bool AsyncLodBuilder::isBusy() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return request_ || building_;
+}
+
+void AsyncLodBuilder::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        condition_.wait(lock, [this] { return stop_ || request_; });
+
+        if (stop_) {
+            return;
+        }
+
+        BuildFun buildFun = std::move(request_);
+        const std::uint64_t requestId = latestRequest_;
+        request_ = nullptr;
+        building_ = true;
+
+        lock.unlock();
+
+        std::vector<LodLevelData> levels;
+        bool succeeded = false;
+        try {
+            levels = buildFun();
+            succeeded = true;
+        } catch (const std::exception &e) {
+            std::cerr << "LOD generation failed: " << e.what() << std::endl;
+        }
+
+        // the captured data is released without holding the lock
+        buildFun = nullptr;
+
+        lock.lock();
+        building_ = false;
+
+        // drop the result if a newer request came in while building
+        if (succeeded && requestId == latestRequest_) {
+            result_ = std::move(levels);
+            hasResult_ = true;
+        }
+    }
+}
+
+} // namespace sim
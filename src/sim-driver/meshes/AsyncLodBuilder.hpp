@@ -0,0 +1,68 @@
+#pragma once
+
+#include <sim-driver/meshes/MeshCache.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sim {
+
+/// CPU side data of one level of detail
+struct LodLevelData
+{
+    MeshKey key; // cache key of generated resolutions (all zero for simplified levels)
+    std::shared_ptr<const sim::PosNormTexData> spData;
+    GLenum drawMode;
+    float error; // model units
+};
+
+/// Builds level of detail chains on a worker thread so generating or simplifying them never
+/// stalls the render thread. Like AsyncMeshGenerator only the most recent request matters:
+/// requests that haven't started yet are replaced and superseded results are dropped.
+class AsyncLodBuilder
+{
+public:
+    using BuildFun = std::function<std::vector<LodLevelData>()>;
+
+    AsyncLodBuilder();
+    ~AsyncLodBuilder();
+
+    AsyncLodBuilder(const AsyncLodBuilder &) = delete;
+    AsyncLodBuilder &operator=(const AsyncLodBuilder &) = delete;
+
+    /// Queues 'buildFun'. It runs on the worker thread so it may only capture copies or
+    /// data that nothing modifies while it runs.
+    void submit(BuildFun buildFun);
+
+    /// Supersedes every pending request (see AsyncMeshGenerator::cancel)
+    void cancel();
+
+    /// Returns true and the finished levels if the latest request completed since the last poll
+    bool poll(std::vector<LodLevelData> *pLevels);
+
+    /// True while a request is queued or being built
+    bool isBusy() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stop_{false};
+
+    BuildFun request_{nullptr};
+    bool building_{false};
+    std::uint64_t latestRequest_{0};
+
+    bool hasResult_{false};
+    std::vector<LodLevelData> result_;
+
+    std::thread worker_; // started last so everything above is initialized
+
+    void run();
+};
+
+} // namespace sim
@@ -0,0 +1,126 @@
+#include <sim-driver/meshes/AsyncMeshGenerator.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <iostream>
+
+namespace sim {
+
+template <typename V>
+AsyncMeshGenerator<V>::AsyncMeshGenerator(MeshDataFun dataFun, MeshProcessFun processFun)
+    : dataFun_{std::move(dataFun)}, processFun_{std::move(processFun)}, worker_{&AsyncMeshGenerator<V>::run, this}
+{
+}
+
+template <typename V>
+AsyncMeshGenerator<V>::~AsyncMeshGenerator()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_one();
+    worker_.join();
+}
+
+template <typename V>
+void AsyncMeshGenerator<V>::submit(const MeshKey &key)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        request_ = key;
+        hasRequest_ = true;
+        ++latestRequest_;
+
+        // an older result that hasn't been polled yet is already out of date
+        hasResult_ = false;
+        spResult_ = nullptr;
+    }
+    condition_.notify_one();
+}
+
+template <typename V>
+void AsyncMeshGenerator<V>::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    hasRequest_ = false;
+    ++latestRequest_;
+
+    hasResult_ = false;
+    spResult_ = nullptr;
+}
+
+template <typename V>
+bool AsyncMeshGenerator<V>::poll(MeshKey *pKey, std::shared_ptr<const sim::DrawData<V>> *pspData)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!hasResult_) {
+        return false;
+    }
+
+    *pKey = resultKey_;
+    *pspData = std::move(spResult_);
+    hasResult_ = false;
+    return true;
+}
+
+template <typename V>
+bool AsyncMeshGenerator<V>::isBusy() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hasRequest_ || generating_;
+}
+
+template <typename V>
+void AsyncMeshGenerator<V>::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        condition_.wait(lock, [this] { return stop_ || hasRequest_; });
+
+        if (stop_) {
+            return;
+        }
+
+        const MeshKey key = request_;
+        const std::uint64_t requestId = latestRequest_;
+        hasRequest_ = false;
+        generating_ = true;
+
+        lock.unlock();
+
+        std::shared_ptr<sim::DrawData<V>> spData{nullptr};
+        try {
+            spData = std::make_shared<sim::DrawData<V>>(dataFun_(key.uDivisions, key.vDivisions));
+
+            // the result of a superseded request is dropped below so it isn't worth processing
+            if (processFun_ && isLatest(requestId)) {
+                processFun_(key, spData.get());
+            }
+        } catch (const std::exception &e) {
+            std::cerr << "Mesh generation failed: " << e.what() << std::endl;
+        }
+
+        lock.lock();
+        generating_ = false;
+
+        // drop the result if a newer request came in while generating
+        if (spData && requestId == latestRequest_) {
+            resultKey_ = key;
+            spResult_ = std::move(spData);
+            hasResult_ = true;
+        }
+    }
+}
+
+template <typename V>
+bool AsyncMeshGenerator<V>::isLatest(std::uint64_t requestId) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requestId == latestRequest_;
+}
+
+template class AsyncMeshGenerator<sim::PosNormTexVertex>;
+template class AsyncMeshGenerator<sim::PosVertex>;
+
+} // namespace sim
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <sim-driver/meshes/MeshCache.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace sim {
+
+/// Runs a mesh generator on a worker thread. Only the most recent request matters:
+/// requests that haven't started yet are replaced by newer ones, requests superseded
+/// while generating skip post-processing and their results are dropped.
+template <typename V>
+class AsyncMeshGenerator
+{
+public:
+    using MeshDataFun = std::function<sim::DrawData<V>(int, int)>;
+    using MeshProcessFun = std::function<void(const MeshKey &, sim::DrawData<V> *)>;
+
+    /// 'processFun' (optional) runs on each generated mesh unless its request was superseded by then
+    explicit AsyncMeshGenerator(MeshDataFun dataFun, MeshProcessFun processFun = nullptr);
+    ~AsyncMeshGenerator();
+
+    AsyncMeshGenerator(const AsyncMeshGenerator &) = delete;
+    AsyncMeshGenerator &operator=(const AsyncMeshGenerator &) = delete;
+
+    /// Queues generation of 'key.uDivisions' x 'key.vDivisions'
+    void submit(const MeshKey &key);
+
+    /// Supersedes every pending request: a queued request won't start and the result of one that
+    /// is generating (or finished but not polled yet) is dropped
+    void cancel();
+
+    /// Returns true and the finished mesh if the latest request completed since the last poll
+    bool poll(MeshKey *pKey, std::shared_ptr<const sim::DrawData<V>> *pspData);
+
+    /// True while a request is queued or being generated
+    bool isBusy() const;
+
+private:
+    MeshDataFun dataFun_;
+    MeshProcessFun processFun_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stop_{false};
+
+    bool hasRequest_{false};
+    bool generating_{false};
+    MeshKey request_{0, 0, 0, 0, 0};
+    std::uint64_t latestRequest_{0};
+
+    bool hasResult_{false};
+    MeshKey resultKey_{0, 0, 0, 0, 0};
+    std::shared_ptr<const sim::DrawData<V>> spResult_{nullptr};
+
+    std::thread worker_; // started last so everything above is initialized
+
+    void run();
+    bool isLatest(std::uint64_t requestId) const;
+};
+
+} // namespace sim
@@ -0,0 +1,649 @@
+#include <sim-driver/meshes/MeshBvh.hpp>
+#include <sim-driver/meshes/MeshOptimizer.hpp>
+#include <sim-driver/Camera.hpp>
+#include <sim-driver/ParallelFor.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace sim {
+
+namespace {
+
+constexpr unsigned num_bins = 16;
+constexpr unsigned max_leaf_triangles = 8; // leaves can be smaller if SAH prefers a split
+constexpr std::size_t min_parallel_chunk = 1u << 14u; // for the per triangle and per node loops
+constexpr int max_sah_depth = 28; // deeper nodes are split at the median which adds at most 32 levels
+constexpr std::size_t max_traversal_depth = 64;
+
+template <typename Vertex>
+glm::vec3 position_of(const Vertex &vertex)
+{
+    return {vertex.position[0], vertex.position[1], vertex.position[2]};
+}
+
+float surface_area(const AABB &box)
+{
+    if (box.isEmpty()) {
+        return 0.0f;
+    }
+    const glm::vec3 d = box.upper - box.lower;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+// inlined versions of AABB::expand for the build loops
+void grow(AABB *pBox, const glm::vec3 &lower, const glm::vec3 &upper)
+{
+    for (int axis = 0; axis < 3; ++axis) {
+        pBox->lower[axis] = std::min(pBox->lower[axis], lower[axis]);
+        pBox->upper[axis] = std::max(pBox->upper[axis], upper[axis]);
+    }
+}
+
+void grow(AABB *pBox, const AABB &box)
+{
+    grow(pBox, box.lower, box.upper);
+}
+
+void grow(AABB *pBox, const glm::vec3 &point)
+{
+    grow(pBox, point, point);
+}
+
+struct Bin
+{
+    AABB bounds;
+    unsigned count{0};
+};
+
+/// Bounds of the triangles and of their centroids plus the per axis bins of a node range
+struct NodeStats
+{
+    AABB bounds;
+    AABB centroidBounds;
+    Bin bins[3][num_bins];
+
+    void merge(const NodeStats &other)
+    {
+        grow(&bounds, other.bounds);
+        grow(&centroidBounds, other.centroidBounds);
+        for (int axis = 0; axis < 3; ++axis) {
+            for (unsigned b = 0; b < num_bins; ++b) {
+                grow(&bins[axis][b].bounds, other.bins[axis][b].bounds);
+                bins[axis][b].count += other.bins[axis][b].count;
+            }
+        }
+    }
+};
+
+class Builder
+{
+public:
+    Builder(const std::vector<AABB> &triangleBounds,
+            const std::vector<glm::vec3> &centroids,
+            std::vector<unsigned> *pOrder,
+            std::vector<BvhNode> *pNodes,
+            const BvhBuildOptions &options)
+        : triangleBounds_{triangleBounds}
+        , centroids_{centroids}
+        , order_{*pOrder}
+        , nodes_{*pNodes}
+        , parallelBinTriangles_{std::max<std::size_t>(options.parallelBinTriangles, 1)}
+        , parallelSubtreeTriangles_{options.parallelSubtreeTriangles}
+    {
+        unsigned threads = options.maxThreads > 0 ? options.maxThreads : std::thread::hardware_concurrency();
+        threads = std::max(1u, threads);
+        while ((1u << maxParallelDepth_) < threads) {
+            ++maxParallelDepth_;
+        }
+    }
+
+    unsigned build()
+    {
+        nextNode_ = 1;
+        buildNode(0, 0, static_cast<unsigned>(order_.size()), 0);
+        return nextNode_;
+    }
+
+private:
+    const std::vector<AABB> &triangleBounds_;
+    const std::vector<glm::vec3> &centroids_;
+    std::vector<unsigned> &order_;
+    std::vector<BvhNode> &nodes_;
+    std::size_t parallelBinTriangles_;
+    std::size_t parallelSubtreeTriangles_;
+    std::atomic<unsigned> nextNode_{1};
+    int maxParallelDepth_{0};
+
+    /// First pass: bounds only (the bins need the centroid bounds)
+    void computeBounds(unsigned first, unsigned count, NodeStats *pStats) const
+    {
+        auto accumulate = [this](std::size_t begin, std::size_t end, NodeStats *pOut) {
+            for (std::size_t i = begin; i < end; ++i) {
+                unsigned triangle = order_[i];
+                grow(&pOut->bounds, triangleBounds_[triangle]);
+                grow(&pOut->centroidBounds, centroids_[triangle]);
+            }
+        };
+
+        if (count < parallelBinTriangles_) {
+            accumulate(first, first + count, pStats);
+            return;
+        }
+
+        std::mutex mutex;
+        sim::parallel_for(first, first + count, parallelBinTriangles_ / 4, [&](std::size_t begin, std::size_t end) {
+            NodeStats local;
+            accumulate(begin, end, &local);
+            std::lock_guard<std::mutex> lock(mutex);
+            grow(&pStats->bounds, local.bounds);
+            grow(&pStats->centroidBounds, local.centroidBounds);
+        });
+    }
+
+    void computeBins(unsigned first, unsigned count, const glm::vec3 &scale, NodeStats *pStats) const
+    {
+        const glm::vec3 lower = pStats->centroidBounds.lower;
+
+        auto accumulate = [&](std::size_t begin, std::size_t end, NodeStats *pOut) {
+            for (std::size_t i = begin; i < end; ++i) {
+                unsigned triangle = order_[i];
+                for (int axis = 0; axis < 3; ++axis) {
+                    auto b = static_cast<unsigned>((centroids_[triangle][axis] - lower[axis]) * scale[axis]);
+                    Bin &bin = pOut->bins[axis][std::min(b, num_bins - 1)];
+                    grow(&bin.bounds, triangleBounds_[triangle]);
+                    ++bin.count;
+                }
+            }
+        };
+
+        if (count < parallelBinTriangles_) {
+            accumulate(first, first + count, pStats);
+            return;
+        }
+
+        std::mutex mutex;
+        sim::parallel_for(first, first + count, parallelBinTriangles_ / 4, [&](std::size_t begin, std::size_t end) {
+            NodeStats local;
+            accumulate(begin, end, &local);
+            std::lock_guard<std::mutex> lock(mutex);
+            pStats->merge(local);
+        });
+    }
+
+    void makeLeaf(unsigned nodeIndex, unsigned first, unsigned count, const AABB &bounds)
+    {
+        nodes_[nodeIndex] = {bounds.lower, first, bounds.upper, count};
+    }
+
+    void buildNode(unsigned nodeIndex, unsigned first, unsigned count, int depth)
+    {
+        NodeStats stats;
+        computeBounds(first, count, &stats);
+
+        if (count <= 2) {
+            makeLeaf(nodeIndex, first, count, stats.bounds);
+            return;
+        }
+
+        const glm::vec3 extent = stats.centroidBounds.upper - stats.centroidBounds.lower;
+        glm::vec3 scale;
+        for (int axis = 0; axis < 3; ++axis) {
+            scale[axis] = extent[axis] > 0.0f ? num_bins / extent[axis] : 0.0f;
+        }
+        computeBins(first, count, scale, &stats);
+
+        // sweep the split planes between the bins of every axis
+        float bestCost = std::numeric_limits<float>::max();
+        int bestAxis = -1;
+        unsigned bestSplit = 0;
+
+        for (int axis = 0; axis < 3; ++axis) {
+            if (extent[axis] <= 0.0f) {
+                continue;
+            }
+            const Bin *bins = stats.bins[axis];
+
+            float rightCosts[num_bins];
+            AABB right;
+            unsigned rightCount = 0;
+            for (unsigned b = num_bins - 1; b > 0; --b) {
+                grow(&right, bins[b].bounds);
+                rightCount += bins[b].count;
+                rightCosts[b] = surface_area(right) * static_cast<float>(rightCount);
+            }
+
+            AABB left;
+            unsigned leftCount = 0;
+            for (unsigned split = 1; split < num_bins; ++split) {
+                grow(&left, bins[split - 1].bounds);
+                leftCount += bins[split - 1].count;
+                if (leftCount == 0 || leftCount == count) {
+                    continue;
+                }
+                float cost = surface_area(left) * static_cast<float>(leftCount) + rightCosts[split];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = split;
+                }
+            }
+        }
+
+        const float leafCost = surface_area(stats.bounds) * static_cast<float>(count);
+        if (count <= max_leaf_triangles && (bestAxis < 0 || bestCost >= leafCost)) {
+            makeLeaf(nodeIndex, first, count, stats.bounds);
+            return;
+        }
+
+        unsigned middle;
+        if (bestAxis < 0) {
+            // every centroid is in the same spot so any split is as good as another
+            middle = first + count / 2;
+        } else if (depth >= max_sah_depth) {
+            // bounds the depth (and the traversal stack) for pathological inputs
+            int axis = 0;
+            for (int a = 1; a < 3; ++a) {
+                axis = extent[a] > extent[axis] ? a : axis;
+            }
+            middle = first + count / 2;
+            std::nth_element(order_.data() + first,
+                             order_.data() + middle,
+                             order_.data() + first + count,
+                             [&](unsigned a, unsigned b) { return centroids_[a][axis] < centroids_[b][axis]; });
+        } else {
+            const float lower = stats.centroidBounds.lower[bestAxis];
+            const float axisScale = scale[bestAxis];
+            auto *pMiddle = std::partition(order_.data() + first, order_.data() + first + count, [&](unsigned tri) {
+                auto b = static_cast<unsigned>((centroids_[tri][bestAxis] - lower) * axisScale);
+                return std::min(b, num_bins - 1) < bestSplit;
+            });
+            middle = static_cast<unsigned>(pMiddle - order_.data());
+        }
+
+        const unsigned left = nextNode_.fetch_add(2);
+        nodes_[nodeIndex] = {stats.bounds.lower, left, stats.bounds.upper, 0};
+
+        const unsigned leftCount = middle - first;
+        const unsigned rightCount = count - leftCount;
+
+        if (count >= parallelSubtreeTriangles_ && depth < maxParallelDepth_) {
+            std::exception_ptr error;
+            std::thread thread([&] {
+                try {
+                    buildNode(left, first, leftCount, depth + 1);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+            });
+            buildNode(left + 1, middle, rightCount, depth + 1);
+            thread.join();
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        } else {
+            buildNode(left, first, leftCount, depth + 1);
+            buildNode(left + 1, middle, rightCount, depth + 1);
+        }
+    }
+};
+
+/// Slab test, returns the entry distance or infinity on a miss
+float intersect_box(const BvhNode &node, const glm::vec3 &origin, const glm::vec3 &invDirection, float tMin, float tMax)
+{
+    for (int axis = 0; axis < 3; ++axis) {
+        float t0 = (node.lower[axis] - origin[axis]) * invDirection[axis];
+        float t1 = (node.upper[axis] - origin[axis]) * invDirection[axis];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        // written so NaNs (0 * inf on a slab boundary) leave the interval unchanged
+        tMin = t0 > tMin ? t0 : tMin;
+        tMax = t1 < tMax ? t1 : tMax;
+    }
+    return tMin <= tMax ? tMin : std::numeric_limits<float>::infinity();
+}
+
+/// Moller-Trumbore. Returns false on a miss, otherwise fills t and the barycentrics.
+bool intersect_triangle(const Ray &ray,
+                        const glm::vec3 &p0,
+                        const glm::vec3 &p1,
+                        const glm::vec3 &p2,
+                        float *pT,
+                        glm::vec2 *pBarycentrics)
+{
+    const glm::vec3 edge1 = p1 - p0;
+    const glm::vec3 edge2 = p2 - p0;
+    const glm::vec3 pvec = glm::cross(ray.direction, edge2);
+    const float determinant = glm::dot(edge1, pvec);
+
+    if (determinant == 0.0f) {
+        return false; // parallel (both sides are hit so there is no back face culling)
+    }
+    const float invDeterminant = 1.0f / determinant;
+
+    const glm::vec3 tvec = ray.origin - p0;
+    const float u = glm::dot(tvec, pvec) * invDeterminant;
+    if (u < 0.0f || u > 1.0f) {
+        return false;
+    }
+
+    const glm::vec3 qvec = glm::cross(tvec, edge1);
+    const float v = glm::dot(ray.direction, qvec) * invDeterminant;
+    if (v < 0.0f || u + v > 1.0f) {
+        return false;
+    }
+
+    *pT = glm::dot(edge2, qvec) * invDeterminant;
+    *pBarycentrics = {u, v};
+    return true;
+}
+
+} // namespace
+
+Ray screen_ray(double cursorX, double cursorY, int width, int height, const Camera &camera)
+{
+    const auto x = static_cast<float>(2.0 * cursorX / std::max(1, width) - 1.0);
+    const auto y = static_cast<float>(1.0 - 2.0 * cursorY / std::max(1, height));
+
+    const glm::vec3 forward = glm::normalize(camera.getLookVector());
+    const glm::vec3 right = glm::normalize(glm::cross(forward, camera.getUpVector()));
+    const glm::vec3 up = glm::cross(right, forward);
+
+    const float tanHalfFov = std::tan(camera.getFovYRadians() * 0.5f);
+    const glm::vec3 direction
+        = forward + right * (x * tanHalfFov * camera.getAspectRatio()) + up * (y * tanHalfFov);
+
+    Ray ray;
+    ray.origin = camera.getEyeVector() + direction * camera.getNearPlane(); // forward component is one
+    ray.direction = glm::normalize(direction);
+    return ray;
+}
+
+Ray transform_ray(const Ray &ray, const glm::mat4 &matrix)
+{
+    Ray result = ray;
+    result.origin = glm::vec3(matrix * glm::vec4(ray.origin, 1.0f));
+    result.direction = glm::vec3(matrix * glm::vec4(ray.direction, 0.0f));
+    return result;
+}
+
+template <typename Vertex>
+MeshBvh::MeshBvh(const DrawDataView<Vertex> &data, GLenum drawMode, const BvhBuildOptions &options)
+{
+    positions_.resize(data.vboSize);
+    for (std::size_t i = 0; i < data.vboSize; ++i) {
+        positions_[i] = position_of(data.vbo[i]);
+    }
+
+    std::vector<unsigned> indices;
+    if (data.iboSize > 0) {
+        indices.assign(data.ibo, data.ibo + data.iboSize);
+    } else {
+        indices.resize(data.vboSize);
+        std::iota(indices.begin(), indices.end(), 0u);
+    }
+    triangles_ = to_triangle_list(indices, drawMode);
+    build(options);
+}
+
+MeshBvh::MeshBvh(std::vector<glm::vec3> positions, std::vector<unsigned> triangles, const BvhBuildOptions &options)
+    : positions_{std::move(positions)}, triangles_{std::move(triangles)}
+{
+    if (triangles_.size() % 3 != 0) {
+        throw std::runtime_error("Triangle list size must be a multiple of three");
+    }
+    build(options);
+}
+
+void MeshBvh::build(const BvhBuildOptions &options)
+{
+    for (unsigned index : triangles_) {
+        if (index >= positions_.size()) {
+            throw std::runtime_error("Triangle index is out of range of the vertex buffer");
+        }
+    }
+
+    const std::size_t numTriangles = getNumTriangles();
+    std::vector<AABB> triangleBounds(numTriangles);
+    std::vector<glm::vec3> centroids(numTriangles);
+
+    sim::parallel_for(0, numTriangles, min_parallel_chunk, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t t = begin; t < end; ++t) {
+            AABB box;
+            for (std::size_t k = 0; k < 3; ++k) {
+                grow(&box, positions_[triangles_[t * 3 + k]]);
+            }
+            triangleBounds[t] = box;
+            centroids[t] = box.center();
+        }
+    });
+
+    order_.resize(numTriangles);
+    std::iota(order_.begin(), order_.end(), 0u);
+
+    nodes_.clear();
+    if (numTriangles == 0) {
+        return;
+    }
+
+    nodes_.resize(2 * numTriangles - 1);
+    Builder builder(triangleBounds, centroids, &order_, &nodes_, options);
+    nodes_.resize(builder.build());
+    nodes_.shrink_to_fit();
+}
+
+RayHit MeshBvh::intersect(const Ray &ray) const
+{
+    RayHit result;
+    if (nodes_.empty()) {
+        return result;
+    }
+
+    const glm::vec3 invDirection = 1.0f / ray.direction;
+    float tMax = ray.tMax;
+
+    unsigned stack[max_traversal_depth];
+    std::size_t stackSize = 0;
+
+    if (intersect_box(nodes_[0], ray.origin, invDirection, ray.tMin, tMax) == std::numeric_limits<float>::infinity()) {
+        return result;
+    }
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const BvhNode &node = nodes_[stack[--stackSize]];
+
+        if (node.count > 0) {
+            for (unsigned i = node.first; i < node.first + node.count; ++i) {
+                const unsigned triangle = order_[i];
+                const unsigned *pIndices = &triangles_[triangle * 3];
+
+                float t;
+                glm::vec2 barycentrics;
+                if (intersect_triangle(ray,
+                                       positions_[pIndices[0]],
+                                       positions_[pIndices[1]],
+                                       positions_[pIndices[2]],
+                                       &t,
+                                       &barycentrics)
+                    && t >= ray.tMin && t <= tMax) {
+                    tMax = t;
+                    result.hit = true;
+                    result.t = t;
+                    result.triangle = triangle;
+                    result.barycentrics = barycentrics;
+                }
+            }
+            continue;
+        }
+
+        // visit the nearer child first so later boxes can be rejected by the closer hit
+        unsigned near = node.first;
+        unsigned far = node.first + 1;
+        float tNear = intersect_box(nodes_[near], ray.origin, invDirection, ray.tMin, tMax);
+        float tFar = intersect_box(nodes_[far], ray.origin, invDirection, ray.tMin, tMax);
+        if (tFar < tNear) {
+            std::swap(near, far);
+            std::swap(tNear, tFar);
+        }
+
+        if (tFar != std::numeric_limits<float>::infinity()) {
+            stack[stackSize++] = far;
+        }
+        if (tNear != std::numeric_limits<float>::infinity()) {
+            stack[stackSize++] = near;
+        }
+    }
+
+    if (result.hit) {
+        result.position = ray.origin + ray.direction * result.t;
+    }
+    return result;
+}
+
+bool MeshBvh::occluded(const Ray &ray) const
+{
+    if (nodes_.empty()) {
+        return false;
+    }
+
+    const glm::vec3 invDirection = 1.0f / ray.direction;
+
+    unsigned stack[max_traversal_depth];
+    std::size_t stackSize = 0;
+
+    if (intersect_box(nodes_[0], ray.origin, invDirection, ray.tMin, ray.tMax)
+        == std::numeric_limits<float>::infinity()) {
+        return false;
+    }
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const BvhNode &node = nodes_[stack[--stackSize]];
+
+        if (node.count > 0) {
+            for (unsigned i = node.first; i < node.first + node.count; ++i) {
+                const unsigned *pIndices = &triangles_[order_[i] * 3];
+
+                float t;
+                glm::vec2 barycentrics;
+                if (intersect_triangle(ray,
+                                       positions_[pIndices[0]],
+                                       positions_[pIndices[1]],
+                                       positions_[pIndices[2]],
+                                       &t,
+                                       &barycentrics)
+                    && t >= ray.tMin && t <= ray.tMax) {
+                    return true;
+                }
+            }
+            continue;
+        }
+
+        // any hit ends the query so the children aren't sorted by distance
+        for (unsigned child = node.first; child < node.first + 2; ++child) {
+            if (intersect_box(nodes_[child], ray.origin, invDirection, ray.tMin, ray.tMax)
+                != std::numeric_limits<float>::infinity()) {
+                stack[stackSize++] = child;
+            }
+        }
+    }
+    return false;
+}
+
+template <typename Vertex>
+void MeshBvh::refit(const Vertex *pVertices, std::size_t numVertices)
+{
+    if (numVertices != positions_.size()) {
+        throw std::runtime_error("Refit needs the same number of vertices the BVH was built with");
+    }
+    for (std::size_t i = 0; i < numVertices; ++i) {
+        positions_[i] = position_of(pVertices[i]);
+    }
+    refitNodes();
+}
+
+void MeshBvh::refit(std::vector<glm::vec3> positions)
+{
+    if (positions.size() != positions_.size()) {
+        throw std::runtime_error("Refit needs the same number of vertices the BVH was built with");
+    }
+    positions_ = std::move(positions);
+    refitNodes();
+}
+
+void MeshBvh::refitNodes()
+{
+    // leaves are independent
+    sim::parallel_for(0, nodes_.size(), min_parallel_chunk, [this](std::size_t begin, std::size_t end) {
+        for (std::size_t n = begin; n < end; ++n) {
+            BvhNode &node = nodes_[n];
+            if (node.count == 0) {
+                continue;
+            }
+            AABB box;
+            for (unsigned i = node.first; i < node.first + node.count; ++i) {
+                const unsigned triangle = order_[i];
+                for (std::size_t k = 0; k < 3; ++k) {
+                    grow(&box, positions_[triangles_[triangle * 3 + k]]);
+                }
+            }
+            node.lower = box.lower;
+            node.upper = box.upper;
+        }
+    });
+
+    // children always come after their parents
+    for (std::size_t n = nodes_.size(); n-- > 0;) {
+        BvhNode &node = nodes_[n];
+        if (node.count > 0) {
+            continue;
+        }
+        const BvhNode &left = nodes_[node.first];
+        const BvhNode &right = nodes_[node.first + 1];
+        node.lower = glm::min(left.lower, right.lower);
+        node.upper = glm::max(left.upper, right.upper);
+    }
+}
+
+AABB MeshBvh::getBounds() const
+{
+    AABB box;
+    if (!nodes_.empty()) {
+        box.lower = nodes_[0].lower;
+        box.upper = nodes_[0].upper;
+    }
+    return box;
+}
+
+std::size_t MeshBvh::getNumTriangles() const
+{
+    return triangles_.size() / 3;
+}
+
+const std::vector<unsigned> &MeshBvh::getTriangles() const
+{
+    return triangles_;
+}
+
+const std::vector<BvhNode> &MeshBvh::getNodes() const
+{
+    return nodes_;
+}
+
+template MeshBvh::MeshBvh(const DrawDataView<sim::PosNormTexVertex> &data,
+                          GLenum drawMode,
+                          const BvhBuildOptions &options);
+template MeshBvh::MeshBvh(const DrawDataView<sim::PosVertex> &data, GLenum drawMode, const BvhBuildOptions &options);
+
+template void MeshBvh::refit(const sim::PosNormTexVertex *pVertices, std::size_t numVertices);
+template void MeshBvh::refit(const sim::PosVertex *pVertices, std::size_t numVertices);
+
+} // namespace sim
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <sim-driver/OpenGLTypes.hpp>
+#include <sim-driver/Bounds.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+
+namespace sim {
+
+struct Ray
+{
+    glm::vec3 origin{0.0f};
+    glm::vec3 direction{0.0f, 0.0f, -1.0f}; // doesn't have to be normalized (t is in units of its length)
+    float tMin{0.0f};
+    float tMax{std::numeric_limits<float>::infinity()};
+};
+
+struct RayHit
+{
+    bool hit{false};
+    float t{std::numeric_limits<float>::infinity()};
+    std::size_t triangle{0}; // index into MeshBvh::getTriangles
+    glm::vec2 barycentrics{0.0f}; // weights of the second and third corner
+    glm::vec3 position{0.0f};
+};
+
+/// World space ray through the cursor ('cursorX', 'cursorY' in window coordinates with the
+/// origin at the top left like GLFW) starting on the near plane of the perspective camera
+Ray screen_ray(double cursorX, double cursorY, int width, int height, const Camera &camera);
+
+/// Moves a ray into another space (e.g. the local space of a mesh with the inverse of its
+/// model matrix). Hit distances stay the same since the direction isn't renormalized.
+Ray transform_ray(const Ray &ray, const glm::mat4 &matrix);
+
+/// 32 byte node. Leaves hold 'count' triangles starting at 'first', inner nodes have their
+/// children at 'first' and 'first' + 1. Children always come after their parent.
+struct BvhNode
+{
+    glm::vec3 lower;
+    unsigned first;
+    glm::vec3 upper;
+    unsigned count;
+};
+
+/// Thresholds for the parallel parts of the build
+struct BvhBuildOptions
+{
+    std::size_t parallelBinTriangles{1u << 16u}; // larger nodes are binned with parallel_for
+    std::size_t parallelSubtreeTriangles{1u << 15u}; // larger subtrees are built on their own thread
+    unsigned maxThreads{0}; // for the subtrees, 0 uses std::thread::hardware_concurrency
+};
+
+/// Bounding volume hierarchy over the triangles of a mesh for picking and ray queries.
+/// Built top down with binned SAH splits. Large nodes are binned with parallel_for and
+/// large subtrees are built on their own threads. For deforming meshes 'refit' updates
+/// the bounds in one bottom up pass while keeping the topology.
+class MeshBvh
+{
+public:
+    MeshBvh() = default;
+
+    /// GL_TRIANGLE_STRIP (with primitive restart) and GL_TRIANGLES are supported
+    template <typename Vertex>
+    MeshBvh(const DrawDataView<Vertex> &data, GLenum drawMode, const BvhBuildOptions &options = {});
+
+    MeshBvh(std::vector<glm::vec3> positions,
+            std::vector<unsigned> triangles,
+            const BvhBuildOptions &options = {});
+
+    /// Nearest hit in [ray.tMin, ray.tMax]
+    RayHit intersect(const Ray &ray) const;
+
+    /// True if anything is hit in [ray.tMin, ray.tMax]. Returns at the first hit found instead
+    /// of searching for the nearest one.
+    bool occluded(const Ray &ray) const;
+
+    /// New vertex positions for the same topology
+    template <typename Vertex>
+    void refit(const Vertex *pVertices, std::size_t numVertices);
+
+    void refit(std::vector<glm::vec3> positions);
+
+    AABB getBounds() const;
+    std::size_t getNumTriangles() const;
+    const std::vector<unsigned> &getTriangles() const; // 3 vertex indices per triangle
+    const std::vector<BvhNode> &getNodes() const;
+
+private:
+    std::vector<glm::vec3> positions_;
+    std::vector<unsigned> triangles_; // 3 indices per triangle, in the original order
+    std::vector<unsigned> order_; // triangle indices sorted so every leaf is a contiguous range
+    std::vector<BvhNode> nodes_;
+
+    void build(const BvhBuildOptions &options);
+    void refitNodes();
+};
+
+} // namespace sim
@@ -0,0 +1,154 @@
+#include <sim-driver/meshes/MeshCache.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <functional>
+
+namespace sim {
+
+namespace {
+
+template <typename V>
+std::size_t cpu_bytes(const DrawData<V> &data)
+{
+    return data.vbo.size() * sizeof(V) + data.ibo.size() * sizeof(unsigned);
+}
+
+template <typename V>
+std::size_t gpu_bytes(const MeshBuffers &buffers)
+{
+    std::size_t indexBytes = buffers.iboType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+    return static_cast<std::size_t>(buffers.vboSize) * sizeof(V)
+        + static_cast<std::size_t>(buffers.iboSize) * indexBytes;
+}
+
+} // namespace
+
+bool MeshKey::operator==(const MeshKey &other) const
+{
+    return function == other.function && instance == other.instance && uDivisions == other.uDivisions
+        && vDivisions == other.vDivisions && variant == other.variant;
+}
+
+std::size_t MeshKeyHash::operator()(const MeshKey &key) const
+{
+    std::size_t seed = std::hash<std::uintptr_t>{}(key.function);
+    auto combine = [&seed](std::size_t value) { seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2); };
+    combine(std::hash<std::uint64_t>{}(key.instance));
+    combine(std::hash<int>{}(key.uDivisions));
+    combine(std::hash<int>{}(key.vDivisions));
+    combine(std::hash<int>{}(key.variant));
+    return seed;
+}
+
+template <typename V>
+MeshCache<V>::MeshCache(std::size_t budgetBytes)
+{
+    stats_.budgetBytes = budgetBytes;
+}
+
+template <typename V>
+std::shared_ptr<const DrawData<V>> MeshCache<V>::findData(const MeshKey &key)
+{
+    Entry *pEntry = touch(key);
+
+    if (!pEntry) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    ++stats_.hits;
+    return pEntry->spData;
+}
+
+template <typename V>
+const MeshBuffers *MeshCache<V>::findBuffers(const MeshKey &key)
+{
+    Entry *pEntry = touch(key);
+    return (pEntry && pEntry->buffers.vbo) ? &pEntry->buffers : nullptr;
+}
+
+template <typename V>
+void MeshCache<V>::insert(const MeshKey &key, std::shared_ptr<const DrawData<V>> spData)
+{
+    auto iter = lookup_.find(key);
+    if (iter != lookup_.end()) {
+        stats_.memoryBytes -= iter->second->bytes;
+        entries_.erase(iter->second);
+        lookup_.erase(iter);
+    }
+
+    std::size_t bytes = cpu_bytes(*spData);
+    entries_.push_front({key, std::move(spData), {}, bytes});
+    lookup_.emplace(key, entries_.begin());
+    stats_.memoryBytes += bytes;
+
+    evict();
+}
+
+template <typename V>
+void MeshCache<V>::setBuffers(const MeshKey &key, MeshBuffers buffers)
+{
+    auto iter = lookup_.find(key);
+    if (iter == lookup_.end()) {
+        return;
+    }
+
+    Entry &entry = *iter->second;
+    std::size_t bytes = cpu_bytes(*entry.spData) + gpu_bytes<V>(buffers);
+    stats_.memoryBytes = stats_.memoryBytes - entry.bytes + bytes;
+    entry.bytes = bytes;
+    entry.buffers = std::move(buffers);
+
+    evict();
+}
+
+template <typename V>
+void MeshCache<V>::clear()
+{
+    entries_.clear();
+    lookup_.clear();
+    stats_.memoryBytes = 0;
+    stats_.numEntries = 0;
+}
+
+template <typename V>
+void MeshCache<V>::setBudget(std::size_t budgetBytes)
+{
+    stats_.budgetBytes = budgetBytes;
+    evict();
+}
+
+template <typename V>
+const MeshCacheStats &MeshCache<V>::getStats() const
+{
+    return stats_;
+}
+
+template <typename V>
+typename MeshCache<V>::Entry *MeshCache<V>::touch(const MeshKey &key)
+{
+    auto iter = lookup_.find(key);
+    if (iter == lookup_.end()) {
+        return nullptr;
+    }
+
+    // move to the front without invalidating the stored iterator
+    entries_.splice(entries_.begin(), entries_, iter->second);
+    return &entries_.front();
+}
+
+template <typename V>
+void MeshCache<V>::evict()
+{
+    while (stats_.memoryBytes > stats_.budgetBytes && !entries_.empty()) {
+        const Entry &oldest = entries_.back();
+        stats_.memoryBytes -= oldest.bytes;
+        lookup_.erase(oldest.key);
+        entries_.pop_back();
+        ++stats_.evictions;
+    }
+    stats_.numEntries = entries_.size();
+}
+
+template class MeshCache<sim::PosNormTexVertex>;
+template class MeshCache<sim::PosVertex>;
+
+} // namespace sim
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <sim-driver/OpenGLTypes.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace sim {
+
+/// Identifies the output of a mesh generator at one resolution
+struct MeshKey
+{
+    std::uintptr_t function; // address of a plain generator function, 0 otherwise
+    std::uint64_t instance; // unique id for generators that aren't plain functions, 0 otherwise
+    int uDivisions;
+    int vDivisions;
+    int variant; // post-processing applied to the generated data (0 = none, 1 = optimized indices)
+
+    bool operator==(const MeshKey &other) const;
+};
+
+struct MeshKeyHash
+{
+    std::size_t operator()(const MeshKey &key) const;
+};
+
+struct MeshCacheStats
+{
+    std::size_t hits{0};
+    std::size_t misses{0};
+    std::size_t evictions{0};
+    std::size_t numEntries{0};
+    std::size_t memoryBytes{0}; // cpu + gpu
+    std::size_t budgetBytes{0};
+};
+
+/// Least recently used cache of generated meshes and their GPU buffers. Entries are
+/// evicted once the combined cpu and gpu memory exceeds the budget. Evicted data stays
+/// alive for as long as a MeshHelper or renderer still references it.
+template <typename V>
+class MeshCache
+{
+public:
+    explicit MeshCache(std::size_t budgetBytes = 256u << 20u);
+
+    /// Returns nullptr on a miss. Hits become the most recently used entry.
+    std::shared_ptr<const DrawData<V>> findData(const MeshKey &key);
+
+    /// Returns nullptr if the key isn't cached or its buffers haven't been uploaded yet
+    const MeshBuffers *findBuffers(const MeshKey &key);
+
+    void insert(const MeshKey &key, std::shared_ptr<const DrawData<V>> spData);
+
+    /// Attaches uploaded buffers to an existing entry (ignored if it was already evicted)
+    void setBuffers(const MeshKey &key, MeshBuffers buffers);
+
+    void clear();
+
+    void setBudget(std::size_t budgetBytes);
+
+    const MeshCacheStats &getStats() const;
+
+private:
+    struct Entry
+    {
+        MeshKey key;
+        std::shared_ptr<const DrawData<V>> spData;
+        MeshBuffers buffers;
+        std::size_t bytes;
+    };
+
+    std::list<Entry> entries_; // most recently used first
+    std::unordered_map<MeshKey, typename std::list<Entry>::iterator, MeshKeyHash> lookup_;
+    MeshCacheStats stats_;
+
+    Entry *touch(const MeshKey &key);
+    void evict();
+};
+
+using PosNormTexMeshCache = MeshCache<sim::PosNormTexVertex>;
+using PosMeshCache = MeshCache<sim::PosVertex>;
+
+} // namespace sim
@@ -0,0 +1,418 @@
+#include <sim-driver/meshes/MeshFile.hpp>
+#include <sim-driver/OpenGLHelper.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+namespace sim {
+
+namespace {
+
+template <typename Vertex>
+struct LevelRef
+{
+    const DrawData<Vertex> *pData;
+    float error;
+};
+
+std::uint64_t align_offset(std::uint64_t offset)
+{
+    return (offset + mesh_file_alignment - 1) / mesh_file_alignment * mesh_file_alignment;
+}
+
+const MeshFileSection *find_section(const MeshFileSection *pSections,
+                                    std::uint32_t numSections,
+                                    MeshFileSectionType type)
+{
+    for (std::uint32_t i = 0; i < numSections; ++i) {
+        if (pSections[i].type == static_cast<std::uint32_t>(type)) {
+            return pSections + i;
+        }
+    }
+    return nullptr;
+}
+
+std::size_t get_index_size(GLenum indexType)
+{
+    return indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+}
+
+/// True if every index other than the restart index refers to one of 'numVertices' vertices
+template <typename Index>
+bool indices_in_range(const char *pIndices, const MeshFileLod &lod)
+{
+    const Index *pBegin = reinterpret_cast<const Index *>(pIndices) + lod.firstIndex;
+    return std::all_of(pBegin, pBegin + lod.numIndices, [&lod](Index index) {
+        return index < lod.numVertices || index == sim::primitiveRestart();
+    });
+}
+
+/// Buffers the sections in memory and writes them out with the section table
+class MeshFileWriter
+{
+public:
+    void addSection(MeshFileSectionType type, const void *pData, std::size_t size)
+    {
+        const auto *pBytes = static_cast<const char *>(pData);
+        sections_.push_back({static_cast<std::uint32_t>(type), 0, 0, size});
+        blobs_.emplace_back(pBytes, pBytes + size);
+    }
+
+    void write(const std::string &filename, MeshFileHeader header)
+    {
+        header.numSections = static_cast<std::uint32_t>(sections_.size());
+
+        std::uint64_t offset = sizeof(MeshFileHeader) + sizeof(MeshFileSection) * sections_.size();
+        for (MeshFileSection &section : sections_) {
+            section.offset = offset = align_offset(offset);
+            offset += section.size;
+        }
+
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Failed to open " + filename + " for writing");
+        }
+
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(sections_.data()),
+                  static_cast<std::streamsize>(sizeof(MeshFileSection) * sections_.size()));
+
+        const char padding[mesh_file_alignment] = {};
+        for (std::size_t i = 0; i < sections_.size(); ++i) {
+            auto position = static_cast<std::uint64_t>(out.tellp());
+            out.write(padding, static_cast<std::streamsize>(sections_[i].offset - position));
+            out.write(blobs_[i].data(), static_cast<std::streamsize>(blobs_[i].size()));
+        }
+
+        if (!out) {
+            throw std::runtime_error("Failed to write " + filename);
+        }
+    }
+
+private:
+    std::vector<MeshFileSection> sections_;
+    std::vector<std::vector<char>> blobs_;
+};
+
+template <typename Vertex>
+void write_levels(const std::string &filename, const std::vector<LevelRef<Vertex>> &levels, GLenum drawMode)
+{
+    if (levels.empty()) {
+        throw std::runtime_error("A mesh file needs at least one level");
+    }
+
+    MeshFileHeader header{};
+    std::copy(std::begin(mesh_file_magic), std::end(mesh_file_magic), header.magic);
+    header.version = mesh_file_version;
+    header.drawMode = drawMode;
+
+    // all levels share one vertex and one index blob
+    std::vector<Vertex> vertices;
+    std::vector<unsigned> indices;
+    std::vector<MeshFileLod> lods;
+    bool fits16Bit = true;
+
+    for (const LevelRef<Vertex> &level : levels) {
+        const DrawData<Vertex> &data = *level.pData;
+        MeshFileLod lod{indices.size(), 0, vertices.size(), data.vbo.size(), level.error, 0};
+
+        vertices.insert(vertices.end(), data.vbo.begin(), data.vbo.end());
+
+        if (data.ibo.empty()) {
+            std::vector<unsigned> sequential(data.vbo.size());
+            std::iota(sequential.begin(), sequential.end(), 0u);
+            indices.insert(indices.end(), sequential.begin(), sequential.end());
+        } else {
+            indices.insert(indices.end(), data.ibo.begin(), data.ibo.end());
+        }
+        lod.numIndices = indices.size() - lod.firstIndex;
+
+        // the restart index has no 16 bit equivalent with the current primitiveRestart()
+        fits16Bit = fits16Bit && data.vbo.size() < 0xFFFFu
+            && std::find(data.ibo.begin(), data.ibo.end(), sim::primitiveRestart()) == data.ibo.end();
+
+        lods.push_back(lod);
+    }
+
+    header.numVertices = vertices.size();
+    header.numIndices = indices.size();
+
+    constexpr auto attribs = VertexFormat<Vertex>::attributes();
+    std::vector<char> layout(sizeof(MeshFileLayout) + sizeof(MeshFileAttrib) * attribs.size());
+    MeshFileLayout layoutHeader{sizeof(Vertex), static_cast<std::uint32_t>(attribs.size())};
+    std::memcpy(layout.data(), &layoutHeader, sizeof(layoutHeader));
+
+    for (std::size_t i = 0; i < attribs.size(); ++i) {
+        MeshFileAttrib attrib{attribs[i].location,
+                              attribs[i].size,
+                              attribs[i].type,
+                              attribs[i].normalized,
+                              static_cast<std::uint64_t>(attribs[i].offset)};
+        std::memcpy(layout.data() + sizeof(MeshFileLayout) + sizeof(MeshFileAttrib) * i, &attrib, sizeof(attrib));
+    }
+
+    AABB box = compute_bounds(levels.front().pData->vbo.data(), levels.front().pData->vbo.size());
+    BoundingSphere sphere = bounding_sphere(box);
+    MeshFileBounds bounds{};
+    if (!box.isEmpty()) {
+        std::copy(&box.lower.x, &box.lower.x + 3, bounds.lower);
+        std::copy(&box.upper.x, &box.upper.x + 3, bounds.upper);
+        std::copy(&sphere.center.x, &sphere.center.x + 3, bounds.center);
+        bounds.radius = sphere.radius;
+    }
+
+    MeshFileWriter writer;
+    writer.addSection(MeshFileSectionType::VertexLayout, layout.data(), layout.size());
+    writer.addSection(MeshFileSectionType::Vertices, vertices.data(), sizeof(Vertex) * vertices.size());
+
+    if (fits16Bit) {
+        std::vector<GLushort> narrow(indices.begin(), indices.end());
+        header.indexType = GL_UNSIGNED_SHORT;
+        writer.addSection(MeshFileSectionType::Indices, narrow.data(), sizeof(GLushort) * narrow.size());
+    } else {
+        header.indexType = GL_UNSIGNED_INT;
+        writer.addSection(MeshFileSectionType::Indices, indices.data(), sizeof(GLuint) * indices.size());
+    }
+
+    if (lods.size() > 1) {
+        writer.addSection(MeshFileSectionType::Lods, lods.data(), sizeof(MeshFileLod) * lods.size());
+    }
+    writer.addSection(MeshFileSectionType::Bounds, &bounds, sizeof(bounds));
+
+    writer.write(filename, header);
+}
+
+} // namespace
+
+MeshFile::MeshFile(const std::string &filename, bool verifyIndices) : file_(filename)
+{
+    const char *pBegin = file_.data();
+    const std::size_t fileSize = file_.size();
+
+    if (fileSize < sizeof(MeshFileHeader)) {
+        throw std::runtime_error(filename + " is too small to be a mesh file");
+    }
+    pHeader_ = reinterpret_cast<const MeshFileHeader *>(pBegin);
+
+    if (!std::equal(std::begin(mesh_file_magic), std::end(mesh_file_magic), pHeader_->magic)) {
+        throw std::runtime_error(filename + " is not a mesh file");
+    }
+    if (pHeader_->version != mesh_file_version) {
+        throw std::runtime_error(filename + " has unsupported mesh file version "
+                                 + std::to_string(pHeader_->version));
+    }
+    if (pHeader_->indexType != GL_UNSIGNED_SHORT && pHeader_->indexType != GL_UNSIGNED_INT) {
+        throw std::runtime_error(filename + " has an invalid index type");
+    }
+    if (sizeof(MeshFileHeader) + sizeof(MeshFileSection) * std::uint64_t{pHeader_->numSections} > fileSize) {
+        throw std::runtime_error(filename + " has a truncated section table");
+    }
+
+    const auto *pSections = reinterpret_cast<const MeshFileSection *>(pBegin + sizeof(MeshFileHeader));
+
+    for (std::uint32_t i = 0; i < pHeader_->numSections; ++i) {
+        const MeshFileSection &section = pSections[i];
+        if (section.offset % mesh_file_alignment != 0 || section.offset > fileSize
+            || section.size > fileSize - section.offset) {
+            throw std::runtime_error(filename + " has a section outside of the file");
+        }
+    }
+
+    const MeshFileSection *pLayout = find_section(pSections, pHeader_->numSections, MeshFileSectionType::VertexLayout);
+    const MeshFileSection *pVertices = find_section(pSections, pHeader_->numSections, MeshFileSectionType::Vertices);
+    const MeshFileSection *pIndices = find_section(pSections, pHeader_->numSections, MeshFileSectionType::Indices);
+    const MeshFileSection *pLods = find_section(pSections, pHeader_->numSections, MeshFileSectionType::Lods);
+    const MeshFileSection *pBounds = find_section(pSections, pHeader_->numSections, MeshFileSectionType::Bounds);
+
+    if (!pLayout || !pVertices || !pIndices) {
+        throw std::runtime_error(filename + " is missing a layout, vertex or index section");
+    }
+
+    if (pLayout->size < sizeof(MeshFileLayout)) {
+        throw std::runtime_error(filename + " has a truncated vertex layout");
+    }
+    pLayout_ = reinterpret_cast<const MeshFileLayout *>(pBegin + pLayout->offset);
+    pAttribs_ = reinterpret_cast<const MeshFileAttrib *>(pBegin + pLayout->offset + sizeof(MeshFileLayout));
+
+    if (pLayout->size < sizeof(MeshFileLayout) + sizeof(MeshFileAttrib) * std::uint64_t{pLayout_->numAttribs}
+        || pLayout_->stride == 0) {
+        throw std::runtime_error(filename + " has a truncated vertex layout");
+    }
+
+    // the counts are checked against the section sizes first so the products can't wrap
+    if (pHeader_->numVertices > pVertices->size / pLayout_->stride
+        || pVertices->size != std::uint64_t{pLayout_->stride} * pHeader_->numVertices
+        || pHeader_->numIndices > pIndices->size / indexSize()
+        || pIndices->size != indexSize() * pHeader_->numIndices) {
+        throw std::runtime_error(filename + " has vertex or index sections that don't match the header");
+    }
+    pVertices_ = pBegin + pVertices->offset;
+    pIndices_ = pBegin + pIndices->offset;
+
+    if (pLods) {
+        if (pLods->size % sizeof(MeshFileLod) != 0) {
+            throw std::runtime_error(filename + " has a truncated LOD section");
+        }
+        pLods_ = reinterpret_cast<const MeshFileLod *>(pBegin + pLods->offset);
+        numLods_ = pLods->size / sizeof(MeshFileLod);
+
+        for (std::size_t i = 0; i < numLods_; ++i) {
+            const MeshFileLod &lod = pLods_[i];
+            if (lod.firstIndex > pHeader_->numIndices || lod.numIndices > pHeader_->numIndices - lod.firstIndex
+                || lod.baseVertex > pHeader_->numVertices
+                || lod.numVertices > pHeader_->numVertices - lod.baseVertex) {
+                throw std::runtime_error(filename + " has a LOD outside of the vertex or index data");
+            }
+        }
+    }
+
+    // reading every index defeats zero-parse loading so it's only done for untrusted files
+    for (std::size_t i = 0; verifyIndices && i < getNumLevels(); ++i) {
+        const MeshFileLod lod = getLevel(i);
+        const bool inRange = pHeader_->indexType == GL_UNSIGNED_SHORT ? indices_in_range<GLushort>(pIndices_, lod)
+                                                                      : indices_in_range<GLuint>(pIndices_, lod);
+        if (!inRange) {
+            throw std::runtime_error(filename + " has indices outside of the vertex data of level "
+                                     + std::to_string(i));
+        }
+    }
+
+    if (pBounds) {
+        if (pBounds->size != sizeof(MeshFileBounds)) {
+            throw std::runtime_error(filename + " has an invalid bounds section");
+        }
+        pBounds_ = reinterpret_cast<const MeshFileBounds *>(pBegin + pBounds->offset);
+    }
+}
+
+const MeshFileHeader &MeshFile::getHeader() const
+{
+    return *pHeader_;
+}
+
+GLenum MeshFile::getDrawMode() const
+{
+    return pHeader_->drawMode;
+}
+
+GLenum MeshFile::getIndexType() const
+{
+    return pHeader_->indexType;
+}
+
+const MeshFileLayout &MeshFile::getLayout() const
+{
+    return *pLayout_;
+}
+
+const MeshFileAttrib *MeshFile::getAttribs() const
+{
+    return pAttribs_;
+}
+
+const void *MeshFile::getVertexData() const
+{
+    return pVertices_;
+}
+
+const void *MeshFile::getIndexData() const
+{
+    return pIndices_;
+}
+
+std::size_t MeshFile::getNumLevels() const
+{
+    return pLods_ ? numLods_ : 1;
+}
+
+MeshFileLod MeshFile::getLevel(std::size_t level) const
+{
+    if (level >= getNumLevels()) {
+        throw std::runtime_error("Mesh file level " + std::to_string(level) + " doesn't exist");
+    }
+    if (pLods_) {
+        return pLods_[level];
+    }
+    return {0, pHeader_->numIndices, 0, pHeader_->numVertices, 0.0f, 0};
+}
+
+const MeshFileBounds *MeshFile::getBounds() const
+{
+    return pBounds_;
+}
+
+AABB MeshFile::getBox() const
+{
+    AABB box;
+    if (pBounds_) {
+        box.lower = {pBounds_->lower[0], pBounds_->lower[1], pBounds_->lower[2]};
+        box.upper = {pBounds_->upper[0], pBounds_->upper[1], pBounds_->upper[2]};
+    }
+    return box;
+}
+
+MeshBuffers MeshFile::createBuffers(std::size_t level) const
+{
+    const MeshFileLod lod = getLevel(level);
+
+    std::vector<VertexAttrib> attribs;
+    attribs.reserve(pLayout_->numAttribs);
+    for (std::size_t i = 0; i < pLayout_->numAttribs; ++i) {
+        const MeshFileAttrib &stored = pAttribs_[i];
+        attribs.push_back({stored.location,
+                           stored.size,
+                           stored.type,
+                           static_cast<GLboolean>(stored.normalized),
+                           static_cast<std::size_t>(stored.offset),
+                           0});
+    }
+
+    // the driver copies straight out of the mapped pages
+    MeshBuffers buffers;
+    const auto *pVertexBytes = reinterpret_cast<const unsigned char *>(pVertices_);
+    buffers.vbo = OpenGLHelper::createBuffer(pVertexBytes + lod.baseVertex * pLayout_->stride,
+                                             static_cast<std::size_t>(lod.numVertices * pLayout_->stride));
+    buffers.vao = OpenGLHelper::createVao(buffers.vbo,
+                                          static_cast<GLsizei>(pLayout_->stride),
+                                          attribs.data(),
+                                          attribs.size());
+    buffers.vboSize = static_cast<int>(lod.numVertices);
+    buffers.bounds = getBox(); // covers every level
+
+    if (lod.numIndices > 0) {
+        const auto *pIndexBytes = reinterpret_cast<const unsigned char *>(pIndices_);
+        buffers.ibo = OpenGLHelper::createBuffer(pIndexBytes + lod.firstIndex * indexSize(),
+                                                 static_cast<std::size_t>(lod.numIndices * indexSize()),
+                                                 GL_ELEMENT_ARRAY_BUFFER);
+        buffers.iboSize = static_cast<int>(lod.numIndices);
+        buffers.iboType = getIndexType();
+    }
+    return buffers;
+}
+
+std::size_t MeshFile::indexSize() const
+{
+    return get_index_size(pHeader_->indexType);
+}
+
+template <typename Vertex>
+void write_mesh_file(const std::string &filename, const DrawData<Vertex> &data, GLenum drawMode)
+{
+    write_levels<Vertex>(filename, {{&data, 0.0f}}, drawMode);
+}
+
+void write_mesh_file(const std::string &filename, const std::vector<MeshLod> &lods)
+{
+    std::vector<LevelRef<PosNormTexVertex>> levels;
+    levels.reserve(lods.size());
+    for (const MeshLod &lod : lods) {
+        levels.push_back({&lod.data, lod.error});
+    }
+    write_levels(filename, levels, GL_TRIANGLES);
+}
+
+template void write_mesh_file(const std::string &filename, const PosNormTexData &data, GLenum drawMode);
+template void write_mesh_file(const std::string &filename, const PosData &data, GLenum drawMode);
+
+} // namespace sim
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <sim-driver/Bounds.hpp>
+#include <sim-driver/MappedFile.hpp>
+#include <sim-driver/OpenGLTypes.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <sim-driver/meshes/MeshSimplifier.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+/*
+ * Binary mesh file layout (little endian, every blob starts at a multiple of 64 bytes):
+ *
+ *   MeshFileHeader
+ *   MeshFileSection[numSections]
+ *   VertexLayout: MeshFileLayout followed by MeshFileAttrib[numAttribs]
+ *   Vertices:     raw vertex structs, 'stride' bytes each
+ *   Indices:      GLushort or GLuint indices (header.indexType)
+ *   Lods:         MeshFileLod[n] (optional, a single level covering everything otherwise)
+ *   Bounds:       MeshFileBounds of level 0 (optional)
+ *
+ * The blobs can be handed to the GPU straight from the mapped file.
+ */
+
+constexpr char mesh_file_magic[8] = {'S', 'I', 'M', 'M', 'E', 'S', 'H', '\0'};
+constexpr std::uint32_t mesh_file_version = 1;
+constexpr std::size_t mesh_file_alignment = 64;
+
+enum class MeshFileSectionType : std::uint32_t
+{
+    VertexLayout = 1,
+    Vertices = 2,
+    Indices = 3,
+    Lods = 4,
+    Bounds = 5,
+};
+
+struct MeshFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t numSections;
+    std::uint32_t drawMode;
+    std::uint32_t indexType; // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    std::uint64_t numVertices; // all levels
+    std::uint64_t numIndices; // all levels
+};
+
+struct MeshFileSection
+{
+    std::uint32_t type; // MeshFileSectionType
+    std::uint32_t reserved;
+    std::uint64_t offset; // bytes from the start of the file
+    std::uint64_t size; // bytes
+};
+
+struct MeshFileLayout
+{
+    std::uint32_t stride;
+    std::uint32_t numAttribs;
+};
+
+struct MeshFileAttrib
+{
+    std::uint32_t location;
+    std::int32_t size;
+    std::uint32_t type;
+    std::uint32_t normalized;
+    std::uint64_t offset;
+};
+
+/// Indices of a level are relative to its first vertex
+struct MeshFileLod
+{
+    std::uint64_t firstIndex;
+    std::uint64_t numIndices;
+    std::uint64_t baseVertex;
+    std::uint64_t numVertices;
+    float error; // see MeshLod
+    std::uint32_t reserved;
+};
+
+struct MeshFileBounds
+{
+    float lower[3];
+    float upper[3];
+    float center[3];
+    float radius;
+};
+
+static_assert(sizeof(MeshFileHeader) == 40, "MeshFileHeader must not contain padding");
+static_assert(sizeof(MeshFileSection) == 24, "MeshFileSection must not contain padding");
+static_assert(sizeof(MeshFileLayout) == 8, "MeshFileLayout must not contain padding");
+static_assert(sizeof(MeshFileAttrib) == 24, "MeshFileAttrib must not contain padding");
+static_assert(sizeof(MeshFileLod) == 40, "MeshFileLod must not contain padding");
+static_assert(sizeof(MeshFileBounds) == 40, "MeshFileBounds must not contain padding");
+
+/// A memory mapped mesh file. Nothing is parsed or copied: the accessors point into the
+/// mapping and createBuffers uploads directly from it.
+class MeshFile
+{
+public:
+    /// Maps and validates the file structure. Throws std::runtime_error if it is malformed.
+    /// The indices are uploaded as is, so files from untrusted sources should set 'verifyIndices'
+    /// to also reject indices past the vertices of their level (this reads every index).
+    explicit MeshFile(const std::string &filename, bool verifyIndices = false);
+
+    const MeshFileHeader &getHeader() const;
+    GLenum getDrawMode() const;
+    GLenum getIndexType() const;
+
+    const MeshFileLayout &getLayout() const;
+    const MeshFileAttrib *getAttribs() const;
+
+    /// Raw vertex and index blobs of all levels
+    const void *getVertexData() const;
+    const void *getIndexData() const;
+
+    std::size_t getNumLevels() const;
+    MeshFileLod getLevel(std::size_t level) const;
+
+    /// Returns nullptr if the file has no bounds section
+    const MeshFileBounds *getBounds() const;
+    AABB getBox() const;
+
+    /// True if the stored layout matches VertexFormat<Vertex>
+    template <typename Vertex>
+    bool hasLayout() const;
+
+    /// View of one level without copying. Throws if the layout doesn't match 'Vertex'
+    /// or the indices are 16 bit.
+    template <typename Vertex>
+    DrawDataView<Vertex> getDataView(std::size_t level = 0) const;
+
+    /// Uploads one level from the mapped pages and builds a vao from the stored layout
+    MeshBuffers createBuffers(std::size_t level = 0) const;
+
+private:
+    MappedFile file_;
+    const MeshFileHeader *pHeader_{nullptr};
+    const MeshFileLayout *pLayout_{nullptr};
+    const MeshFileAttrib *pAttribs_{nullptr};
+    const char *pVertices_{nullptr};
+    const char *pIndices_{nullptr};
+    const MeshFileLod *pLods_{nullptr};
+    std::size_t numLods_{0};
+    const MeshFileBounds *pBounds_{nullptr};
+
+    std::size_t indexSize() const;
+};
+
+/// Writes 'data' as a single level mesh file. 'drawMode' is stored with it.
+template <typename Vertex>
+void write_mesh_file(const std::string &filename, const DrawData<Vertex> &data, GLenum drawMode);
+
+/// Writes every level of a LOD chain (see create_lod_chain) drawn with GL_TRIANGLES
+void write_mesh_file(const std::string &filename, const std::vector<MeshLod> &lods);
+
+template <typename Vertex>
+bool MeshFile::hasLayout() const
+{
+    constexpr auto attribs = VertexFormat<Vertex>::attributes();
+
+    if (pLayout_->stride != sizeof(Vertex) || pLayout_->numAttribs != attribs.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < attribs.size(); ++i) {
+        const MeshFileAttrib &stored = pAttribs_[i];
+        if (stored.location != attribs[i].location || stored.size != attribs[i].size || stored.type != attribs[i].type
+            || stored.normalized != attribs[i].normalized || stored.offset != attribs[i].offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Vertex>
+DrawDataView<Vertex> MeshFile::getDataView(std::size_t level) const
+{
+    if (!hasLayout<Vertex>()) {
+        throw std::runtime_error("Mesh file vertex layout doesn't match the requested vertex type");
+    }
+    if (getIndexType() != GL_UNSIGNED_INT) {
+        throw std::runtime_error("Mesh file views require 32 bit indices");
+    }
+    MeshFileLod lod = getLevel(level);
+    return {reinterpret_cast<const Vertex *>(pVertices_) + lod.baseVertex,
+            static_cast<std::size_t>(lod.numVertices),
+            reinterpret_cast<const unsigned *>(pIndices_) + lod.firstIndex,
+            static_cast<std::size_t>(lod.numIndices)};
+}
+
+} // namespace sim
@@ -1,63 +1,41 @@
-#include <sim-driver/meshes/MeshHelper.hpp>
-#include <glm/gtc/constants.hpp>
+#include <sim-driver/meshes/MeshFunctions.hpp>
 
 namespace sim {
 
 template <typename V>
-V create_sphere_vertex(glm::vec3 p, glm::vec2 t);
-
-template <>
-sim::PosNormTexVertex create_sphere_vertex(glm::vec3 p, glm::vec2 t)
+sim::DrawData<V> create_sphere_mesh_data(int u_divisions, int v_divisions)
 {
-    return {{p.x, p.y, p.z}, {p.x, p.y, p.z}, {t.x, t.y}};
+    return create_parametric_mesh_data<V>(SphereSurface{}, u_divisions, v_divisions);
 }
 
-template <>
-sim::PosVertex create_sphere_vertex(glm::vec3 p, glm::vec2)
+template <typename V>
+sim::DrawData<V> create_torus_mesh_data(int u_divisions, int v_divisions)
 {
-    return {{p.x, p.y, p.z}};
+    return create_parametric_mesh_data<V>(TorusSurface{}, u_divisions, v_divisions);
 }
 
 template <typename V>
-sim::DrawData<V> create_sphere_mesh_data(int u_divisions, int v_divisions)
+sim::DrawData<V> create_plane_mesh_data(int u_divisions, int v_divisions)
 {
-    sim::DrawData<V> data{};
-
-    data.vbo.reserve(static_cast<unsigned>((u_divisions + 2) * (v_divisions + 2)));
-
-    for (int thetai = 0; thetai < (u_divisions + 2); ++thetai) {
-        float u = float(thetai) / (u_divisions + 1);
-        float theta = glm::two_pi<float>() * u;
-
-        for (int phii = 0; phii < (v_divisions + 2); ++phii) {
-            float v = float(phii) / (v_divisions + 1);
-            float phi = glm::pi<float>() * v;
-            glm::vec3 p{glm::cos(theta) * glm::sin(phi), glm::cos(phi), glm::sin(theta) * glm::sin(phi)};
-            data.vbo.emplace_back(create_sphere_vertex<V>(p, glm::vec2{1.0f - u, v}));
-        }
-    }
-
-    assert(data.vbo.size() == data.vbo.capacity());
-
-    data.ibo.reserve(static_cast<unsigned>((u_divisions + 1) * ((v_divisions + 2) * 2 + 1)));
-
-    unsigned index = 0;
-    for (int thetai = 0; thetai < (u_divisions + 1); ++thetai) {
-        for (int phii = 0; phii < (v_divisions + 2); ++phii) {
-            data.ibo.push_back(index);
-            data.ibo.push_back(index + v_divisions + 2);
-            ++index;
-        }
-        data.ibo.push_back(sim::primitiveRestart());
-    }
-
-    assert(data.ibo.size() == data.ibo.capacity());
+    return create_parametric_mesh_data<V>(PlaneSurface{}, u_divisions, v_divisions);
+}
 
-    data.vaoElements = sim::posNormTexVaoElements();
-    return data;
+template <typename V>
+sim::DrawData<V> create_cylinder_mesh_data(int u_divisions, int v_divisions)
+{
+    return create_parametric_mesh_data<V>(CylinderSurface{}, u_divisions, v_divisions);
 }
 
 template sim::PosNormTexData create_sphere_mesh_data(int u_divisions, int v_divisions);
 template sim::PosData create_sphere_mesh_data(int u_divisions, int v_divisions);
 
+template sim::PosNormTexData create_torus_mesh_data(int u_divisions, int v_divisions);
+template sim::PosData create_torus_mesh_data(int u_divisions, int v_divisions);
+
+template sim::PosNormTexData create_plane_mesh_data(int u_divisions, int v_divisions);
+template sim::PosData create_plane_mesh_data(int u_divisions, int v_divisions);
+
+template sim::PosNormTexData create_cylinder_mesh_data(int u_divisions, int v_divisions);
+template sim::PosData create_cylinder_mesh_data(int u_divisions, int v_divisions);
+
 } // namespace sim
@@ -1,10 +1,84 @@
 #pragma once
 
 #include <sim-driver/meshes/MeshHelper.hpp>
+#include <sim-driver/meshes/ParametricSurface.hpp>
+#include <glm/gtc/constants.hpp>
 
 namespace sim {
 
+/// Unit sphere around the y axis (u = longitude, v = latitude from the north pole)
+struct SphereSurface
+{
+    double uRange() const { return glm::two_pi<double>(); }
+    double vRange() const { return glm::pi<double>(); }
+
+    void operator()(const SurfaceParam &u, const SurfaceParam &v, SurfacePoint *pPoint) const
+    {
+        pPoint->position = {u.cos * v.sin, v.cos, u.sin * v.sin};
+        pPoint->normal = pPoint->position;
+        pPoint->texCoords = {1.0f - u.t, v.t};
+    }
+};
+
+/// Torus around the y axis
+struct TorusSurface
+{
+    float majorRadius{1.0f};
+    float minorRadius{0.35f};
+
+    double uRange() const { return glm::two_pi<double>(); }
+    double vRange() const { return glm::two_pi<double>(); }
+
+    void operator()(const SurfaceParam &u, const SurfaceParam &v, SurfacePoint *pPoint) const
+    {
+        // the tube is traversed so that dp/du x dp/dv points outwards
+        pPoint->normal = {v.cos * u.cos, -v.sin, v.cos * u.sin};
+        pPoint->position = majorRadius * glm::vec3{u.cos, 0.0f, u.sin} + minorRadius * pPoint->normal;
+        pPoint->texCoords = {1.0f - u.t, v.t};
+    }
+};
+
+/// [-1, 1] square in the xz plane facing +y
+struct PlaneSurface
+{
+    double uRange() const { return 1.0; }
+    double vRange() const { return 1.0; }
+
+    void operator()(const SurfaceParam &u, const SurfaceParam &v, SurfacePoint *pPoint) const
+    {
+        pPoint->position = {u.t * 2.0f - 1.0f, 0.0f, 1.0f - v.t * 2.0f};
+        pPoint->normal = {0.0f, 1.0f, 0.0f};
+        pPoint->texCoords = {u.t, v.t};
+    }
+};
+
+/// Open cylinder around the y axis from y = -height / 2 to height / 2
+struct CylinderSurface
+{
+    float radius{1.0f};
+    float height{2.0f};
+
+    double uRange() const { return glm::two_pi<double>(); }
+    double vRange() const { return 1.0; }
+
+    void operator()(const SurfaceParam &u, const SurfaceParam &v, SurfacePoint *pPoint) const
+    {
+        pPoint->normal = {u.cos, 0.0f, u.sin};
+        pPoint->position = radius * pPoint->normal + glm::vec3{0.0f, (0.5f - v.t) * height, 0.0f};
+        pPoint->texCoords = {1.0f - u.t, v.t};
+    }
+};
+
 template <typename V>
 sim::DrawData<V> create_sphere_mesh_data(int u_divisions, int v_divisions);
 
+template <typename V>
+sim::DrawData<V> create_torus_mesh_data(int u_divisions, int v_divisions);
+
+template <typename V>
+sim::DrawData<V> create_plane_mesh_data(int u_divisions, int v_divisions);
+
+template <typename V>
+sim::DrawData<V> create_cylinder_mesh_data(int u_divisions, int v_divisions);
+
 } // namespace sim
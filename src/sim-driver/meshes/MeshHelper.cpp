@@ -2,19 +2,92 @@
 #include <sim-driver/OpenGLHelper.hpp>
 #include <sim-driver/renderers/RendererHelper.hpp>
 #include <imgui.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <iostream>
 
 namespace sim {
+
+namespace {
+
+/// Plain functions are identified by their address so every MeshHelper using the same
+/// generator shares cache entries. Anything else (lambdas, bound functions) gets a unique id.
 template <typename V>
-MeshHelper<V>::MeshHelper(MeshDataFun dataFun) : dataFun_{std::move(dataFun)}
+MeshKey make_generator_key(const typename MeshHelper<V>::MeshDataFun &dataFun)
 {
-    updateData();
+    using GeneratorPtr = sim::DrawData<V> (*)(int, int);
+    static std::atomic<std::uint64_t> next_instance{1};
+
+    if (const GeneratorPtr *pFunction = dataFun.template target<GeneratorPtr>()) {
+        return {reinterpret_cast<std::uintptr_t>(*pFunction), 0, 0, 0, 0};
+    }
+    return {0, next_instance++, 0, 0, 0};
+}
+
+constexpr std::size_t max_optimization_stats = 256;
+
+/// Stats of recently optimized meshes. Shared by every MeshHelper because cached meshes are too.
+class OptimizationLog
+{
+public:
+    void record(const MeshKey &key, const MeshOptimizationStats &stats)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (stats_.find(key) == stats_.end()) {
+            order_.push_back(key);
+        }
+        stats_[key] = stats;
+
+        if (order_.size() > max_optimization_stats) {
+            stats_.erase(order_.front());
+            order_.pop_front();
+        }
+    }
+
+    bool find(const MeshKey &key, MeshOptimizationStats *pStats) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto iter = stats_.find(key);
+        if (iter == stats_.end()) {
+            return false;
+        }
+        *pStats = iter->second;
+        return true;
+    }
+
+private:
+    mutable std::mutex mutex_; // written by generator threads
+    std::unordered_map<MeshKey, MeshOptimizationStats, MeshKeyHash> stats_;
+    std::deque<MeshKey> order_; // oldest first
+};
+
+OptimizationLog &optimization_log()
+{
+    static OptimizationLog log;
+    return log;
+}
+
+} // namespace
+
+template <typename V>
+MeshHelper<V>::MeshHelper(MeshDataFun dataFun)
+    : spData_{std::make_shared<const sim::DrawData<V>>()}
+{
+    setMeshDataFunction(std::move(dataFun));
 }
 
 template <typename V>
 void MeshHelper<V>::setMeshDataFunction(MeshDataFun dataFun)
 {
     dataFun_ = std::move(dataFun);
+    generatorKey_ = make_generator_key<V>(dataFun_);
+
+    resetGenerator();
     updateData();
 }
 
@@ -34,7 +107,30 @@ bool MeshHelper<V>::configureGui()
     }
 
     if (mesh_needs_update) {
-        updateData();
+        mesh_needs_update = updateData();
+    }
+    mesh_needs_update |= pollData();
+
+    bool async = isAsync();
+    if (ImGui::Checkbox("Generate in Background", &async)) {
+        setAsync(async);
+    }
+
+    bool optimize = optimizeIndices_;
+    if (ImGui::Checkbox("Optimize Indices", &optimize)) {
+        mesh_needs_update |= setIndexOptimization(optimize, generatedDrawMode_);
+    }
+
+    MeshOptimizationStats stats;
+    if (getOptimizationStats(&stats)) {
+        ImGui::Text("ACMR: %.3f -> %.3f (%d triangles)",
+                    static_cast<double>(stats.acmrBefore),
+                    static_cast<double>(stats.acmrAfter),
+                    static_cast<int>(stats.numTriangles));
+    }
+
+    if (isGenerating()) {
+        ImGui::Text("Generating...");
     }
 
     return mesh_needs_update;
@@ -43,14 +139,217 @@ bool MeshHelper<V>::configureGui()
 template <typename V>
 const sim::DrawData<V> &MeshHelper<V>::getMeshData() const
 {
-    return data_;
+    return *spData_;
+}
+
+template <typename V>
+std::shared_ptr<const sim::DrawData<V>> MeshHelper<V>::getSharedMeshData() const
+{
+    return spData_;
 }
 
 template <typename V>
-void MeshHelper<V>::updateData()
+bool MeshHelper<V>::setDivisions(int uDivisions, int vDivisions)
 {
-    if (dataFun_) {
-        data_ = dataFun_(uDivisions_, vDivisions_);
+    uDivisions_ = uDivisions;
+    vDivisions_ = vDivisions;
+    return updateData();
+}
+
+template <typename V>
+bool MeshHelper<V>::updateData()
+{
+    if (!dataFun_) {
+        return false;
+    }
+
+    MeshKey key = makeKey(uDivisions_, vDivisions_);
+
+    if (spCache_) {
+        if (std::shared_ptr<const sim::DrawData<V>> spCached = spCache_->findData(key)) {
+            spData_ = std::move(spCached);
+            dataKey_ = key;
+
+            // otherwise the next poll would swap an older resolution back in
+            if (upGenerator_) {
+                upGenerator_->cancel();
+            }
+            return true;
+        }
+    }
+
+    if (upGenerator_) {
+        upGenerator_->submit(key);
+        return false;
+    }
+
+    spData_ = std::make_shared<const sim::DrawData<V>>(generateFun_(uDivisions_, vDivisions_));
+    dataKey_ = key;
+
+    if (spCache_) {
+        spCache_->insert(key, spData_);
+    }
+    return true;
+}
+
+template <typename V>
+bool MeshHelper<V>::pollData()
+{
+    MeshKey key{0, 0, 0, 0, 0};
+    std::shared_ptr<const sim::DrawData<V>> spData;
+
+    if (!upGenerator_ || !upGenerator_->poll(&key, &spData)) {
+        return false;
+    }
+
+    spData_ = std::move(spData);
+    dataKey_ = key;
+
+    if (spCache_) {
+        spCache_->insert(key, spData_);
+    }
+    return true;
+}
+
+template <typename V>
+void MeshHelper<V>::setAsync(bool async)
+{
+    if (async && !upGenerator_) {
+        upGenerator_ = std::make_unique<AsyncMeshGenerator<V>>(dataFun_, processFun_);
+    } else if (!async) {
+        upGenerator_ = nullptr;
+    }
+}
+
+template <typename V>
+bool MeshHelper<V>::isAsync() const
+{
+    return upGenerator_ != nullptr;
+}
+
+template <typename V>
+bool MeshHelper<V>::isGenerating() const
+{
+    return upGenerator_ && upGenerator_->isBusy();
+}
+
+template <typename V>
+void MeshHelper<V>::setCache(std::shared_ptr<MeshCache<V>> spCache)
+{
+    spCache_ = std::move(spCache);
+}
+
+template <typename V>
+MeshKey MeshHelper<V>::getMeshKey() const
+{
+    return dataKey_;
+}
+
+template <typename V>
+bool MeshHelper<V>::setIndexOptimization(bool optimize, GLenum drawMode)
+{
+    if (optimize == optimizeIndices_ && drawMode == generatedDrawMode_) {
+        return false;
+    }
+    optimizeIndices_ = optimize;
+    generatedDrawMode_ = drawMode;
+
+    resetGenerator();
+    return updateData();
+}
+
+template <typename V>
+bool MeshHelper<V>::isOptimizingIndices() const
+{
+    return optimizeIndices_;
+}
+
+template <typename V>
+GLenum MeshHelper<V>::getDrawMode() const
+{
+    return getDrawMode(dataKey_);
+}
+
+template <typename V>
+MeshKey MeshHelper<V>::makeKey(int uDivisions, int vDivisions) const
+{
+    MeshKey key = generatorKey_;
+    key.uDivisions = uDivisions;
+    key.vDivisions = vDivisions;
+    key.variant = optimizeIndices_ ? 1 : 0;
+    return key;
+}
+
+template <typename V>
+std::shared_ptr<const sim::DrawData<V>> MeshHelper<V>::generateData(const MeshKey &key)
+{
+    if (!generateFun_) {
+        return std::make_shared<const sim::DrawData<V>>();
+    }
+
+    if (spCache_) {
+        if (std::shared_ptr<const sim::DrawData<V>> spCached = spCache_->findData(key)) {
+            return spCached;
+        }
+    }
+
+    auto spData = std::make_shared<const sim::DrawData<V>>(generateFun_(key.uDivisions, key.vDivisions));
+
+    if (spCache_) {
+        spCache_->insert(key, spData);
+    }
+    return spData;
+}
+
+template <typename V>
+typename MeshHelper<V>::MeshDataFun MeshHelper<V>::getGenerateFunction() const
+{
+    return generateFun_;
+}
+
+template <typename V>
+GLenum MeshHelper<V>::getDrawMode(const MeshKey &key) const
+{
+    return key.variant == 1 ? GL_TRIANGLES : generatedDrawMode_;
+}
+
+template <typename V>
+bool MeshHelper<V>::getOptimizationStats(MeshOptimizationStats *pStats) const
+{
+    return optimization_log().find(dataKey_, pStats);
+}
+
+template <typename V>
+void MeshHelper<V>::resetGenerator()
+{
+    if (dataFun_ && optimizeIndices_) {
+        // captures copies only so it can safely run on the generator thread
+        GLenum drawMode = generatedDrawMode_;
+
+        processFun_ = [drawMode](const MeshKey &key, sim::DrawData<V> *pData) {
+            optimization_log().record(key, sim::optimize_mesh(pData, drawMode));
+        };
+
+        MeshDataFun dataFun = dataFun_;
+        MeshProcessFun processFun = processFun_;
+        MeshKey key = makeKey(0, 0);
+
+        generateFun_ = [dataFun, processFun, key](int u, int v) {
+            sim::DrawData<V> data = dataFun(u, v);
+
+            MeshKey dataKey = key;
+            dataKey.uDivisions = u;
+            dataKey.vDivisions = v;
+            processFun(dataKey, &data);
+            return data;
+        };
+    } else {
+        processFun_ = nullptr;
+        generateFun_ = dataFun_;
+    }
+
+    if (upGenerator_) {
+        upGenerator_ = std::make_unique<AsyncMeshGenerator<V>>(dataFun_, processFun_);
     }
 }
 
@@ -2,6 +2,9 @@
 
 #include <sim-driver/OpenGLHelper.hpp>
 #include <sim-driver/renderers/RendererHelper.hpp>
+#include <sim-driver/meshes/MeshCache.hpp>
+#include <sim-driver/meshes/AsyncMeshGenerator.hpp>
+#include <sim-driver/meshes/MeshOptimizer.hpp>
 
 namespace sim {
 
@@ -10,6 +13,7 @@ class MeshHelper
 {
 public:
     using MeshDataFun = std::function<sim::DrawData<V>(int, int)>;
+    using MeshProcessFun = typename AsyncMeshGenerator<V>::MeshProcessFun;
 
     explicit MeshHelper(MeshDataFun dataFun = nullptr);
 
@@ -19,14 +23,75 @@ public:
 
     const sim::DrawData<V> &getMeshData() const;
 
-    void updateData();
+    /// The current mesh data kept alive for as long as the caller needs it (e.g. on another thread)
+    std::shared_ptr<const sim::DrawData<V>> getSharedMeshData() const;
+
+    /// Changes the generated resolution. Returns true if the mesh data changed (see updateData).
+    bool setDivisions(int uDivisions, int vDivisions);
+
+    /// Returns true if the mesh data changed. In async mode uncached meshes are
+    /// generated in the background and swapped in by a later call to pollData.
+    bool updateData();
+
+    /// Swaps in a finished background mesh. Returns true if the mesh data changed.
+    bool pollData();
+
+    /// Generate meshes on a worker thread while the previous mesh stays available
+    void setAsync(bool async);
+    bool isAsync() const;
+    bool isGenerating() const;
+
+    /// Generated meshes are looked up in and added to 'spCache' (nullptr disables caching)
+    void setCache(std::shared_ptr<MeshCache<V>> spCache);
+
+    /// Identifies the generator and resolution of the current mesh data
+    MeshKey getMeshKey() const;
+
+    /// Reorders the generated indices for the vertex cache and overdraw (see MeshOptimizer.hpp).
+    /// 'drawMode' is the primitive type produced by the generator. Optimized meshes are
+    /// always triangle lists. Returns true if the mesh data changed.
+    bool setIndexOptimization(bool optimize, GLenum drawMode = GL_TRIANGLE_STRIP);
+    bool isOptimizingIndices() const;
+
+    /// Primitive type of the current mesh data
+    GLenum getDrawMode() const;
+
+    /// Key of the mesh the current generator and settings produce at 'uDivisions' x 'vDivisions'
+    MeshKey makeKey(int uDivisions, int vDivisions) const;
+
+    /// Synchronously generates (or fetches from the cache) the mesh for a key from makeKey.
+    /// The current mesh data isn't changed.
+    std::shared_ptr<const sim::DrawData<V>> generateData(const MeshKey &key);
+
+    /// The generator including the post-processing of makeKey's keys. Unlike generateData it
+    /// doesn't touch the cache so it can be called from other threads.
+    MeshDataFun getGenerateFunction() const;
+
+    /// Primitive type of the mesh data for 'key'
+    GLenum getDrawMode(const MeshKey &key) const;
+
+    /// Returns false if the current mesh data wasn't optimized (or its stats were dropped after
+    /// a few hundred newer meshes). Meshes found in a cache report the stats recorded when they
+    /// were generated, even by another MeshHelper.
+    bool getOptimizationStats(MeshOptimizationStats *pStats) const;
 
 private:
-    sim::DrawData<V> data_;
+    std::shared_ptr<const sim::DrawData<V>> spData_;
+    MeshKey dataKey_{0, 0, 0, 0, 0};
     MeshDataFun dataFun_;
+    MeshDataFun generateFun_; // dataFun_ followed by processFun_
+    MeshProcessFun processFun_; // post-processing of generated meshes, if any
+    std::shared_ptr<MeshCache<V>> spCache_{nullptr};
+    MeshKey generatorKey_{0, 0, 0, 0, 0};
+    std::unique_ptr<AsyncMeshGenerator<V>> upGenerator_{nullptr}; // only set in async mode
+
+    bool optimizeIndices_{false};
+    GLenum generatedDrawMode_{GL_TRIANGLE_STRIP};
 
     bool linkDivisions_{false};
     int uDivisions_{100}, vDivisions_{100};
+
+    void resetGenerator();
 };
 
 using PosNormTexMesh = MeshHelper<sim::PosNormTexVertex>;
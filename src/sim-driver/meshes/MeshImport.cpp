@@ -0,0 +1,990 @@
+#include <sim-driver/meshes/MeshImport.hpp>
+#include <sim-driver/meshes/MeshNormals.hpp>
+#include <sim-driver/MappedFile.hpp>
+#include <sim-driver/ParallelFor.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace sim {
+
+namespace {
+
+constexpr double powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+bool is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+const char *skip_blanks(const char *p, const char *pEnd)
+{
+    while (p < pEnd && is_blank(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+/// Points at the '\n' ending the line starting at 'p' or at 'pEnd' for the last line
+const char *find_line_end(const char *p, const char *pEnd)
+{
+    const void *pNewline = std::memchr(p, '\n', static_cast<std::size_t>(pEnd - p));
+    return pNewline ? static_cast<const char *>(pNewline) : pEnd;
+}
+
+const char *next_line(const char *pLineEnd, const char *pEnd)
+{
+    return pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+}
+
+template <typename Fn>
+void for_each_line(const char *pBegin, const char *pEnd, const Fn &fn)
+{
+    for (const char *p = pBegin; p < pEnd;) {
+        const char *pLineEnd = find_line_end(p, pEnd);
+        fn(p, pLineEnd);
+        p = next_line(pLineEnd, pEnd);
+    }
+}
+
+bool parse_long(const char *&p, const char *pEnd, long *pValue)
+{
+    const char *q = skip_blanks(p, pEnd);
+    bool negative = false;
+    if (q < pEnd && (*q == '-' || *q == '+')) {
+        negative = *q == '-';
+        ++q;
+    }
+    if (q == pEnd || !is_digit(*q)) {
+        return false;
+    }
+
+    long value = 0;
+    for (; q < pEnd && is_digit(*q); ++q) {
+        value = value * 10 + (*q - '0');
+    }
+    *pValue = negative ? -value : value;
+    p = q;
+    return true;
+}
+
+/// Falls back to strtof for the rare spellings the fast path doesn't handle (inf, nan)
+bool parse_special_float(const char *&p, const char *pEnd, float *pValue)
+{
+    const char *q = skip_blanks(p, pEnd);
+    char token[64];
+    std::size_t length = 0;
+    while (q + length < pEnd && length + 1 < sizeof(token) && !is_blank(q[length]) && q[length] != '\n') {
+        token[length] = q[length];
+        ++length;
+    }
+    token[length] = '\0';
+
+    char *pParsed = nullptr;
+    float value = std::strtof(token, &pParsed);
+    if (pParsed == token) {
+        return false;
+    }
+    *pValue = value;
+    p = q + (pParsed - token);
+    return true;
+}
+
+/// Starts at the beginning of a line and ends after a '\n' (or at the end of the data)
+struct TextChunk
+{
+    const char *pBegin;
+    const char *pEnd;
+};
+
+std::vector<TextChunk> split_lines(const char *pData, std::size_t size, std::size_t minChunkBytes)
+{
+    const std::size_t maxChunks = std::max(1u, std::thread::hardware_concurrency()) * 4u;
+    const std::size_t maxUsefulChunks = size / std::max<std::size_t>(1, minChunkBytes);
+    const std::size_t numChunks = std::max<std::size_t>(1, std::min(maxChunks, maxUsefulChunks));
+    const char *pEnd = pData + size;
+
+    std::vector<TextChunk> chunks;
+    chunks.reserve(numChunks);
+
+    const char *pBegin = pData;
+    for (std::size_t c = 1; c <= numChunks; ++c) {
+        const char *pSplit = pEnd;
+        if (c < numChunks) {
+            pSplit = std::max(pBegin, pData + size * c / numChunks);
+            pSplit = next_line(find_line_end(pSplit, pEnd), pEnd);
+        }
+        if (pSplit > pBegin) {
+            chunks.push_back({pBegin, pSplit});
+        }
+        pBegin = pSplit;
+    }
+    return chunks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// OBJ
+////////////////////////////////////////////////////////////////////////////////
+
+enum class ObjStatement
+{
+    Position,
+    TexCoords,
+    Normal,
+    Face,
+    Other,
+};
+
+/// Identifies the statement of a line and moves 'p' past its keyword
+ObjStatement read_obj_statement(const char *&p, const char *pLineEnd)
+{
+    p = skip_blanks(p, pLineEnd);
+    auto keyword = [&p, pLineEnd](const char *word, std::size_t length) {
+        if (static_cast<std::size_t>(pLineEnd - p) < length || std::memcmp(p, word, length) != 0) {
+            return false;
+        }
+        if (p + length < pLineEnd && !is_blank(p[length])) {
+            return false;
+        }
+        p += length;
+        return true;
+    };
+
+    if (keyword("v", 1)) {
+        return ObjStatement::Position;
+    }
+    if (keyword("vt", 2)) {
+        return ObjStatement::TexCoords;
+    }
+    if (keyword("vn", 2)) {
+        return ObjStatement::Normal;
+    }
+    if (keyword("f", 1)) {
+        return ObjStatement::Face;
+    }
+    return ObjStatement::Other; // comments, groups, materials etc. are ignored
+}
+
+struct ObjCounts
+{
+    std::size_t positions{0};
+    std::size_t texCoords{0};
+    std::size_t normals{0};
+};
+
+struct ObjCorner
+{
+    int position;
+    int texCoords; // -1 if missing
+    int normal; // -1 if missing
+
+    bool operator==(const ObjCorner &other) const
+    {
+        return position == other.position && texCoords == other.texCoords && normal == other.normal;
+    }
+};
+
+struct ObjCornerHash
+{
+    std::size_t operator()(const ObjCorner &corner) const
+    {
+        std::uint64_t key = static_cast<std::uint32_t>(corner.position);
+        key = key * 0x9e3779b97f4a7c15ull + static_cast<std::uint32_t>(corner.texCoords);
+        key = key * 0x9e3779b97f4a7c15ull + static_cast<std::uint32_t>(corner.normal);
+        return static_cast<std::size_t>(key ^ (key >> 29u));
+    }
+};
+
+using ObjCornerMap = std::unordered_map<ObjCorner, unsigned, ObjCornerHash>;
+
+/// OBJ indices start at 1, negative ones count back from the last element read so far
+int resolve_obj_index(long index, std::size_t seen, std::size_t total)
+{
+    long resolved = index > 0 ? index - 1 : static_cast<long>(seen) + index;
+    if (index == 0 || resolved < 0 || resolved >= static_cast<long>(total)) {
+        throw std::runtime_error("OBJ face index " + std::to_string(index) + " is out of range");
+    }
+    return static_cast<int>(resolved);
+}
+
+/// Parses one 'v', 'v/vt', 'v//vn' or 'v/vt/vn' corner. Returns false at the end of the line.
+bool read_obj_corner(const char *&p,
+                     const char *pLineEnd,
+                     const ObjCounts &seen,
+                     const ObjCounts &total,
+                     ObjCorner *pCorner)
+{
+    p = skip_blanks(p, pLineEnd);
+    if (p == pLineEnd) {
+        return false;
+    }
+
+    long index;
+    *pCorner = {-1, -1, -1};
+
+    if (!parse_long(p, pLineEnd, &index)) {
+        throw std::runtime_error("Malformed OBJ face");
+    }
+    pCorner->position = resolve_obj_index(index, seen.positions, total.positions);
+
+    if (p < pLineEnd && *p == '/') {
+        ++p;
+        if (p < pLineEnd && *p != '/') {
+            if (!parse_long(p, pLineEnd, &index)) {
+                throw std::runtime_error("Malformed OBJ face");
+            }
+            pCorner->texCoords = resolve_obj_index(index, seen.texCoords, total.texCoords);
+        }
+        if (p < pLineEnd && *p == '/') {
+            ++p;
+            if (!parse_long(p, pLineEnd, &index)) {
+                throw std::runtime_error("Malformed OBJ face");
+            }
+            pCorner->normal = resolve_obj_index(index, seen.normals, total.normals);
+        }
+    }
+
+    if (p < pLineEnd && !is_blank(*p)) {
+        throw std::runtime_error("Malformed OBJ face");
+    }
+    return true;
+}
+
+void read_obj_floats(const char *&p, const char *pLineEnd, float *pValues, int numRequired, int numOptional)
+{
+    for (int i = 0; i < numRequired + numOptional; ++i) {
+        if (!parse_float(p, pLineEnd, pValues + i)) {
+            if (i < numRequired) {
+                throw std::runtime_error("Expected a number in OBJ statement");
+            }
+            pValues[i] = 0.0f;
+        }
+    }
+}
+
+struct ObjChunk
+{
+    ObjCounts counts; // statements in this chunk
+    ObjCounts offsets; // statements in all previous chunks
+    std::vector<ObjCorner> corners; // unique corners in order of first use
+    std::vector<unsigned> triangles; // indices into 'corners'
+    std::vector<unsigned> remap; // corners -> global vertex ids
+    std::size_t firstIndex{0}; // of this chunk's triangles in the merged index buffer
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// PLY
+////////////////////////////////////////////////////////////////////////////////
+
+enum class PlyFormat
+{
+    Ascii,
+    BinaryLittleEndian,
+};
+
+enum class PlyType
+{
+    Int8,
+    Uint8,
+    Int16,
+    Uint16,
+    Int32,
+    Uint32,
+    Float32,
+    Float64,
+};
+
+struct PlyProperty
+{
+    std::string name;
+    PlyType type;
+    bool isList;
+    PlyType countType; // only used for lists
+};
+
+struct PlyElement
+{
+    std::string name;
+    std::size_t count;
+    std::vector<PlyProperty> properties;
+};
+
+PlyType to_ply_type(const std::string &type)
+{
+    if (type == "char" || type == "int8") {
+        return PlyType::Int8;
+    }
+    if (type == "uchar" || type == "uint8") {
+        return PlyType::Uint8;
+    }
+    if (type == "short" || type == "int16") {
+        return PlyType::Int16;
+    }
+    if (type == "ushort" || type == "uint16") {
+        return PlyType::Uint16;
+    }
+    if (type == "int" || type == "int32") {
+        return PlyType::Int32;
+    }
+    if (type == "uint" || type == "uint32") {
+        return PlyType::Uint32;
+    }
+    if (type == "float" || type == "float32") {
+        return PlyType::Float32;
+    }
+    if (type == "double" || type == "float64") {
+        return PlyType::Float64;
+    }
+    throw std::runtime_error("Unknown PLY property type '" + type + "'");
+}
+
+std::size_t ply_type_size(PlyType type)
+{
+    switch (type) {
+    case PlyType::Int8:
+    case PlyType::Uint8:
+        return 1;
+    case PlyType::Int16:
+    case PlyType::Uint16:
+        return 2;
+    case PlyType::Int32:
+    case PlyType::Uint32:
+    case PlyType::Float32:
+        return 4;
+    case PlyType::Float64:
+        return 8;
+    }
+    return 0;
+}
+
+template <typename T>
+double read_binary(const char *p)
+{
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return static_cast<double>(value);
+}
+
+double read_ply_binary(PlyType type, const char *p)
+{
+    switch (type) {
+    case PlyType::Int8:
+        return read_binary<std::int8_t>(p);
+    case PlyType::Uint8:
+        return read_binary<std::uint8_t>(p);
+    case PlyType::Int16:
+        return read_binary<std::int16_t>(p);
+    case PlyType::Uint16:
+        return read_binary<std::uint16_t>(p);
+    case PlyType::Int32:
+        return read_binary<std::int32_t>(p);
+    case PlyType::Uint32:
+        return read_binary<std::uint32_t>(p);
+    case PlyType::Float32:
+        return read_binary<float>(p);
+    case PlyType::Float64:
+        return read_binary<double>(p);
+    }
+    return 0.0;
+}
+
+/// Reads one binary scalar and advances 'p'
+double read_ply_binary(PlyType type, const char *&p, const char *pEnd)
+{
+    std::size_t size = ply_type_size(type);
+    if (static_cast<std::size_t>(pEnd - p) < size) {
+        throw std::runtime_error("PLY file ends in the middle of an element");
+    }
+    double value = read_ply_binary(type, static_cast<const char *>(p));
+    p += size;
+    return value;
+}
+
+/// Bytes per element if it has no lists, 0 otherwise
+std::size_t ply_fixed_size(const PlyElement &element)
+{
+    std::size_t size = 0;
+    for (const PlyProperty &property : element.properties) {
+        if (property.isList) {
+            return 0;
+        }
+        size += ply_type_size(property.type);
+    }
+    return size;
+}
+
+/// Reads the properties of one ascii line into 'pValues' (lists into 'pList'). Values are
+/// indexed by property like the binary reads so lists leave a 0 in their slot.
+void read_ply_ascii_element(const PlyElement &element,
+                            const char *p,
+                            const char *pLineEnd,
+                            std::vector<float> *pValues,
+                            std::vector<unsigned> *pList)
+{
+    pValues->assign(element.properties.size(), 0.0f);
+    pList->clear();
+
+    for (std::size_t i = 0; i < element.properties.size(); ++i) {
+        const PlyProperty &property = element.properties[i];
+        if (property.isList) {
+            long count, index;
+            if (!parse_long(p, pLineEnd, &count)) {
+                throw std::runtime_error("Expected a list size in PLY element '" + element.name + "'");
+            }
+            for (long i = 0; i < count; ++i) {
+                if (!parse_long(p, pLineEnd, &index)) {
+                    throw std::runtime_error("PLY list is shorter than its size");
+                }
+                pList->push_back(static_cast<unsigned>(index));
+            }
+        } else {
+            float value;
+            if (!parse_float(p, pLineEnd, &value)) {
+                throw std::runtime_error("Expected a number in PLY element '" + element.name + "'");
+            }
+            (*pValues)[i] = value;
+        }
+    }
+}
+
+int find_ply_property(const PlyElement &element, std::initializer_list<const char *> names)
+{
+    for (const char *name : names) {
+        for (std::size_t i = 0; i < element.properties.size(); ++i) {
+            if (element.properties[i].name == name) {
+                return static_cast<int>(i);
+            }
+        }
+    }
+    return -1;
+}
+
+/// Property indices of the vertex attributes we import (-1 if missing)
+struct PlyVertexProperties
+{
+    int x, y, z;
+    int nx, ny, nz;
+    int s, t;
+
+    explicit PlyVertexProperties(const PlyElement &element)
+        : x{find_ply_property(element, {"x"})},
+          y{find_ply_property(element, {"y"})},
+          z{find_ply_property(element, {"z"})},
+          nx{find_ply_property(element, {"nx"})},
+          ny{find_ply_property(element, {"ny"})},
+          nz{find_ply_property(element, {"nz"})},
+          s{find_ply_property(element, {"s", "u", "texture_u"})},
+          t{find_ply_property(element, {"t", "v", "texture_v"})}
+    {
+        if (x < 0 || y < 0 || z < 0) {
+            throw std::runtime_error("PLY vertices need x, y and z properties");
+        }
+    }
+
+    bool hasNormals() const { return nx >= 0 && ny >= 0 && nz >= 0; }
+    bool hasTexCoords() const { return s >= 0 && t >= 0; }
+
+    /// 'value(i)' returns property i of the current vertex
+    template <typename Value>
+    sim::PosNormTexVertex makeVertex(const Value &value) const
+    {
+        sim::PosNormTexVertex vertex{};
+        vertex.position[0] = static_cast<float>(value(x));
+        vertex.position[1] = static_cast<float>(value(y));
+        vertex.position[2] = static_cast<float>(value(z));
+        if (hasNormals()) {
+            vertex.normal[0] = static_cast<float>(value(nx));
+            vertex.normal[1] = static_cast<float>(value(ny));
+            vertex.normal[2] = static_cast<float>(value(nz));
+        }
+        if (hasTexCoords()) {
+            vertex.texCoords[0] = static_cast<float>(value(s));
+            vertex.texCoords[1] = static_cast<float>(value(t));
+        }
+        return vertex;
+    }
+};
+
+/// Polygons are triangulated as fans
+void add_polygon(const std::vector<unsigned> &polygon, std::size_t numVertices, std::vector<unsigned> *pTriangles)
+{
+    for (unsigned index : polygon) {
+        if (index >= numVertices) {
+            throw std::runtime_error("PLY face index " + std::to_string(index) + " is out of range");
+        }
+    }
+    for (std::size_t k = 2; k < polygon.size(); ++k) {
+        pTriangles->insert(pTriangles->end(), {polygon[0], polygon[k - 1], polygon[k]});
+    }
+}
+
+std::string read_header_token(const char *&p, const char *pLineEnd)
+{
+    p = skip_blanks(p, pLineEnd);
+    const char *pStart = p;
+    while (p < pLineEnd && !is_blank(*p)) {
+        ++p;
+    }
+    return {pStart, p};
+}
+
+bool has_extension(const std::string &filename, const std::string &extension)
+{
+    if (filename.size() < extension.size()) {
+        return false;
+    }
+    return std::equal(extension.rbegin(), extension.rend(), filename.rbegin(), [](char lhs, char rhs) {
+        return std::tolower(static_cast<unsigned char>(lhs)) == std::tolower(static_cast<unsigned char>(rhs));
+    });
+}
+
+} // namespace
+
+bool parse_float(const char *&p, const char *pEnd, float *pValue)
+{
+    const char *q = skip_blanks(p, pEnd);
+    bool negative = false;
+    if (q < pEnd && (*q == '-' || *q == '+')) {
+        negative = *q == '-';
+        ++q;
+    }
+
+    // digits beyond what the 64 bit mantissa holds only shift the exponent
+    constexpr std::uint64_t max_mantissa = 1000000000000000000ull;
+    std::uint64_t mantissa = 0;
+    int exponent = 0;
+    int numDigits = 0;
+
+    for (; q < pEnd && is_digit(*q); ++q, ++numDigits) {
+        if (mantissa < max_mantissa) {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*q - '0');
+        } else {
+            ++exponent;
+        }
+    }
+    if (q < pEnd && *q == '.') {
+        for (++q; q < pEnd && is_digit(*q); ++q, ++numDigits) {
+            if (mantissa < max_mantissa) {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(*q - '0');
+                --exponent;
+            }
+        }
+    }
+    if (numDigits == 0) {
+        return parse_special_float(p, pEnd, pValue);
+    }
+
+    if (q < pEnd && (*q == 'e' || *q == 'E')) {
+        const char *pExponent = q + 1;
+        bool negativeExponent = false;
+        if (pExponent < pEnd && (*pExponent == '-' || *pExponent == '+')) {
+            negativeExponent = *pExponent == '-';
+            ++pExponent;
+        }
+        if (pExponent < pEnd && is_digit(*pExponent)) {
+            int value = 0;
+            for (; pExponent < pEnd && is_digit(*pExponent); ++pExponent) {
+                value = std::min(value * 10 + (*pExponent - '0'), 100000);
+            }
+            exponent += negativeExponent ? -value : value;
+            q = pExponent;
+        }
+    }
+
+    auto value = static_cast<double>(mantissa);
+    if (exponent < 0) {
+        value = exponent >= -22 ? value / powers_of_ten[-exponent] : value * std::pow(10.0, exponent);
+    } else if (exponent > 0) {
+        value = exponent <= 22 ? value * powers_of_ten[exponent] : value * std::pow(10.0, exponent);
+    }
+
+    *pValue = static_cast<float>(negative ? -value : value);
+    p = q;
+    return true;
+}
+
+sim::PosNormTexData import_mesh(const std::string &filename)
+{
+    sim::MappedFile file(filename);
+    file.adviseSequential();
+
+    if (has_extension(filename, ".obj")) {
+        return import_obj(file.data(), file.size());
+    }
+    if (has_extension(filename, ".ply")) {
+        return import_ply(file.data(), file.size());
+    }
+    throw std::runtime_error("Unsupported mesh file type: " + filename);
+}
+
+sim::PosNormTexData import_obj(const char *pData, std::size_t size, std::size_t minChunkBytes)
+{
+    std::vector<TextChunk> textChunks = split_lines(pData, size, minChunkBytes);
+    std::vector<ObjChunk> chunks(textChunks.size());
+
+    // count the statements of every chunk so each knows where its attributes go
+    sim::parallel_for(0, chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t c = begin; c < end; ++c) {
+            ObjCounts &counts = chunks[c].counts;
+            for_each_line(textChunks[c].pBegin, textChunks[c].pEnd, [&counts](const char *p, const char *pLineEnd) {
+                switch (read_obj_statement(p, pLineEnd)) {
+                case ObjStatement::Position:
+                    ++counts.positions;
+                    break;
+                case ObjStatement::TexCoords:
+                    ++counts.texCoords;
+                    break;
+                case ObjStatement::Normal:
+                    ++counts.normals;
+                    break;
+                default:
+                    break;
+                }
+            });
+        }
+    });
+
+    ObjCounts total;
+    for (ObjChunk &chunk : chunks) {
+        chunk.offsets = total;
+        total.positions += chunk.counts.positions;
+        total.texCoords += chunk.counts.texCoords;
+        total.normals += chunk.counts.normals;
+    }
+
+    std::vector<glm::vec3> positions(total.positions);
+    std::vector<glm::vec2> texCoords(total.texCoords);
+    std::vector<glm::vec3> normals(total.normals);
+
+    // parse the attributes into place and deduplicate the corners of each chunk
+    sim::parallel_for(0, chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+        ObjCornerMap cornerIds;
+        std::vector<unsigned> polygon;
+
+        for (std::size_t c = begin; c < end; ++c) {
+            ObjChunk &chunk = chunks[c];
+            ObjCounts seen = chunk.offsets;
+            cornerIds.clear();
+
+            for_each_line(textChunks[c].pBegin, textChunks[c].pEnd, [&](const char *p, const char *pLineEnd) {
+                switch (read_obj_statement(p, pLineEnd)) {
+                case ObjStatement::Position:
+                    read_obj_floats(p, pLineEnd, &positions[seen.positions++].x, 3, 0);
+                    break;
+
+                case ObjStatement::TexCoords:
+                    read_obj_floats(p, pLineEnd, &texCoords[seen.texCoords++].x, 1, 1);
+                    break;
+
+                case ObjStatement::Normal:
+                    read_obj_floats(p, pLineEnd, &normals[seen.normals++].x, 3, 0);
+                    break;
+
+                case ObjStatement::Face: {
+                    polygon.clear();
+                    ObjCorner corner;
+                    while (read_obj_corner(p, pLineEnd, seen, total, &corner)) {
+                        auto inserted = cornerIds.emplace(corner, static_cast<unsigned>(chunk.corners.size()));
+                        if (inserted.second) {
+                            chunk.corners.push_back(corner);
+                        }
+                        polygon.push_back(inserted.first->second);
+                    }
+                    for (std::size_t i = 2; i < polygon.size(); ++i) {
+                        chunk.triangles.insert(chunk.triangles.end(), {polygon[0], polygon[i - 1], polygon[i]});
+                    }
+                } break;
+
+                case ObjStatement::Other:
+                    break;
+                }
+            });
+        }
+    });
+
+    // merge the corners in chunk order so vertex ids match a sequential parse
+    ObjCornerMap vertexIds;
+    std::vector<ObjCorner> vertexCorners;
+    std::size_t numIndices = 0;
+    {
+        std::size_t numCorners = 0;
+        for (const ObjChunk &chunk : chunks) {
+            numCorners += chunk.corners.size();
+        }
+        vertexIds.reserve(numCorners);
+        vertexCorners.reserve(numCorners);
+    }
+
+    for (ObjChunk &chunk : chunks) {
+        chunk.remap.reserve(chunk.corners.size());
+        for (const ObjCorner &corner : chunk.corners) {
+            auto inserted = vertexIds.emplace(corner, static_cast<unsigned>(vertexCorners.size()));
+            if (inserted.second) {
+                vertexCorners.push_back(corner);
+            }
+            chunk.remap.push_back(inserted.first->second);
+        }
+        chunk.firstIndex = numIndices;
+        numIndices += chunk.triangles.size();
+    }
+
+    sim::PosNormTexData data;
+    data.vbo.resize(vertexCorners.size());
+    data.ibo.resize(numIndices);
+
+    sim::parallel_for(0, vertexCorners.size(), 4096, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t v = begin; v < end; ++v) {
+            const ObjCorner &corner = vertexCorners[v];
+            sim::PosNormTexVertex &vertex = data.vbo[v];
+            vertex = {};
+            std::copy(&positions[corner.position].x, &positions[corner.position].x + 3, vertex.position);
+            if (corner.normal >= 0) {
+                std::copy(&normals[corner.normal].x, &normals[corner.normal].x + 3, vertex.normal);
+            }
+            if (corner.texCoords >= 0) {
+                std::copy(&texCoords[corner.texCoords].x, &texCoords[corner.texCoords].x + 2, vertex.texCoords);
+            }
+        }
+    });
+
+    sim::parallel_for(0, chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t c = begin; c < end; ++c) {
+            const ObjChunk &chunk = chunks[c];
+            std::transform(chunk.triangles.begin(),
+                           chunk.triangles.end(),
+                           data.ibo.begin() + static_cast<std::ptrdiff_t>(chunk.firstIndex),
+                           [&chunk](unsigned corner) { return chunk.remap[corner]; });
+        }
+    });
+
+    if (total.normals == 0) {
+        sim::compute_normals(&data, GL_TRIANGLES);
+    }
+    return data;
+}
+
+sim::PosNormTexData import_ply(const char *pData, std::size_t size, std::size_t minChunkBytes)
+{
+    const char *pEnd = pData + size;
+    const char *p = pData;
+
+    PlyFormat format = PlyFormat::Ascii;
+    std::vector<PlyElement> elements;
+    bool isFirstLine = true;
+    bool foundEnd = false;
+
+    while (p < pEnd && !foundEnd) {
+        const char *pLineEnd = find_line_end(p, pEnd);
+        const char *q = p;
+        std::string keyword = read_header_token(q, pLineEnd);
+        p = next_line(pLineEnd, pEnd);
+
+        if (isFirstLine) {
+            if (keyword != "ply") {
+                throw std::runtime_error("Not a PLY file");
+            }
+            isFirstLine = false;
+
+        } else if (keyword == "end_header") {
+            foundEnd = true;
+
+        } else if (keyword == "format") {
+            std::string name = read_header_token(q, pLineEnd);
+            if (name == "ascii") {
+                format = PlyFormat::Ascii;
+            } else if (name == "binary_little_endian") {
+                format = PlyFormat::BinaryLittleEndian;
+            } else {
+                throw std::runtime_error("Unsupported PLY format '" + name + "'");
+            }
+
+        } else if (keyword == "element") {
+            std::string name = read_header_token(q, pLineEnd);
+            long count;
+            if (!parse_long(q, pLineEnd, &count) || count < 0) {
+                throw std::runtime_error("PLY element '" + name + "' has no valid count");
+            }
+            elements.push_back({name, static_cast<std::size_t>(count), {}});
+
+        } else if (keyword == "property") {
+            if (elements.empty()) {
+                throw std::runtime_error("PLY property outside of an element");
+            }
+            PlyProperty property{};
+            std::string type = read_header_token(q, pLineEnd);
+            if (type == "list") {
+                property.isList = true;
+                property.countType = to_ply_type(read_header_token(q, pLineEnd));
+                type = read_header_token(q, pLineEnd);
+            }
+            property.type = to_ply_type(type);
+            property.name = read_header_token(q, pLineEnd);
+            elements.back().properties.push_back(property);
+        }
+    }
+
+    if (isFirstLine) {
+        throw std::runtime_error("Not a PLY file");
+    }
+    if (!foundEnd) {
+        throw std::runtime_error("PLY header has no end_header");
+    }
+
+    auto vertexElement = std::find_if(elements.begin(), elements.end(), [](const PlyElement &element) {
+        return element.name == "vertex";
+    });
+    if (vertexElement == elements.end()) {
+        throw std::runtime_error("PLY file has no vertex element");
+    }
+    const PlyVertexProperties vertexProperties(*vertexElement);
+
+    sim::PosNormTexData data;
+    data.vbo.resize(vertexElement->count);
+    const std::size_t numVertices = data.vbo.size();
+
+    if (format == PlyFormat::Ascii) {
+        // every element is one line: count the lines of each chunk to know which elements it holds
+        std::vector<TextChunk> chunks = split_lines(p, static_cast<std::size_t>(pEnd - p), minChunkBytes);
+        std::vector<std::size_t> firstLine(chunks.size() + 1, 0);
+
+        sim::parallel_for(0, chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t c = begin; c < end; ++c) {
+                std::size_t &numLines = firstLine[c + 1];
+                for_each_line(chunks[c].pBegin, chunks[c].pEnd, [&numLines](const char *, const char *) {
+                    ++numLines;
+                });
+            }
+        });
+        for (std::size_t c = 0; c < chunks.size(); ++c) {
+            firstLine[c + 1] += firstLine[c];
+        }
+
+        std::vector<std::size_t> elementEnd;
+        std::size_t numLines = 0;
+        for (const PlyElement &element : elements) {
+            numLines += element.count;
+            elementEnd.push_back(numLines);
+        }
+        if (firstLine.back() < numLines) {
+            throw std::runtime_error("PLY file ends before all elements were read");
+        }
+
+        std::vector<std::vector<unsigned>> chunkTriangles(chunks.size());
+
+        sim::parallel_for(0, chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+            std::vector<float> values;
+            std::vector<unsigned> list;
+
+            for (std::size_t c = begin; c < end; ++c) {
+                std::size_t line = firstLine[c];
+                std::size_t e = 0;
+
+                for_each_line(chunks[c].pBegin, chunks[c].pEnd, [&](const char *pLine, const char *pLineEnd) {
+                    while (e < elements.size() && line >= elementEnd[e]) {
+                        ++e;
+                    }
+                    if (e < elements.size()) {
+                        const PlyElement &element = elements[e];
+                        const std::size_t index = line - (elementEnd[e] - element.count);
+
+                        if (&element == &*vertexElement) {
+                            read_ply_ascii_element(element, pLine, pLineEnd, &values, &list);
+                            data.vbo[index] = vertexProperties.makeVertex([&values](int i) { return values[i]; });
+                        } else if (element.name == "face") {
+                            read_ply_ascii_element(element, pLine, pLineEnd, &values, &list);
+                            add_polygon(list, numVertices, &chunkTriangles[c]);
+                        }
+                    }
+                    ++line;
+                });
+            }
+        });
+
+        for (const std::vector<unsigned> &triangles : chunkTriangles) {
+            data.ibo.insert(data.ibo.end(), triangles.begin(), triangles.end());
+        }
+
+    } else {
+        std::vector<unsigned> polygon;
+
+        for (const PlyElement &element : elements) {
+            const std::size_t fixedSize = ply_fixed_size(element);
+
+            if (&element == &*vertexElement) {
+                if (fixedSize == 0) {
+                    throw std::runtime_error("PLY vertices with list properties aren't supported");
+                }
+                if (static_cast<std::size_t>(pEnd - p) / fixedSize < element.count) {
+                    throw std::runtime_error("PLY file ends in the middle of an element");
+                }
+
+                std::vector<std::size_t> offsets;
+                std::size_t offset = 0;
+                for (const PlyProperty &property : element.properties) {
+                    offsets.push_back(offset);
+                    offset += ply_type_size(property.type);
+                }
+
+                // fixed size vertices can be read in parallel ranges
+                const char *pVertices = p;
+                const std::size_t minVertices = std::max<std::size_t>(1, minChunkBytes / fixedSize);
+
+                sim::parallel_for(0, element.count, minVertices, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t v = begin; v < end; ++v) {
+                        const char *pVertex = pVertices + v * fixedSize;
+                        data.vbo[v] = vertexProperties.makeVertex([&](int i) {
+                            return read_ply_binary(element.properties[i].type, pVertex + offsets[i]);
+                        });
+                    }
+                });
+                p += element.count * fixedSize;
+
+            } else if (fixedSize > 0 && element.name != "face") {
+                if (static_cast<std::size_t>(pEnd - p) / fixedSize < element.count) {
+                    throw std::runtime_error("PLY file ends in the middle of an element");
+                }
+                p += element.count * fixedSize;
+
+            } else {
+                // variable size elements have to be walked in order
+                const bool isFace = element.name == "face";
+                for (std::size_t i = 0; i < element.count; ++i) {
+                    for (const PlyProperty &property : element.properties) {
+                        if (!property.isList) {
+                            read_ply_binary(property.type, p, pEnd);
+                            continue;
+                        }
+                        auto count = static_cast<std::size_t>(read_ply_binary(property.countType, p, pEnd));
+                        polygon.resize(count);
+                        for (std::size_t k = 0; k < count; ++k) {
+                            polygon[k] = static_cast<unsigned>(read_ply_binary(property.type, p, pEnd));
+                        }
+                        if (isFace) {
+                            add_polygon(polygon, numVertices, &data.ibo);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (!vertexProperties.hasNormals()) {
+        sim::compute_normals(&data, GL_TRIANGLES);
+    }
+    return data;
+}
+
+} // namespace sim
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <sim-driver/OpenGLTypes.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <string>
+
+namespace sim {
+
+/// Files are split at line boundaries into chunks of at least this many bytes that are parsed concurrently
+constexpr std::size_t default_import_chunk_bytes = 1u << 20u;
+
+/// Imports a Wavefront OBJ or PLY file (chosen by extension) as a GL_TRIANGLES mesh.
+/// The file is memory mapped and parsed in parallel chunks.
+/// Throws std::runtime_error if the file can't be read or parsed.
+sim::PosNormTexData import_mesh(const std::string &filename);
+
+/// Parses the v, vt, vn and f statements of an OBJ file. Polygons are triangulated as fans
+/// and each unique position/texture/normal combination becomes one vertex (numbered in order
+/// of first use, independent of the chunking). Area weighted normals are computed if the
+/// file has none.
+sim::PosNormTexData import_obj(const char *pData,
+                               std::size_t size,
+                               std::size_t minChunkBytes = default_import_chunk_bytes);
+
+/// Parses ascii and binary_little_endian PLY files with a 'vertex' element (x, y, z and
+/// optionally nx, ny, nz and s, t or u, v) and a 'face' element with a vertex index list.
+/// Ascii files are parsed in parallel chunks and binary vertices in parallel ranges.
+sim::PosNormTexData import_ply(const char *pData,
+                               std::size_t size,
+                               std::size_t minChunkBytes = default_import_chunk_bytes);
+
+/// Locale independent decimal parser used by the importers. Skips leading spaces and tabs,
+/// returns false (leaving 'p' unchanged) if no number starts there.
+bool parse_float(const char *&p, const char *pEnd, float *pValue);
+
+} // namespace sim
@@ -0,0 +1,210 @@
+#include <sim-driver/meshes/MeshNormals.hpp>
+#include <sim-driver/meshes/MeshOptimizer.hpp>
+#include <sim-driver/ParallelFor.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace sim {
+
+namespace {
+
+constexpr std::size_t min_parallel_elements = 4096;
+
+glm::vec3 position_of(const sim::PosNormTexVertex &vertex)
+{
+    return {vertex.position[0], vertex.position[1], vertex.position[2]};
+}
+
+glm::vec3 normal_of(const sim::PosNormTexVertex &vertex)
+{
+    return {vertex.normal[0], vertex.normal[1], vertex.normal[2]};
+}
+
+glm::vec2 tex_coords_of(const sim::PosNormTexVertex &vertex)
+{
+    return {vertex.texCoords[0], vertex.texCoords[1]};
+}
+
+/// Robust for nearly parallel edges (unlike acos of the normalized dot product)
+float angle_between(const glm::vec3 &a, const glm::vec3 &b)
+{
+    return std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b));
+}
+
+glm::vec3 normalize_or_zero(const glm::vec3 &v)
+{
+    float length = glm::length(v);
+    return length > 0.0f ? v / length : glm::vec3(0.0f);
+}
+
+/// Component of 'v' perpendicular to the unit vector 'normal'
+glm::vec3 project_to_plane(const glm::vec3 &v, const glm::vec3 &normal)
+{
+    return v - normal * glm::dot(normal, v);
+}
+
+/// Any unit vector perpendicular to 'normal' for vertices without usable texture coordinates
+glm::vec3 any_perpendicular(const glm::vec3 &normal)
+{
+    glm::vec3 axis = std::abs(normal.x) < 0.9f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+    glm::vec3 tangent = normalize_or_zero(project_to_plane(axis, normal));
+    return tangent == glm::vec3(0.0f) ? glm::vec3(1, 0, 0) : tangent;
+}
+
+} // namespace
+
+NormalKernel::NormalKernel(const unsigned *pIndices, std::size_t numIndices, std::size_t numVertices, GLenum drawMode)
+    : numVertices_{numVertices}
+{
+    std::vector<unsigned> indices;
+    if (pIndices) {
+        indices.assign(pIndices, pIndices + numIndices);
+    } else {
+        indices.resize(numVertices);
+        std::iota(indices.begin(), indices.end(), 0u);
+    }
+    triangles_ = to_triangle_list(indices, drawMode);
+
+    cornerOffsets_.assign(numVertices + 1, 0);
+    for (unsigned index : triangles_) {
+        if (index >= numVertices) {
+            throw std::runtime_error("Triangle index is out of range of the vertex buffer");
+        }
+        ++cornerOffsets_[index + 1];
+    }
+    std::partial_sum(cornerOffsets_.begin(), cornerOffsets_.end(), cornerOffsets_.begin());
+
+    corners_.resize(triangles_.size());
+    std::vector<unsigned> fill(cornerOffsets_.begin(), cornerOffsets_.end() - 1);
+    for (std::size_t corner = 0; corner < triangles_.size(); ++corner) {
+        corners_[fill[triangles_[corner]]++] = static_cast<unsigned>(corner);
+    }
+
+    cornerValues_.resize(triangles_.size());
+}
+
+NormalKernel::NormalKernel(const sim::PosNormTexData &data, GLenum drawMode)
+    : NormalKernel(data.ibo.empty() ? nullptr : data.ibo.data(), data.ibo.size(), data.vbo.size(), drawMode)
+{
+}
+
+void NormalKernel::computeNormals(sim::PosNormTexVertex *pVertices, NormalWeighting weighting)
+{
+    sim::parallel_for(0, getNumTriangles(), min_parallel_elements, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t t = begin; t < end; ++t) {
+            const unsigned *tri = &triangles_[t * 3];
+            const glm::vec3 p[3] = {position_of(pVertices[tri[0]]),
+                                    position_of(pVertices[tri[1]]),
+                                    position_of(pVertices[tri[2]])};
+
+            const glm::vec3 areaNormal = glm::cross(p[1] - p[0], p[2] - p[0]); // length is twice the area
+
+            if (weighting == NormalWeighting::Area) {
+                cornerValues_[t * 3 + 0] = cornerValues_[t * 3 + 1] = cornerValues_[t * 3 + 2] = areaNormal;
+            } else {
+                const glm::vec3 unitNormal = normalize_or_zero(areaNormal);
+                for (std::size_t k = 0; k < 3; ++k) {
+                    float angle = angle_between(p[(k + 1) % 3] - p[k], p[(k + 2) % 3] - p[k]);
+                    cornerValues_[t * 3 + k] = unitNormal * angle;
+                }
+            }
+        }
+    });
+
+    sim::parallel_for(0, numVertices_, min_parallel_elements, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t v = begin; v < end; ++v) {
+            glm::vec3 sum(0.0f);
+            for (unsigned c = cornerOffsets_[v]; c < cornerOffsets_[v + 1]; ++c) {
+                sum += cornerValues_[corners_[c]];
+            }
+            const glm::vec3 normal = normalize_or_zero(sum);
+            std::copy(&normal.x, &normal.x + 3, pVertices[v].normal);
+        }
+    });
+}
+
+void NormalKernel::computeTangents(const sim::PosNormTexVertex *pVertices, glm::vec4 *pTangents)
+{
+    cornerBitangents_.resize(triangles_.size());
+
+    sim::parallel_for(0, getNumTriangles(), min_parallel_elements, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t t = begin; t < end; ++t) {
+            const unsigned *tri = &triangles_[t * 3];
+            const sim::PosNormTexVertex *v[3] = {&pVertices[tri[0]], &pVertices[tri[1]], &pVertices[tri[2]]};
+
+            const glm::vec3 edge1 = position_of(*v[1]) - position_of(*v[0]);
+            const glm::vec3 edge2 = position_of(*v[2]) - position_of(*v[0]);
+            const glm::vec2 deltaUv1 = tex_coords_of(*v[1]) - tex_coords_of(*v[0]);
+            const glm::vec2 deltaUv2 = tex_coords_of(*v[2]) - tex_coords_of(*v[0]);
+
+            // only the directions matter so the determinant's sign is enough
+            const float determinant = deltaUv1.x * deltaUv2.y - deltaUv2.x * deltaUv1.y;
+            const float sign = determinant < 0.0f ? -1.0f : 1.0f;
+            glm::vec3 faceTangent = (edge1 * deltaUv2.y - edge2 * deltaUv1.y) * sign;
+            glm::vec3 faceBitangent = (edge2 * deltaUv1.x - edge1 * deltaUv2.x) * sign;
+
+            if (determinant == 0.0f) {
+                faceTangent = faceBitangent = glm::vec3(0.0f); // degenerate texture mapping
+            }
+
+            for (std::size_t k = 0; k < 3; ++k) {
+                const glm::vec3 p = position_of(*v[k]);
+                const glm::vec3 normal = normal_of(*v[k]);
+                const float angle
+                    = angle_between(position_of(*v[(k + 1) % 3]) - p, position_of(*v[(k + 2) % 3]) - p);
+
+                // projected into the vertex's tangent plane before averaging like MikkTSpace
+                cornerValues_[t * 3 + k] = normalize_or_zero(project_to_plane(faceTangent, normal)) * angle;
+                cornerBitangents_[t * 3 + k] = normalize_or_zero(project_to_plane(faceBitangent, normal)) * angle;
+            }
+        }
+    });
+
+    sim::parallel_for(0, numVertices_, min_parallel_elements, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t v = begin; v < end; ++v) {
+            glm::vec3 tangent(0.0f);
+            glm::vec3 bitangent(0.0f);
+            for (unsigned c = cornerOffsets_[v]; c < cornerOffsets_[v + 1]; ++c) {
+                tangent += cornerValues_[corners_[c]];
+                bitangent += cornerBitangents_[corners_[c]];
+            }
+
+            const glm::vec3 normal = normal_of(pVertices[v]);
+            tangent = normalize_or_zero(project_to_plane(tangent, normal));
+            if (tangent == glm::vec3(0.0f)) {
+                tangent = any_perpendicular(normal);
+            }
+
+            const float handedness = glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f;
+            pTangents[v] = glm::vec4(tangent, handedness);
+        }
+    });
+}
+
+std::size_t NormalKernel::getNumVertices() const
+{
+    return numVertices_;
+}
+
+std::size_t NormalKernel::getNumTriangles() const
+{
+    return triangles_.size() / 3;
+}
+
+void compute_normals(sim::PosNormTexData *pData, GLenum drawMode, NormalWeighting weighting)
+{
+    NormalKernel kernel(*pData, drawMode);
+    kernel.computeNormals(pData->vbo.data(), weighting);
+}
+
+std::vector<glm::vec4> compute_tangents(const sim::PosNormTexData &data, GLenum drawMode)
+{
+    std::vector<glm::vec4> tangents(data.vbo.size());
+    NormalKernel kernel(data, drawMode);
+    kernel.computeTangents(data.vbo.data(), tangents.data());
+    return tangents;
+}
+
+} // namespace sim
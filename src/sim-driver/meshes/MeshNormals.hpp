@@ -0,0 +1,57 @@
+#pragma once
+
+#include <sim-driver/OpenGLTypes.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace sim {
+
+enum class NormalWeighting
+{
+    Area, // faces contribute proportionally to their area
+    Angle, // faces contribute proportionally to their corner angle (independent of the tessellation)
+};
+
+/// Recomputes vertex normals and tangents of a mesh whose topology stays fixed while its
+/// positions change (e.g. deforming or simulated meshes). The triangle list and the
+/// vertex -> corner adjacency are built once; every update is two passes over flat arrays
+/// run in parallel, without atomics: per corner face contributions, then a per vertex gather.
+class NormalKernel
+{
+public:
+    /// 'pIndices' may be nullptr for non-indexed meshes. GL_TRIANGLE_STRIP (with primitive
+    /// restart) and GL_TRIANGLES are supported.
+    NormalKernel(const unsigned *pIndices, std::size_t numIndices, std::size_t numVertices, GLenum drawMode);
+
+    NormalKernel(const sim::PosNormTexData &data, GLenum drawMode);
+
+    /// Overwrites the 'normal' member of 'numVertices' vertices. Vertices without
+    /// triangles get a zero normal.
+    void computeNormals(sim::PosNormTexVertex *pVertices, NormalWeighting weighting = NormalWeighting::Area);
+
+    /// MikkTSpace-style tangents: per corner tangents from the texture coordinate derivatives are
+    /// angle weighted, orthogonalized against the vertex normal and 'w' holds the bitangent sign
+    /// (bitangent = w * cross(normal, tangent)). Vertices are not split at tangent seams.
+    void computeTangents(const sim::PosNormTexVertex *pVertices, glm::vec4 *pTangents);
+
+    std::size_t getNumVertices() const;
+    std::size_t getNumTriangles() const;
+
+private:
+    std::size_t numVertices_;
+    std::vector<unsigned> triangles_;
+    std::vector<unsigned> cornerOffsets_; // vertex v owns corners_[cornerOffsets_[v], cornerOffsets_[v + 1])
+    std::vector<unsigned> corners_; // triangle * 3 + corner
+
+    // per corner scratch reused between updates
+    std::vector<glm::vec3> cornerValues_;
+    std::vector<glm::vec3> cornerBitangents_;
+};
+
+/// One-off versions of the above (build the adjacency every call)
+void compute_normals(sim::PosNormTexData *pData, GLenum drawMode, NormalWeighting weighting = NormalWeighting::Area);
+
+std::vector<glm::vec4> compute_tangents(const sim::PosNormTexData &data, GLenum drawMode);
+
+} // namespace sim
@@ -0,0 +1,362 @@
+#include <sim-driver/meshes/MeshOptimizer.hpp>
+#include <sim-driver/OpenGLHelper.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace sim {
+
+namespace {
+
+constexpr std::size_t not_cached = std::numeric_limits<std::size_t>::max();
+
+bool is_degenerate(unsigned a, unsigned b, unsigned c)
+{
+    return a == b || b == c || c == a;
+}
+
+void add_triangle(std::vector<unsigned> *pTriangles, unsigned a, unsigned b, unsigned c)
+{
+    if (!is_degenerate(a, b, c)) {
+        pTriangles->push_back(a);
+        pTriangles->push_back(b);
+        pTriangles->push_back(c);
+    }
+}
+
+long skip_dead_end(const std::vector<unsigned> &liveCount, std::vector<unsigned> *pDeadEnd, std::size_t *pCursor)
+{
+    // most recently used vertices first
+    while (!pDeadEnd->empty()) {
+        unsigned vertex = pDeadEnd->back();
+        pDeadEnd->pop_back();
+
+        if (liveCount[vertex] > 0) {
+            return static_cast<long>(vertex);
+        }
+    }
+
+    // then any vertex with triangles left in input order
+    for (; *pCursor < liveCount.size(); ++*pCursor) {
+        if (liveCount[*pCursor] > 0) {
+            return static_cast<long>(*pCursor);
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+std::vector<unsigned> to_triangle_list(const std::vector<unsigned> &indices, GLenum drawMode)
+{
+    std::vector<unsigned> triangles;
+
+    if (drawMode == GL_TRIANGLES) {
+        if (indices.size() % 3 != 0) {
+            throw std::runtime_error("GL_TRIANGLES index count must be a multiple of 3");
+        }
+        triangles.reserve(indices.size());
+
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            add_triangle(&triangles, indices[i], indices[i + 1], indices[i + 2]);
+        }
+        return triangles;
+    }
+
+    if (drawMode != GL_TRIANGLE_STRIP) {
+        throw std::runtime_error("Only GL_TRIANGLES and GL_TRIANGLE_STRIP meshes can be converted to triangle lists");
+    }
+
+    triangles.reserve(indices.size() * 3);
+    const unsigned restart = sim::primitiveRestart();
+
+    std::size_t stripStart = 0;
+    for (std::size_t i = 0; i <= indices.size(); ++i) {
+        if (i < indices.size() && indices[i] != restart) {
+            continue;
+        }
+
+        // every other triangle of a strip is flipped to keep a consistent winding
+        for (std::size_t j = stripStart; j + 2 < i; ++j) {
+            if ((j - stripStart) % 2 == 0) {
+                add_triangle(&triangles, indices[j], indices[j + 1], indices[j + 2]);
+            } else {
+                add_triangle(&triangles, indices[j + 1], indices[j], indices[j + 2]);
+            }
+        }
+        stripStart = i + 1;
+    }
+
+    return triangles;
+}
+
+float compute_acmr(const std::vector<unsigned> &triangles, std::size_t numVertices, unsigned cacheSize)
+{
+    if (triangles.size() < 3) {
+        return 0.0f;
+    }
+
+    // a vertex is still cached if fewer than 'cacheSize' misses happened since it was inserted
+    std::vector<std::size_t> insertedAt(numVertices, not_cached);
+    std::size_t misses = 0;
+
+    for (unsigned index : triangles) {
+        if (insertedAt[index] == not_cached || misses - insertedAt[index] >= cacheSize) {
+            insertedAt[index] = misses++;
+        }
+    }
+
+    return static_cast<float>(misses) / static_cast<float>(triangles.size() / 3);
+}
+
+std::vector<unsigned> optimize_vertex_cache(const std::vector<unsigned> &triangles,
+                                            std::size_t numVertices,
+                                            unsigned cacheSize,
+                                            std::vector<std::size_t> *pClusters)
+{
+    const std::size_t numTriangles = triangles.size() / 3;
+
+    // vertex -> triangle adjacency in compressed rows
+    std::vector<unsigned> liveCount(numVertices, 0);
+    for (unsigned index : triangles) {
+        if (index >= numVertices) {
+            throw std::runtime_error("Triangle index is out of range of the vertex buffer");
+        }
+        ++liveCount[index];
+    }
+
+    std::vector<std::size_t> offsets(numVertices + 1, 0);
+    std::partial_sum(liveCount.begin(), liveCount.end(), offsets.begin() + 1);
+
+    std::vector<unsigned> adjacency(numTriangles * 3);
+    {
+        std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::size_t t = 0; t < numTriangles; ++t) {
+            for (std::size_t k = 0; k < 3; ++k) {
+                adjacency[fill[triangles[t * 3 + k]]++] = static_cast<unsigned>(t);
+            }
+        }
+    }
+
+    std::vector<std::size_t> cacheTime(numVertices, 0);
+    std::vector<bool> emitted(numTriangles, false);
+    std::vector<unsigned> deadEnd;
+    std::vector<unsigned> candidates;
+    std::vector<unsigned> output;
+    deadEnd.reserve(numTriangles * 3);
+    output.reserve(numTriangles * 3);
+
+    if (pClusters) {
+        pClusters->assign(1, 0);
+    }
+
+    std::size_t timeStamp = cacheSize + 1;
+    std::size_t cursor = 0;
+    long fanning = skip_dead_end(liveCount, &deadEnd, &cursor);
+
+    while (fanning >= 0) {
+        const auto vertex = static_cast<std::size_t>(fanning);
+        candidates.clear();
+
+        // emit every remaining triangle around the fanning vertex
+        for (std::size_t a = offsets[vertex]; a < offsets[vertex + 1]; ++a) {
+            const unsigned t = adjacency[a];
+            if (emitted[t]) {
+                continue;
+            }
+
+            for (std::size_t k = 0; k < 3; ++k) {
+                const unsigned v = triangles[t * 3 + k];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --liveCount[v];
+
+                if (timeStamp - cacheTime[v] > cacheSize) {
+                    cacheTime[v] = timeStamp++;
+                }
+            }
+            emitted[t] = true;
+        }
+
+        // next fanning vertex: the oldest candidate that stays cached while its triangles are emitted
+        fanning = -1;
+        std::size_t bestPriority = 0;
+        for (unsigned v : candidates) {
+            if (liveCount[v] == 0) {
+                continue;
+            }
+            std::size_t priority = 0;
+            if (timeStamp - cacheTime[v] + 2 * liveCount[v] <= cacheSize) {
+                priority = timeStamp - cacheTime[v];
+            }
+            if (fanning < 0 || priority > bestPriority) {
+                bestPriority = priority;
+                fanning = static_cast<long>(v);
+            }
+        }
+
+        if (fanning < 0) {
+            fanning = skip_dead_end(liveCount, &deadEnd, &cursor);
+
+            if (pClusters && fanning >= 0 && pClusters->back() != output.size() / 3) {
+                pClusters->push_back(output.size() / 3);
+            }
+        }
+    }
+
+    return output;
+}
+
+std::vector<unsigned> optimize_overdraw(const std::vector<unsigned> &triangles,
+                                        const std::vector<glm::vec3> &positions,
+                                        const std::vector<std::size_t> &clusters)
+{
+    const std::size_t numTriangles = triangles.size() / 3;
+
+    if (clusters.size() < 2) {
+        return triangles;
+    }
+
+    struct Cluster
+    {
+        std::size_t begin;
+        std::size_t end;
+        glm::vec3 centroid;
+        glm::vec3 normal;
+        float occlusion;
+    };
+
+    std::vector<Cluster> sorted;
+    sorted.reserve(clusters.size());
+
+    glm::vec3 meshCentroid{0.0f};
+    float meshArea = 0.0f;
+
+    for (std::size_t c = 0; c < clusters.size(); ++c) {
+        Cluster cluster{clusters[c], c + 1 < clusters.size() ? clusters[c + 1] : numTriangles, {}, {}, 0.0f};
+
+        float area = 0.0f;
+        for (std::size_t t = cluster.begin; t < cluster.end; ++t) {
+            const glm::vec3 &a = positions[triangles[t * 3 + 0]];
+            const glm::vec3 &b = positions[triangles[t * 3 + 1]];
+            const glm::vec3 &c2 = positions[triangles[t * 3 + 2]];
+
+            glm::vec3 areaNormal = glm::cross(b - a, c2 - a); // length is twice the area
+            float triangleArea = glm::length(areaNormal);
+
+            cluster.normal += areaNormal;
+            cluster.centroid += (a + b + c2) * (triangleArea / 3.0f);
+            area += triangleArea;
+        }
+
+        meshCentroid += cluster.centroid;
+        meshArea += area;
+
+        if (area > 0.0f) {
+            cluster.centroid /= area;
+        }
+        sorted.push_back(cluster);
+    }
+
+    if (meshArea > 0.0f) {
+        meshCentroid /= meshArea;
+    }
+
+    // clusters facing away from the center are likely to occlude the others
+    for (Cluster &cluster : sorted) {
+        float normalLength = glm::length(cluster.normal);
+        if (normalLength > 0.0f) {
+            cluster.occlusion = glm::dot(cluster.centroid - meshCentroid, cluster.normal / normalLength);
+        }
+    }
+
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster &lhs, const Cluster &rhs) {
+        return lhs.occlusion > rhs.occlusion;
+    });
+
+    std::vector<unsigned> output;
+    output.reserve(triangles.size());
+
+    for (const Cluster &cluster : sorted) {
+        output.insert(output.end(), triangles.begin() + cluster.begin * 3, triangles.begin() + cluster.end * 3);
+    }
+
+    return output;
+}
+
+template <typename V>
+void optimize_vertex_fetch(sim::DrawData<V> *pData)
+{
+    constexpr unsigned unused = std::numeric_limits<unsigned>::max();
+    const std::size_t numVertices = pData->vbo.size();
+
+    std::vector<unsigned> remap(numVertices, unused);
+    std::vector<V> vbo;
+    vbo.reserve(numVertices);
+
+    for (unsigned &index : pData->ibo) {
+        if (index >= numVertices) {
+            continue; // primitive restart
+        }
+        if (remap[index] == unused) {
+            remap[index] = static_cast<unsigned>(vbo.size());
+            vbo.push_back(pData->vbo[index]);
+        }
+        index = remap[index];
+    }
+
+    for (std::size_t v = 0; v < numVertices; ++v) {
+        if (remap[v] == unused) {
+            vbo.push_back(pData->vbo[v]);
+        }
+    }
+
+    pData->vbo = std::move(vbo);
+}
+
+template <typename V>
+MeshOptimizationStats optimize_mesh(sim::DrawData<V> *pData, GLenum drawMode, unsigned cacheSize)
+{
+    const std::size_t numVertices = pData->vbo.size();
+
+    std::vector<unsigned> triangles;
+    if (pData->ibo.empty()) {
+        std::vector<unsigned> sequential(numVertices);
+        std::iota(sequential.begin(), sequential.end(), 0u);
+        triangles = to_triangle_list(sequential, drawMode);
+    } else {
+        triangles = to_triangle_list(pData->ibo, drawMode);
+    }
+
+    MeshOptimizationStats stats;
+    stats.numTriangles = triangles.size() / 3;
+    stats.acmrBefore = compute_acmr(triangles, numVertices, cacheSize);
+
+    std::vector<std::size_t> clusters;
+    triangles = optimize_vertex_cache(triangles, numVertices, cacheSize, &clusters);
+
+    std::vector<glm::vec3> positions;
+    positions.reserve(numVertices);
+    for (const V &vertex : pData->vbo) {
+        positions.emplace_back(vertex.position[0], vertex.position[1], vertex.position[2]);
+    }
+    triangles = optimize_overdraw(triangles, positions, clusters);
+
+    stats.acmrAfter = compute_acmr(triangles, numVertices, cacheSize);
+
+    pData->ibo = std::move(triangles);
+    optimize_vertex_fetch(pData);
+
+    return stats;
+}
+
+template void optimize_vertex_fetch(sim::PosNormTexData *pData);
+template void optimize_vertex_fetch(sim::PosData *pData);
+
+template MeshOptimizationStats optimize_mesh(sim::PosNormTexData *pData, GLenum drawMode, unsigned cacheSize);
+template MeshOptimizationStats optimize_mesh(sim::PosData *pData, GLenum drawMode, unsigned cacheSize);
+
+} // namespace sim
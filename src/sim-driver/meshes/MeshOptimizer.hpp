@@ -0,0 +1,47 @@
+#pragma once
+
+#include <sim-driver/OpenGLTypes.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace sim {
+
+struct MeshOptimizationStats
+{
+    std::size_t numTriangles{0};
+    float acmrBefore{0.0f}; // average cache miss ratio: transformed vertices per triangle
+    float acmrAfter{0.0f};
+};
+
+/// Converts GL_TRIANGLE_STRIP (with primitive restart) or GL_TRIANGLES indices to a
+/// triangle list with the same winding. Degenerate triangles are removed.
+std::vector<unsigned> to_triangle_list(const std::vector<unsigned> &indices, GLenum drawMode);
+
+/// Simulates a FIFO post-transform vertex cache of 'cacheSize' entries
+float compute_acmr(const std::vector<unsigned> &triangles, std::size_t numVertices, unsigned cacheSize = 16);
+
+/// Tipsify (Sander et al. 2007) triangle reordering for the post-transform vertex cache.
+/// If 'pClusters' isn't null it receives the first triangle of every cluster that starts
+/// after a dead end (used by optimize_overdraw).
+std::vector<unsigned> optimize_vertex_cache(const std::vector<unsigned> &triangles,
+                                            std::size_t numVertices,
+                                            unsigned cacheSize = 16,
+                                            std::vector<std::size_t> *pClusters = nullptr);
+
+/// Sorts the clusters from optimize_vertex_cache so outward facing ones (likely occluders)
+/// are drawn first. Triangle order inside a cluster is kept.
+std::vector<unsigned> optimize_overdraw(const std::vector<unsigned> &triangles,
+                                        const std::vector<glm::vec3> &positions,
+                                        const std::vector<std::size_t> &clusters);
+
+/// Reorders the vertices by first use in 'pData->ibo' and remaps the indices.
+/// Unreferenced vertices are moved to the end.
+template <typename V>
+void optimize_vertex_fetch(sim::DrawData<V> *pData);
+
+/// Runs all of the above. The result is always drawn with GL_TRIANGLES.
+template <typename V>
+MeshOptimizationStats optimize_mesh(sim::DrawData<V> *pData, GLenum drawMode, unsigned cacheSize = 16);
+
+} // namespace sim
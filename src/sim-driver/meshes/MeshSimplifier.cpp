@@ -0,0 +1,695 @@
+#include <sim-driver/meshes/MeshSimplifier.hpp>
+#include <sim-driver/meshes/MeshOptimizer.hpp>
+#include <sim-driver/ParallelFor.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+namespace sim {
+
+namespace {
+
+constexpr std::size_t point_dims = 8; // position, normal, texture coordinates
+
+using Point = std::array<double, point_dims>;
+
+double dot(const Point &lhs, const Point &rhs)
+{
+    double result = 0.0;
+    for (std::size_t i = 0; i < point_dims; ++i) {
+        result += lhs[i] * rhs[i];
+    }
+    return result;
+}
+
+/// Sum of area weighted squared distances to the (2D) planes of triangles embedded in
+/// the 8D attribute space: Q(v) = v^T A v + 2 b.v + c with a symmetric A.
+class Quadric
+{
+public:
+    Quadric()
+    {
+        a_.fill(0.0);
+        b_.fill(0.0);
+    }
+
+    Quadric(const Point &p, const Point &q, const Point &r) : Quadric()
+    {
+        Point e1, e2;
+        for (std::size_t i = 0; i < point_dims; ++i) {
+            e1[i] = q[i] - p[i];
+            e2[i] = r[i] - p[i];
+        }
+
+        // orthonormal basis of the triangle plane (Gram-Schmidt)
+        double length1 = std::sqrt(dot(e1, e1));
+        if (length1 <= 0.0) {
+            return;
+        }
+        for (double &x : e1) {
+            x /= length1;
+        }
+        double projection = dot(e2, e1);
+        for (std::size_t i = 0; i < point_dims; ++i) {
+            e2[i] -= projection * e1[i];
+        }
+        double length2 = std::sqrt(dot(e2, e2));
+        if (length2 <= 0.0) {
+            return;
+        }
+        for (double &x : e2) {
+            x /= length2;
+        }
+
+        const double area = 0.5 * length1 * length2;
+        const double pe1 = dot(p, e1);
+        const double pe2 = dot(p, e2);
+
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < point_dims; ++i) {
+            for (std::size_t j = i; j < point_dims; ++j) {
+                a_[k++] = area * ((i == j ? 1.0 : 0.0) - e1[i] * e1[j] - e2[i] * e2[j]);
+            }
+            b_[i] = area * (pe1 * e1[i] + pe2 * e2[i] - p[i]);
+        }
+        c_ = area * (dot(p, p) - pe1 * pe1 - pe2 * pe2);
+        weight_ = area;
+    }
+
+    Quadric &operator+=(const Quadric &other)
+    {
+        for (std::size_t k = 0; k < a_.size(); ++k) {
+            a_[k] += other.a_[k];
+        }
+        for (std::size_t i = 0; i < point_dims; ++i) {
+            b_[i] += other.b_[i];
+        }
+        c_ += other.c_;
+        weight_ += other.weight_;
+        return *this;
+    }
+
+    /// Area weighted sum of squared distances (not normalized)
+    double evaluate(const Point &v) const
+    {
+        double result = c_;
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < point_dims; ++i) {
+            result += 2.0 * b_[i] * v[i] + a_[k++] * v[i] * v[i];
+            for (std::size_t j = i + 1; j < point_dims; ++j) {
+                result += 2.0 * a_[k++] * v[i] * v[j];
+            }
+        }
+        return result;
+    }
+
+    double weight() const { return weight_; }
+
+private:
+    std::array<double, point_dims * (point_dims + 1) / 2> a_; // upper triangle, row major
+    Point b_;
+    double c_{0.0};
+    double weight_{0.0};
+};
+
+struct Collapse
+{
+    double cost;
+    unsigned from;
+    unsigned to;
+    unsigned version; // of 'from' when this was queued
+
+    bool operator<(const Collapse &other) const { return cost > other.cost; } // cheapest on top
+};
+
+struct ClusterResult
+{
+    std::vector<unsigned> triangles;
+    double maxError{0.0}; // model units
+};
+
+/// Simplifies one cluster of triangles (global vertex indices) to 'targetTriangles'. Collapses
+/// that would move the surface further than 'maxError' (model units) are skipped.
+ClusterResult simplify_cluster(const std::vector<Point> &points,
+                               const std::vector<glm::vec3> &positions,
+                               const std::vector<bool> &locked,
+                               const std::vector<unsigned> &clusterTriangles,
+                               std::size_t targetTriangles,
+                               double maxError)
+{
+    // local vertex ids keep the per vertex state proportional to the cluster
+    std::unordered_map<unsigned, unsigned> toLocal;
+    std::vector<unsigned> globals;
+    std::vector<unsigned> triangles(clusterTriangles.size());
+
+    for (std::size_t i = 0; i < clusterTriangles.size(); ++i) {
+        auto inserted = toLocal.emplace(clusterTriangles[i], static_cast<unsigned>(globals.size()));
+        if (inserted.second) {
+            globals.push_back(clusterTriangles[i]);
+        }
+        triangles[i] = inserted.first->second;
+    }
+
+    const std::size_t numVertices = globals.size();
+    const std::size_t numTriangles = triangles.size() / 3;
+
+    std::vector<Quadric> quadrics(numVertices);
+    std::vector<std::vector<unsigned>> vertexTriangles(numVertices);
+
+    for (std::size_t t = 0; t < numTriangles; ++t) {
+        const unsigned *tri = &triangles[t * 3];
+        Quadric quadric(points[globals[tri[0]]], points[globals[tri[1]]], points[globals[tri[2]]]);
+
+        for (std::size_t k = 0; k < 3; ++k) {
+            quadrics[tri[k]] += quadric;
+            vertexTriangles[tri[k]].push_back(static_cast<unsigned>(t));
+        }
+    }
+
+    std::vector<bool> alive(numTriangles, true);
+    std::vector<bool> removed(numVertices, false);
+    std::vector<unsigned> version(numVertices, 0);
+    std::vector<double> errors(numVertices, 0.0); // of everything collapsed into each vertex so far
+
+    auto position = [&](unsigned v) -> const glm::vec3 & { return positions[globals[v]]; };
+
+    // moving 'from' onto 'to' must not flip (or fold) any of the remaining triangles around 'from'
+    auto keepsOrientation = [&](unsigned from, unsigned to) {
+        for (unsigned t : vertexTriangles[from]) {
+            const unsigned *tri = &triangles[t * 3];
+            if (!alive[t] || tri[0] == to || tri[1] == to || tri[2] == to) {
+                continue;
+            }
+
+            glm::vec3 corners[3] = {position(tri[0]), position(tri[1]), position(tri[2])};
+            glm::vec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+
+            corners[std::find(tri, tri + 3, from) - tri] = position(to);
+            glm::vec3 after = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+
+            // large rotations are rejected too since they tend to flip in later collapses
+            if (glm::dot(before, after) <= 0.25f * glm::length(before) * glm::length(after)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // largest distance of 'from' to the planes of its remaining triangles once moved onto 'to'
+    auto collapseDistance = [&](unsigned from, unsigned to) {
+        double distance = 0.0;
+        for (unsigned t : vertexTriangles[from]) {
+            const unsigned *tri = &triangles[t * 3];
+            if (!alive[t] || tri[0] == to || tri[1] == to || tri[2] == to) {
+                continue;
+            }
+
+            glm::vec3 corners[3] = {position(tri[0]), position(tri[1]), position(tri[2])};
+            corners[std::find(tri, tri + 3, from) - tri] = position(to);
+            glm::vec3 normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+
+            float length = glm::length(normal);
+            if (length > 0.0f) {
+                float offset = glm::dot(position(from) - corners[0], normal) / length;
+                distance = std::max(distance, static_cast<double>(std::abs(offset)));
+            }
+        }
+        return distance;
+    };
+
+    auto collapseCost = [&](unsigned from, unsigned to) {
+        const Point &target = points[globals[to]];
+        double weight = quadrics[from].weight() + quadrics[to].weight();
+        double error = quadrics[from].evaluate(target) + quadrics[to].evaluate(target);
+        return weight > 0.0 ? std::max(0.0, error / weight) : 0.0;
+    };
+
+    std::priority_queue<Collapse> queue;
+
+    auto queueBestCollapse = [&](unsigned from) {
+        if (locked[globals[from]] || removed[from]) {
+            return;
+        }
+
+        Collapse best{std::numeric_limits<double>::max(), from, from, version[from]};
+
+        for (unsigned t : vertexTriangles[from]) {
+            if (!alive[t]) {
+                continue;
+            }
+            for (std::size_t k = 0; k < 3; ++k) {
+                unsigned to = triangles[t * 3 + k];
+                if (to == from) {
+                    continue;
+                }
+                double cost = collapseCost(from, to);
+                if (cost < best.cost && keepsOrientation(from, to)) {
+                    best.cost = cost;
+                    best.to = to;
+                }
+            }
+        }
+
+        if (best.to != from) {
+            queue.push(best);
+        }
+    };
+
+    for (unsigned v = 0; v < numVertices; ++v) {
+        queueBestCollapse(v);
+    }
+
+    ClusterResult result;
+    std::size_t liveTriangles = numTriangles;
+    std::vector<unsigned> neighbours;
+
+    while (liveTriangles > targetTriangles && !queue.empty()) {
+        const Collapse collapse = queue.top();
+        queue.pop();
+
+        if (removed[collapse.from] || collapse.version != version[collapse.from]) {
+            continue; // out of date
+        }
+
+        // deviations of earlier collapses into 'from' are carried along since they add up at most
+        const double error = errors[collapse.from] + collapseDistance(collapse.from, collapse.to);
+        if (error > maxError) {
+            continue; // requeued if a neighbour changes
+        }
+
+        for (unsigned t : vertexTriangles[collapse.from]) {
+            if (!alive[t]) {
+                continue;
+            }
+            unsigned *tri = &triangles[t * 3];
+
+            if (tri[0] == collapse.to || tri[1] == collapse.to || tri[2] == collapse.to) {
+                alive[t] = false;
+                --liveTriangles;
+            } else {
+                *std::find(tri, tri + 3, collapse.from) = collapse.to;
+                vertexTriangles[collapse.to].push_back(t);
+            }
+        }
+        vertexTriangles[collapse.from].clear();
+        quadrics[collapse.to] += quadrics[collapse.from];
+        removed[collapse.from] = true;
+        errors[collapse.to] = std::max(errors[collapse.to], error);
+        result.maxError = std::max(result.maxError, error);
+
+        // every vertex around 'to' has a changed one-ring or quadric
+        std::vector<unsigned> &toTriangles = vertexTriangles[collapse.to];
+        toTriangles.erase(std::remove_if(toTriangles.begin(),
+                                         toTriangles.end(),
+                                         [&](unsigned t) { return !alive[t]; }),
+                          toTriangles.end());
+
+        neighbours.clear();
+        for (unsigned t : toTriangles) {
+            neighbours.insert(neighbours.end(), &triangles[t * 3], &triangles[t * 3] + 3);
+        }
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+
+        for (unsigned v : neighbours) {
+            ++version[v];
+            queueBestCollapse(v);
+        }
+    }
+
+    result.triangles.reserve(liveTriangles * 3);
+    for (std::size_t t = 0; t < numTriangles; ++t) {
+        if (alive[t]) {
+            for (std::size_t k = 0; k < 3; ++k) {
+                result.triangles.push_back(globals[triangles[t * 3 + k]]);
+            }
+        }
+    }
+    return result;
+}
+
+std::uint32_t spread_bits(std::uint32_t x)
+{
+    x &= 0x3ff;
+    x = (x | (x << 16)) & 0x030000ff;
+    x = (x | (x << 8)) & 0x0300f00f;
+    x = (x | (x << 4)) & 0x030c30c3;
+    x = (x | (x << 2)) & 0x09249249;
+    return x;
+}
+
+/// Splits the triangles into chunks of 'clusterSize' along a Morton curve over their centroids.
+/// The first chunk holds 'offset' triangles so boundaries can be shifted between calls.
+std::vector<std::vector<unsigned>> make_clusters(const std::vector<unsigned> &triangles,
+                                                 const std::vector<glm::vec3> &positions,
+                                                 glm::vec3 boundsMin,
+                                                 float extent,
+                                                 std::size_t clusterSize,
+                                                 std::size_t offset)
+{
+    const std::size_t numTriangles = triangles.size() / 3;
+
+    std::vector<std::pair<std::uint32_t, unsigned>> order(numTriangles);
+    for (std::size_t t = 0; t < numTriangles; ++t) {
+        glm::vec3 centroid = (positions[triangles[t * 3]] + positions[triangles[t * 3 + 1]]
+                              + positions[triangles[t * 3 + 2]])
+            / 3.0f;
+        glm::vec3 cell = (centroid - boundsMin) * (1023.0f / extent);
+
+        order[t] = {spread_bits(static_cast<std::uint32_t>(cell.x))
+                        | (spread_bits(static_cast<std::uint32_t>(cell.y)) << 1)
+                        | (spread_bits(static_cast<std::uint32_t>(cell.z)) << 2),
+                    static_cast<unsigned>(t)};
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<std::vector<unsigned>> clusters;
+    std::size_t begin = 0;
+    std::size_t end = (offset > 0 && offset < numTriangles) ? offset : std::min(clusterSize, numTriangles);
+
+    while (begin < numTriangles) {
+        clusters.emplace_back();
+        clusters.back().reserve((end - begin) * 3);
+
+        for (std::size_t i = begin; i < end; ++i) {
+            const unsigned t = order[i].second;
+            clusters.back().insert(clusters.back().end(), &triangles[t * 3], &triangles[t * 3] + 3);
+        }
+        begin = end;
+        end = std::min(end + clusterSize, numTriangles);
+    }
+    return clusters;
+}
+
+/// Moves the referenced vertices to the front in order of first use and drops the rest
+void remove_unused_vertices(sim::PosNormTexData *pData)
+{
+    std::vector<bool> used(pData->vbo.size(), false);
+    std::size_t numUsed = 0;
+    for (unsigned index : pData->ibo) {
+        if (!used[index]) {
+            used[index] = true;
+            ++numUsed;
+        }
+    }
+
+    sim::optimize_vertex_fetch(pData);
+    pData->vbo.resize(numUsed);
+}
+
+/// Picks the copy of a welded vertex whose normal is closest to 'faceNormal'
+unsigned closest_copy(const sim::PosNormTexData &data, const std::vector<unsigned> &copies, const glm::vec3 &faceNormal)
+{
+    unsigned best = copies.front();
+    float bestDot = -std::numeric_limits<float>::max();
+
+    for (unsigned copy : copies) {
+        const float *n = data.vbo[copy].normal;
+        float cosine = glm::dot(glm::vec3{n[0], n[1], n[2]}, faceNormal);
+        if (cosine > bestDot) {
+            bestDot = cosine;
+            best = copy;
+        }
+    }
+    return best;
+}
+
+sim::PosNormTexData simplify_triangles(const sim::PosNormTexData &data,
+                                       std::size_t targetTriangles,
+                                       const SimplifyOptions &options,
+                                       std::size_t clusterOffset,
+                                       float *pError)
+{
+    const std::size_t numVertices = data.vbo.size();
+    const std::size_t numTriangles = data.ibo.size() / 3;
+
+    if (pError) {
+        *pError = 0.0f;
+    }
+    if (targetTriangles >= numTriangles) {
+        sim::PosNormTexData copy = data;
+        remove_unused_vertices(&copy);
+        return copy;
+    }
+    if (options.clusterSize == 0) {
+        throw std::runtime_error("SimplifyOptions::clusterSize must be positive");
+    }
+
+    std::vector<glm::vec3> positions(numVertices);
+    glm::vec3 boundsMin{std::numeric_limits<float>::max()};
+    glm::vec3 boundsMax{-std::numeric_limits<float>::max()};
+
+    for (std::size_t v = 0; v < numVertices; ++v) {
+        const float *p = data.vbo[v].position;
+        positions[v] = {p[0], p[1], p[2]};
+        boundsMin = glm::min(boundsMin, positions[v]);
+        boundsMax = glm::max(boundsMax, positions[v]);
+    }
+
+    // positions are scaled to a unit box so the attribute weights don't depend on the mesh size
+    glm::vec3 size = boundsMax - boundsMin;
+    const float extent = std::max(std::max(size.x, size.y), std::max(size.z, std::numeric_limits<float>::min()));
+
+    std::vector<Point> points(numVertices);
+    for (std::size_t v = 0; v < numVertices; ++v) {
+        const sim::PosNormTexVertex &vertex = data.vbo[v];
+        glm::vec3 p = (positions[v] - boundsMin) / extent;
+        points[v] = {{p.x,
+                      p.y,
+                      p.z,
+                      vertex.normal[0] * options.normalWeight,
+                      vertex.normal[1] * options.normalWeight,
+                      vertex.normal[2] * options.normalWeight,
+                      vertex.texCoords[0] * options.texCoordWeight,
+                      vertex.texCoords[1] * options.texCoordWeight}};
+    }
+
+    std::vector<bool> locked(numVertices, false);
+
+    // Vertices split at the same position only for their normals (hard edges) are welded so they
+    // collapse together, the copy matching each remaining triangle is picked again afterwards.
+    // Texture seams can't be collapsed without tearing the texture so their vertices are locked.
+    std::vector<unsigned> weld(numVertices);
+    std::iota(weld.begin(), weld.end(), 0u);
+    std::unordered_map<unsigned, std::vector<unsigned>> copies; // of each welded vertex
+    {
+        std::vector<unsigned> byPosition(numVertices);
+        std::iota(byPosition.begin(), byPosition.end(), 0u);
+        std::sort(byPosition.begin(), byPosition.end(), [&](unsigned lhs, unsigned rhs) {
+            const glm::vec3 &a = positions[lhs];
+            const glm::vec3 &b = positions[rhs];
+            return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+        });
+
+        for (std::size_t begin = 0, end = 0; begin < numVertices; begin = end) {
+            const unsigned first = byPosition[begin];
+            bool seam = false;
+            for (end = begin + 1; end < numVertices && positions[byPosition[end]] == positions[first]; ++end) {
+                const float *t = data.vbo[byPosition[end]].texCoords;
+                seam |= (t[0] != data.vbo[first].texCoords[0] || t[1] != data.vbo[first].texCoords[1]);
+            }
+            if (end - begin == 1) {
+                continue;
+            }
+
+            for (std::size_t i = begin; i < end; ++i) {
+                if (seam) {
+                    locked[byPosition[i]] = true;
+                } else {
+                    weld[byPosition[i]] = first;
+                    copies[first].push_back(byPosition[i]);
+                }
+            }
+        }
+    }
+
+    std::vector<unsigned> triangles(data.ibo.size());
+    for (std::size_t i = 0; i < triangles.size(); ++i) {
+        triangles[i] = weld[data.ibo[i]];
+    }
+
+    if (options.lockBorders) {
+        std::unordered_map<std::uint64_t, int> edgeCounts;
+        edgeCounts.reserve(triangles.size());
+
+        auto edgeKey = [](unsigned a, unsigned b) {
+            return (static_cast<std::uint64_t>(std::min(a, b)) << 32u) | std::max(a, b);
+        };
+        for (std::size_t t = 0; t < numTriangles; ++t) {
+            for (std::size_t k = 0; k < 3; ++k) {
+                ++edgeCounts[edgeKey(triangles[t * 3 + k], triangles[t * 3 + (k + 1) % 3])];
+            }
+        }
+        for (const auto &edge : edgeCounts) {
+            if (edge.second == 1) {
+                locked[edge.first >> 32u] = locked[edge.first & 0xffffffffu] = true;
+            }
+        }
+    }
+
+    std::vector<std::vector<unsigned>> clusters
+        = make_clusters(triangles, positions, boundsMin, extent, options.clusterSize, clusterOffset);
+
+    // vertices shared between clusters can't move since clusters are simplified independently
+    {
+        std::vector<std::size_t> owner(numVertices, clusters.size());
+        for (std::size_t c = 0; c < clusters.size(); ++c) {
+            for (unsigned index : clusters[c]) {
+                if (owner[index] == clusters.size()) {
+                    owner[index] = c;
+                } else if (owner[index] != c) {
+                    locked[index] = true;
+                }
+            }
+        }
+    }
+
+    const double ratio = static_cast<double>(targetTriangles) / static_cast<double>(numTriangles);
+
+    std::vector<ClusterResult> results(clusters.size());
+
+    sim::parallel_for(0, clusters.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t c = begin; c < end; ++c) {
+            auto target = static_cast<std::size_t>(std::llround(ratio * static_cast<double>(clusters[c].size() / 3)));
+            results[c] = simplify_cluster(points, positions, locked, clusters[c], target, options.maxError);
+        }
+    });
+
+    sim::PosNormTexData simplified;
+    simplified.vbo = data.vbo;
+
+    double maxClusterError = 0.0;
+    for (const ClusterResult &result : results) {
+        simplified.ibo.insert(simplified.ibo.end(), result.triangles.begin(), result.triangles.end());
+        maxClusterError = std::max(maxClusterError, result.maxError);
+    }
+
+    if (!copies.empty()) {
+        for (std::size_t t = 0; t < simplified.ibo.size() / 3; ++t) {
+            unsigned *tri = &simplified.ibo[t * 3];
+            glm::vec3 faceNormal
+                = glm::cross(positions[tri[1]] - positions[tri[0]], positions[tri[2]] - positions[tri[0]]);
+
+            for (std::size_t k = 0; k < 3; ++k) {
+                auto iter = copies.find(tri[k]);
+                if (iter != copies.end()) {
+                    tri[k] = closest_copy(data, iter->second, faceNormal);
+                }
+            }
+        }
+    }
+    remove_unused_vertices(&simplified);
+
+    if (pError) {
+        *pError = static_cast<float>(maxClusterError);
+    }
+    return simplified;
+}
+
+} // namespace
+
+sim::PosNormTexData simplify_mesh(const sim::PosNormTexData &data,
+                                  GLenum drawMode,
+                                  std::size_t targetTriangles,
+                                  const SimplifyOptions &options,
+                                  float *pError)
+{
+    sim::PosNormTexData triangles{data.vbo, {}};
+
+    if (data.ibo.empty()) {
+        std::vector<unsigned> sequential(data.vbo.size());
+        std::iota(sequential.begin(), sequential.end(), 0u);
+        triangles.ibo = sim::to_triangle_list(sequential, drawMode);
+    } else {
+        triangles.ibo = sim::to_triangle_list(data.ibo, drawMode);
+    }
+
+    return simplify_triangles(triangles, targetTriangles, options, 0, pError);
+}
+
+std::vector<MeshLod> create_lod_chain(const sim::PosNormTexData &data,
+                                      GLenum drawMode,
+                                      const std::vector<std::size_t> &targetTriangles,
+                                      const SimplifyOptions &options)
+{
+    std::vector<MeshLod> lods(1);
+    lods[0].data = simplify_mesh(data, drawMode, std::numeric_limits<std::size_t>::max(), options);
+    sim::optimize_mesh(&lods[0].data, GL_TRIANGLES);
+
+    for (std::size_t level = 0; level < targetTriangles.size(); ++level) {
+        const MeshLod &previous = lods.back();
+
+        if (targetTriangles[level] >= previous.data.ibo.size() / 3) {
+            continue;
+        }
+
+        // shift the cluster boundaries by half a cluster every other level
+        std::size_t offset = (level % 2 == 0) ? options.clusterSize / 2 : 0;
+
+        MeshLod lod;
+        lod.data = simplify_triangles(previous.data, targetTriangles[level], options, offset, &lod.error);
+        lod.error += previous.error; // errors of consecutive levels add up at most
+
+        if (lod.data.ibo.size() == previous.data.ibo.size()) {
+            break; // everything left is locked or above the error limit
+        }
+        sim::optimize_mesh(&lod.data, GL_TRIANGLES);
+        lods.push_back(std::move(lod));
+    }
+
+    return lods;
+}
+
+float estimate_tessellation_error(const sim::PosNormTexData &data, GLenum drawMode)
+{
+    std::vector<unsigned> triangles;
+    if (data.ibo.empty()) {
+        std::vector<unsigned> sequential(data.vbo.size());
+        std::iota(sequential.begin(), sequential.end(), 0u);
+        triangles = sim::to_triangle_list(sequential, drawMode);
+    } else {
+        triangles = sim::to_triangle_list(data.ibo, drawMode);
+    }
+
+    float error = 0.0f;
+    for (std::size_t i = 0; i < triangles.size(); ++i) {
+        const sim::PosNormTexVertex &a = data.vbo[triangles[i]];
+        const sim::PosNormTexVertex &b = data.vbo[triangles[i % 3 == 2 ? i - 2 : i + 1]];
+
+        glm::vec3 normalA{a.normal[0], a.normal[1], a.normal[2]};
+        glm::vec3 normalB{b.normal[0], b.normal[1], b.normal[2]};
+        float lengths = glm::length(normalA) * glm::length(normalB);
+        if (lengths <= 0.0f) {
+            continue;
+        }
+
+        // an arc of angle 'theta' over a chord of length 'c' bulges c / 2 * tan(theta / 4) from the chord
+        float theta = std::acos(std::max(-1.0f, std::min(1.0f, glm::dot(normalA, normalB) / lengths)));
+        float chord = glm::length(glm::vec3(b.position[0] - a.position[0],
+                                            b.position[1] - a.position[1],
+                                            b.position[2] - a.position[2]));
+        error = std::max(error, 0.5f * chord * std::tan(0.25f * theta));
+    }
+    return error;
+}
+
+std::vector<std::size_t> make_lod_targets(std::size_t numTriangles, int numLevels, float ratio)
+{
+    std::vector<std::size_t> targets;
+    double target = static_cast<double>(numTriangles);
+
+    for (int level = 0; level < numLevels; ++level) {
+        target *= ratio;
+        targets.push_back(static_cast<std::size_t>(target));
+    }
+    return targets;
+}
+
+} // namespace sim
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <sim-driver/OpenGLTypes.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <limits>
+#include <vector>
+
+namespace sim {
+
+struct SimplifyOptions
+{
+    float normalWeight{0.5f}; // cost of a unit normal change relative to moving a mesh-sized distance
+    float texCoordWeight{0.5f}; // cost of a unit texture coordinate change relative to the same
+    float maxError{std::numeric_limits<float>::max()}; // skip collapses with a larger MeshLod::error
+    bool lockBorders{true}; // keep open boundaries in place
+    std::size_t clusterSize{4096}; // triangles per independently simplified cluster
+};
+
+struct MeshLod
+{
+    sim::PosNormTexData data; // GL_TRIANGLES
+    // Largest distance of a collapsed vertex from the planes of the triangles it was moved into,
+    // summed over consecutive collapses (model units). Not a strict Hausdorff bound, but
+    // positional only so it can be projected to screen space (see LodSelector).
+    float error{0.0f};
+};
+
+/// Reduces 'data' to about 'targetTriangles' triangles with half-edge collapses ordered by
+/// quadric error (Garland and Heckbert 1998) over position, normal and texture coordinates.
+/// Collapses only ever move a vertex onto a neighbour so the original vertices are reused.
+///
+/// The triangles are split into spatially coherent clusters that are simplified in parallel.
+/// Vertices shared between clusters, on texture seams and (optionally) on borders are locked
+/// so the target can't always be reached. Vertices split only for their normals (hard edges)
+/// collapse together. 'pError' receives the positional error (see MeshLod::error).
+///
+/// The result is a GL_TRIANGLES mesh without unreferenced vertices. Safe to call from any thread.
+sim::PosNormTexData simplify_mesh(const sim::PosNormTexData &data,
+                                  GLenum drawMode,
+                                  std::size_t targetTriangles,
+                                  const SimplifyOptions &options = {},
+                                  float *pError = nullptr);
+
+/// Level 0 is 'data' as a triangle list, every further level is simplified from the previous
+/// one to the next (decreasing) entry of 'targetTriangles'. Cluster boundaries alternate between
+/// levels so the areas locked in one level get simplified in the next. Each level is
+/// optimized for the vertex cache (see MeshOptimizer.hpp).
+std::vector<MeshLod> create_lod_chain(const sim::PosNormTexData &data,
+                                      GLenum drawMode,
+                                      const std::vector<std::size_t> &targetTriangles,
+                                      const SimplifyOptions &options = {});
+
+/// Estimates how far the smooth surface described by the vertex normals deviates from its
+/// tessellation: the largest sagitta of the arcs implied along every edge (model units).
+/// Useful as the LOD error of meshes generated at different resolutions.
+float estimate_tessellation_error(const sim::PosNormTexData &data, GLenum drawMode);
+
+/// Target counts for 'numLevels' levels below 'numTriangles', each 'ratio' times the previous
+std::vector<std::size_t> make_lod_targets(std::size_t numTriangles, int numLevels, float ratio = 0.5f);
+
+} // namespace sim
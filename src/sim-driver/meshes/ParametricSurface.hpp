@@ -0,0 +1,122 @@
+#pragma once
+
+#include <sim-driver/OpenGLHelper.hpp>
+#include <sim-driver/ParallelFor.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace sim {
+
+/// One row (u) or column (v) of the parameter grid. The trig values are evaluated
+/// once per row/column so surfaces of revolution only cost a few multiplies per vertex.
+struct SurfaceParam
+{
+    float t; // [0, 1]
+    float angle; // t * range (see below)
+    float cos;
+    float sin;
+};
+
+struct SurfacePoint
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoords;
+};
+
+/// Specialize to generate surfaces for additional vertex types
+template <typename V>
+V make_surface_vertex(const SurfacePoint &point);
+
+template <>
+inline sim::PosNormTexVertex make_surface_vertex(const SurfacePoint &point)
+{
+    const glm::vec3 &p = point.position;
+    const glm::vec3 &n = point.normal;
+    return {{p.x, p.y, p.z}, {n.x, n.y, n.z}, {point.texCoords.x, point.texCoords.y}};
+}
+
+template <>
+inline sim::PosVertex make_surface_vertex(const SurfacePoint &point)
+{
+    return {{point.position.x, point.position.y, point.position.z}};
+}
+
+namespace detail {
+
+inline std::vector<SurfaceParam> make_surface_params(int divisions, double range)
+{
+    std::vector<SurfaceParam> params(static_cast<std::size_t>(std::max(divisions, 0) + 2));
+
+    for (std::size_t i = 0; i < params.size(); ++i) {
+        double t = double(i) / (params.size() - 1);
+        double angle = t * range;
+        params[i] = {float(t), float(angle), float(std::cos(angle)), float(std::sin(angle))};
+    }
+    return params;
+}
+
+} // namespace detail
+
+/// Evaluates 'surface' on a (u_divisions + 2) x (v_divisions + 2) grid and connects the
+/// grid with one triangle strip per u row (separated by primitive restart indices).
+///
+/// 'Surface' must provide:
+///     double uRange() const; // param.angle = param.t * uRange()
+///     double vRange() const;
+///     void operator()(const SurfaceParam &u, const SurfaceParam &v, SurfacePoint *pPoint) const;
+///
+/// Front faces point along dp/du x dp/dv. Rows are evaluated in parallel and written
+/// straight into the preallocated vertex and index buffers.
+template <typename V, typename Surface>
+sim::DrawData<V> create_parametric_mesh_data(const Surface &surface, int u_divisions, int v_divisions)
+{
+    const std::vector<SurfaceParam> us = detail::make_surface_params(u_divisions, surface.uRange());
+    const std::vector<SurfaceParam> vs = detail::make_surface_params(v_divisions, surface.vRange());
+
+    const std::size_t rowSize = vs.size();
+    const std::size_t stripSize = rowSize * 2 + 1;
+    const unsigned restart = sim::primitiveRestart();
+
+    sim::DrawData<V> data{};
+    data.vbo.resize(us.size() * rowSize);
+    data.ibo.resize((us.size() - 1) * stripSize);
+
+    V *pVerts = data.vbo.data();
+    unsigned *pIndices = data.ibo.data();
+
+    // thread start up isn't worth it for small meshes
+    constexpr std::size_t min_verts_per_thread = 8192;
+    const std::size_t minRows = std::max<std::size_t>(1, min_verts_per_thread / rowSize);
+
+    sim::parallel_for(0, us.size(), minRows, [&](std::size_t rowBegin, std::size_t rowEnd) {
+        SurfacePoint point;
+
+        for (std::size_t i = rowBegin; i < rowEnd; ++i) {
+            V *pRow = pVerts + i * rowSize;
+
+            for (std::size_t j = 0; j < rowSize; ++j) {
+                surface(us[i], vs[j], &point);
+                pRow[j] = make_surface_vertex<V>(point);
+            }
+
+            if (i + 1 < us.size()) {
+                unsigned *pStrip = pIndices + i * stripSize;
+                auto index = static_cast<unsigned>(i * rowSize);
+
+                for (std::size_t j = 0; j < rowSize; ++j, ++index) {
+                    *pStrip++ = index;
+                    *pStrip++ = index + static_cast<unsigned>(rowSize);
+                }
+                *pStrip = restart;
+            }
+        }
+    });
+
+    return data;
+}
+
+} // namespace sim
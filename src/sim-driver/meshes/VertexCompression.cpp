@@ -0,0 +1,121 @@
+#include <sim-driver/meshes/VertexCompression.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace sim {
+
+namespace {
+
+constexpr float unorm16_max = 65535.0f;
+constexpr float snorm10_max = 511.0f;
+
+unsigned pack_snorm10(float value)
+{
+    auto bits = static_cast<int>(std::round(glm::clamp(value, -1.0f, 1.0f) * snorm10_max));
+    return static_cast<unsigned>(bits) & 0x3FFu;
+}
+
+float unpack_snorm10(unsigned bits)
+{
+    // sign extend the 10 bit value
+    int value = static_cast<int>(bits & 0x3FFu);
+    if (value & 0x200) {
+        value -= 0x400;
+    }
+    return std::max(static_cast<float>(value) / snorm10_max, -1.0f);
+}
+
+} // namespace
+
+unsigned short pack_unorm16(float value)
+{
+    return static_cast<unsigned short>(std::round(glm::clamp(value, 0.0f, 1.0f) * unorm16_max));
+}
+
+unsigned pack_snorm_2_10_10_10_rev(const glm::vec3 &normal)
+{
+    return pack_snorm10(normal.x) | (pack_snorm10(normal.y) << 10) | (pack_snorm10(normal.z) << 20);
+}
+
+glm::vec3 unpack_snorm_2_10_10_10_rev(unsigned packed)
+{
+    return {unpack_snorm10(packed), unpack_snorm10(packed >> 10), unpack_snorm10(packed >> 20)};
+}
+
+sim::PackedPosNormTexData pack_pos_norm_tex_data(const sim::PosNormTexData &data,
+                                                 glm::mat4 *pLocalFromQuantized,
+                                                 glm::vec4 *pTexFromQuantized)
+{
+    glm::vec3 minPos{std::numeric_limits<float>::max()};
+    glm::vec3 maxPos{std::numeric_limits<float>::lowest()};
+
+    // the texture range always covers [0, 1] so data inside it is stored unscaled
+    glm::vec2 minTex{0};
+    glm::vec2 maxTex{1};
+
+    for (const auto &vertex : data.vbo) {
+        glm::vec3 p{vertex.position[0], vertex.position[1], vertex.position[2]};
+        minPos = glm::min(minPos, p);
+        maxPos = glm::max(maxPos, p);
+
+        glm::vec2 t{vertex.texCoords[0], vertex.texCoords[1]};
+        minTex = glm::min(minTex, t);
+        maxTex = glm::max(maxTex, t);
+    }
+
+    const glm::vec2 texExtent{maxTex - minTex};
+    if (texExtent != glm::vec2{1} && !pTexFromQuantized) {
+        throw std::runtime_error("Texture coordinates outside [0, 1] need a texture range to be packed");
+    }
+
+    if (data.vbo.empty()) {
+        minPos = maxPos = glm::vec3{0};
+    }
+
+    // flat dimensions still need a non-zero scale to stay invertible
+    glm::vec3 extent{maxPos - minPos};
+    for (int i = 0; i < 3; ++i) {
+        extent[i] = (extent[i] > 0.0f ? extent[i] : 1.0f);
+    }
+    glm::vec3 invExtent{1.0f / extent.x, 1.0f / extent.y, 1.0f / extent.z};
+
+    sim::PackedPosNormTexData packed{};
+    packed.vbo.resize(data.vbo.size());
+    packed.ibo = data.ibo;
+
+    for (std::size_t i = 0; i < data.vbo.size(); ++i) {
+        const sim::PosNormTexVertex &src = data.vbo[i];
+        sim::PackedPosNormTexVertex &dst = packed.vbo[i];
+
+        glm::vec3 p{(glm::vec3{src.position[0], src.position[1], src.position[2]} - minPos) * invExtent};
+        dst.position[0] = pack_unorm16(p.x);
+        dst.position[1] = pack_unorm16(p.y);
+        dst.position[2] = pack_unorm16(p.z);
+        dst.padding = 0;
+
+        dst.normal = pack_snorm_2_10_10_10_rev({src.normal[0], src.normal[1], src.normal[2]});
+
+        glm::vec2 t{(glm::vec2{src.texCoords[0], src.texCoords[1]} - minTex) / texExtent};
+        dst.texCoords[0] = pack_unorm16(t.x);
+        dst.texCoords[1] = pack_unorm16(t.y);
+    }
+
+    if (pLocalFromQuantized) {
+        glm::mat4 localFromQuantized{1};
+        localFromQuantized[0][0] = extent.x;
+        localFromQuantized[1][1] = extent.y;
+        localFromQuantized[2][2] = extent.z;
+        localFromQuantized[3] = glm::vec4{minPos, 1.0f};
+        *pLocalFromQuantized = localFromQuantized;
+    }
+
+    if (pTexFromQuantized) {
+        *pTexFromQuantized = glm::vec4{texExtent, minTex};
+    }
+
+    return packed;
+}
+
+} // namespace sim
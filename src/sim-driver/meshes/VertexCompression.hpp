@@ -0,0 +1,24 @@
+#pragma once
+
+#include <sim-driver/VertexFormat.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <glm/glm.hpp>
+
+namespace sim {
+
+unsigned short pack_unorm16(float value); // inverse of unpack_unorm16 in VertexFormat.hpp
+
+unsigned pack_snorm_2_10_10_10_rev(const glm::vec3 &normal);
+glm::vec3 unpack_snorm_2_10_10_10_rev(unsigned packed);
+
+/// Converts 32 byte float vertices into 16 byte PackedPosNormTexVertex data. Positions are
+/// quantized over the bounds of the mesh and 'pLocalFromQuantized' receives the matrix that
+/// restores them (see RendererHelper::setLocalFromQuantizedMatrix). Texture coordinates are
+/// quantized over their range widened to [0, 1] and 'pTexFromQuantized' receives its scale (xy)
+/// and offset (zw) (see RendererHelper::setTexFromQuantized). Throws std::runtime_error if the
+/// texture coordinates leave [0, 1] and 'pTexFromQuantized' is null. Indices are copied unchanged.
+sim::PackedPosNormTexData pack_pos_norm_tex_data(const sim::PosNormTexData &data,
+                                                 glm::mat4 *pLocalFromQuantized,
+                                                 glm::vec4 *pTexFromQuantized = nullptr);
+
+} // namespace sim
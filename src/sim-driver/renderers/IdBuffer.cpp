@@ -0,0 +1,252 @@
+#include <sim-driver/renderers/IdBuffer.hpp>
+#include <sim-driver/OpenGLHelper.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace sim {
+
+namespace {
+
+std::shared_ptr<GLuint> create_id_texture(GLsizei width, GLsizei height)
+{
+    GLuint tex;
+    glGenTextures(1, &tex);
+    std::shared_ptr<GLuint> spTexture(new GLuint(tex), [](auto *pID) {
+        glDeleteTextures(1, pID);
+        delete pID;
+    });
+
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    // integer formats can't be specified with GL_FLOAT like createTextureArray does
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, width, height, 0, GL_RG_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return spTexture;
+}
+
+} // namespace
+
+PickRing::PickRing(std::size_t size) : slots_(size)
+{
+    if (size == 0) {
+        throw std::runtime_error("IdBuffer needs at least one readback buffer");
+    }
+}
+
+std::size_t PickRing::request(int x, int y, long long frame, bool *pDropped)
+{
+    const std::size_t slot = next_;
+    next_ = (next_ + 1) % slots_.size();
+
+    if (pDropped) {
+        *pDropped = slots_[slot].pending;
+    }
+    slots_[slot] = {true, x, y, frame};
+    return slot;
+}
+
+std::vector<std::size_t> PickRing::getPending() const
+{
+    std::vector<std::size_t> pending;
+    for (std::size_t i = 0; i < slots_.size(); ++i) {
+        const std::size_t slot = (next_ + i) % slots_.size();
+        if (slots_[slot].pending) {
+            pending.push_back(slot);
+        }
+    }
+    return pending;
+}
+
+void PickRing::complete(std::size_t slot, unsigned object, unsigned primitive)
+{
+    Slot &request = slots_.at(slot);
+    request.pending = false;
+
+    if (request.frame >= latest_.frame) {
+        latest_.hit = object != no_object;
+        latest_.object = object;
+        latest_.primitive = primitive;
+        latest_.x = request.x;
+        latest_.y = request.y;
+        latest_.frame = request.frame;
+    }
+}
+
+const PickResult &PickRing::getLatest() const
+{
+    return latest_;
+}
+
+std::size_t PickRing::getNumPending() const
+{
+    return static_cast<std::size_t>(
+        std::count_if(slots_.begin(), slots_.end(), [](const Slot &slot) { return slot.pending; }));
+}
+
+std::size_t PickRing::size() const
+{
+    return slots_.size();
+}
+
+IdBuffer::IdBuffer(int width, int height, std::size_t ringSize) : picks_(ringSize)
+{
+    readbacks_.resize(ringSize);
+    for (Readback &readback : readbacks_) {
+        readback.pbo = OpenGLHelper::createBuffer<unsigned>(nullptr, 2, GL_PIXEL_PACK_BUFFER, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    resize(width, height);
+}
+
+void IdBuffer::resize(int width, int height)
+{
+    width_ = std::max(1, width);
+    height_ = std::max(1, height);
+
+    spColorTex_ = OpenGLHelper::createTextureArray(width_,
+                                                   height_,
+                                                   nullptr,
+                                                   GL_NEAREST,
+                                                   GL_CLAMP_TO_EDGE,
+                                                   GL_RGBA8,
+                                                   GL_RGBA);
+    spIdTex_ = create_id_texture(width_, height_);
+
+    GLuint rbo;
+    glGenRenderbuffers(1, &rbo);
+    spDepthRbo_ = std::shared_ptr<GLuint>(new GLuint(rbo), [](auto *pID) {
+        glDeleteRenderbuffers(1, pID);
+        delete pID;
+    });
+    glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width_, height_);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLuint fbo;
+    glGenFramebuffers(1, &fbo);
+    spFramebuffer_ = std::shared_ptr<GLuint>(new GLuint(fbo), [](auto *pID) {
+        glDeleteFramebuffers(1, pID);
+        delete pID;
+    });
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, *spColorTex_, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, *spIdTex_, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rbo);
+
+    // fragment output 0 is the color and output 1 the ids
+    const GLenum drawBuffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, drawBuffers);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error("ID buffer framebuffer creation failed");
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void IdBuffer::begin(const glm::vec4 &clearColor)
+{
+    ++frame_;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, *spFramebuffer_);
+    glViewport(0, 0, width_, height_);
+
+    const GLuint noIds[4] = {no_object, no_object, 0, 0};
+    const GLfloat farDepth = 1.0f;
+    glClearBufferfv(GL_COLOR, 0, &clearColor[0]);
+    glClearBufferuiv(GL_COLOR, 1, noIds);
+    glClearBufferfv(GL_DEPTH, 0, &farDepth);
+}
+
+void IdBuffer::end()
+{
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, *spFramebuffer_);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, width_, height_, 0, 0, width_, height_, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool IdBuffer::requestPick(int x, int y)
+{
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+        return false;
+    }
+
+    // a slot that is still in flight is overwritten, the GPU orders the two copies
+    Readback &readback = readbacks_[picks_.request(x, y, frame_)];
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, *spFramebuffer_);
+    glReadBuffer(GL_COLOR_ATTACHMENT1);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, *readback.pbo);
+
+    // writes into the bound pixel buffer so this returns without waiting for the frame
+    glReadPixels(x, height_ - 1 - y, 1, 1, GL_RG_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    readback.fence = SyncPtr(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), [](GLsync sync) { glDeleteSync(sync); });
+    return true;
+}
+
+const PickResult &IdBuffer::poll()
+{
+    for (std::size_t slot : picks_.getPending()) {
+        Readback &readback = readbacks_[slot];
+
+        // a zero timeout only checks the status
+        const GLenum status = glClientWaitSync(readback.fence.get(), 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            continue;
+        }
+        readback.fence = nullptr;
+
+        GLuint ids[2] = {no_object, 0};
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, *readback.pbo);
+        glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, sizeof(ids), ids);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        picks_.complete(slot, ids[0], ids[1]);
+    }
+    return picks_.getLatest();
+}
+
+const PickResult &IdBuffer::getLatestPick() const
+{
+    return picks_.getLatest();
+}
+
+std::size_t IdBuffer::getPendingPicks() const
+{
+    return picks_.getNumPending();
+}
+
+int IdBuffer::getWidth() const
+{
+    return width_;
+}
+
+int IdBuffer::getHeight() const
+{
+    return height_;
+}
+
+const std::shared_ptr<GLuint> &IdBuffer::getColorTexture() const
+{
+    return spColorTex_;
+}
+
+const std::shared_ptr<GLuint> &IdBuffer::getIdTexture() const
+{
+    return spIdTex_;
+}
+
+} // namespace sim
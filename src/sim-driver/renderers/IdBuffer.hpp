@@ -0,0 +1,120 @@
+#pragma once
+
+#include <sim-driver/OpenGLTypes.hpp>
+#include <glm/glm.hpp>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace sim {
+
+struct PickResult
+{
+    bool hit{false};
+    unsigned object{0}; // RendererHelper::getObjectId of the drawn mesh
+    unsigned primitive{0}; // gl_PrimitiveID of the drawn mesh
+    int x{0}; // framebuffer pixel the request was made for (origin at the top left)
+    int y{0};
+    long long frame{-1}; // frame the request was made in, -1 if no request finished yet
+};
+
+/// Bookkeeping of the pick requests in flight, kept apart from the GL buffers and fences that
+/// IdBuffer pairs with every slot. Slots are handed out in order so the next one is always
+/// the oldest: when every slot is pending the oldest request is dropped for the new one.
+class PickRing
+{
+public:
+    static constexpr unsigned no_object = 0xffffffffu;
+
+    explicit PickRing(std::size_t size);
+
+    /// Returns the slot for a new request. 'pDropped' is set if it replaced a pending request.
+    std::size_t request(int x, int y, long long frame, bool *pDropped = nullptr);
+
+    /// Pending slots, oldest request first
+    std::vector<std::size_t> getPending() const;
+
+    /// Finishes the request in 'slot' with the ids read back for it. Results of requests older
+    /// than the latest one are dropped.
+    void complete(std::size_t slot, unsigned object, unsigned primitive);
+
+    const PickResult &getLatest() const;
+    std::size_t getNumPending() const;
+    std::size_t size() const;
+
+private:
+    struct Slot
+    {
+        bool pending{false};
+        int x{0};
+        int y{0};
+        long long frame{0};
+    };
+
+    std::vector<Slot> slots_;
+    std::size_t next_{0}; // slot of the next request
+    PickResult latest_;
+};
+
+/// Offscreen target with an object/primitive ID attachment next to the color. RendererHelpers
+/// drawn between 'begin' and 'end' write their object id and gl_PrimitiveID in the same pass as
+/// the color. 'end' blits the color to the window.
+///
+/// Picks are read back through a ring of pixel buffers guarded by fences: 'requestPick' only
+/// queues a copy on the GPU and 'poll' collects the finished ones without waiting, so results
+/// arrive a frame or two after the request and the pipeline never stalls (see PickRing).
+class IdBuffer
+{
+public:
+    static constexpr unsigned no_object = PickRing::no_object;
+
+    /// 'ringSize' is the number of picks that can be in flight at once
+    explicit IdBuffer(int width = 1, int height = 1, std::size_t ringSize = 3);
+
+    /// Framebuffer size in pixels (e.g. from glfwGetFramebufferSize)
+    void resize(int width, int height);
+
+    /// Binds and clears the targets. Ids are cleared to no_object.
+    void begin(const glm::vec4 &clearColor = glm::vec4{0.0f});
+
+    /// Copies the color to the window framebuffer and binds it again
+    void end();
+
+    /// Queues a read of the pixel at ('x', 'y') with the origin at the top left. Call after
+    /// 'end'. Returns false if the pixel is outside of the buffer. If every buffer of the ring
+    /// is in flight the oldest request is dropped so the newest pick always gets through.
+    bool requestPick(int x, int y);
+
+    /// Collects every finished request without blocking and returns the newest result
+    const PickResult &poll();
+
+    const PickResult &getLatestPick() const;
+    std::size_t getPendingPicks() const;
+    int getWidth() const;
+    int getHeight() const;
+    const std::shared_ptr<GLuint> &getColorTexture() const;
+    const std::shared_ptr<GLuint> &getIdTexture() const;
+
+private:
+    using SyncPtr = std::shared_ptr<std::remove_pointer<GLsync>::type>;
+
+    struct Readback
+    {
+        std::shared_ptr<GLuint> pbo;
+        SyncPtr fence{nullptr};
+    };
+
+    int width_{0};
+    int height_{0};
+
+    std::shared_ptr<GLuint> spFramebuffer_;
+    std::shared_ptr<GLuint> spColorTex_;
+    std::shared_ptr<GLuint> spIdTex_;
+    std::shared_ptr<GLuint> spDepthRbo_;
+
+    std::vector<Readback> readbacks_; // one per PickRing slot
+    PickRing picks_;
+    long long frame_{0};
+};
+
+} // namespace sim
@@ -0,0 +1,79 @@
+#include <sim-driver/renderers/LodSelector.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+namespace {
+
+/// Coarsest level with an error of at most 'threshold' (level 0 if none are)
+std::size_t coarsest_level(const std::vector<float> &pixelErrors, float threshold)
+{
+    std::size_t level = 0;
+    for (std::size_t i = 1; i < pixelErrors.size(); ++i) {
+        if (pixelErrors[i] <= threshold) {
+            level = i;
+        }
+    }
+    return level;
+}
+
+} // namespace
+
+float projected_size_pixels(float worldSize, float distance, float fovYRadians, int viewportHeight)
+{
+    return worldSize * static_cast<float>(viewportHeight) / (2.0f * distance * std::tan(0.5f * fovYRadians));
+}
+
+LodSelector::LodSelector(float pixelThreshold, float hysteresis)
+    : pixelThreshold_{pixelThreshold}, hysteresis_{hysteresis}
+{
+}
+
+std::size_t LodSelector::select(const std::vector<float> &pixelErrors)
+{
+    if (pixelErrors.empty()) {
+        level_ = 0;
+        return level_;
+    }
+    level_ = std::min(level_, pixelErrors.size() - 1);
+
+    if (pixelErrors[level_] > pixelThreshold_ * (1.0f + hysteresis_)) {
+        level_ = coarsest_level(pixelErrors, pixelThreshold_);
+    } else {
+        level_ = std::max(level_, coarsest_level(pixelErrors, pixelThreshold_ * (1.0f - hysteresis_)));
+    }
+    return level_;
+}
+
+void LodSelector::reset()
+{
+    level_ = 0;
+}
+
+std::size_t LodSelector::getLevel() const
+{
+    return level_;
+}
+
+float LodSelector::getPixelThreshold() const
+{
+    return pixelThreshold_;
+}
+
+float LodSelector::getHysteresis() const
+{
+    return hysteresis_;
+}
+
+void LodSelector::setPixelThreshold(float pixelThreshold)
+{
+    pixelThreshold_ = pixelThreshold;
+}
+
+void LodSelector::setHysteresis(float hysteresis)
+{
+    hysteresis_ = hysteresis;
+}
+
+} // namespace sim
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace sim {
+
+/// Height in pixels of something 'worldSize' tall at 'distance' in front of a perspective camera
+float projected_size_pixels(float worldSize, float distance, float fovYRadians, int viewportHeight);
+
+/// Picks the coarsest level of detail whose projected error is below a pixel threshold.
+/// Levels only become coarser once their error is below (1 - hysteresis) * threshold and
+/// finer once the current level's error exceeds (1 + hysteresis) * threshold so objects
+/// near a switching distance don't pop back and forth between levels.
+class LodSelector
+{
+public:
+    explicit LodSelector(float pixelThreshold = 1.0f, float hysteresis = 0.25f);
+
+    /// 'pixelErrors' holds the projected error of every level, finest (level 0) first.
+    /// Returns the selected level.
+    std::size_t select(const std::vector<float> &pixelErrors);
+
+    /// Forget the previous selection (e.g. after the levels changed)
+    void reset();
+
+    std::size_t getLevel() const;
+    float getPixelThreshold() const;
+    float getHysteresis() const;
+
+    void setPixelThreshold(float pixelThreshold);
+    void setHysteresis(float hysteresis);
+
+private:
+    float pixelThreshold_;
+    float hysteresis_;
+    std::size_t level_{0};
+};
+
+} // namespace sim
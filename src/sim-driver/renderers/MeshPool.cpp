@@ -0,0 +1,312 @@
+#include <sim-driver/renderers/MeshPool.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <sim-driver/OpenGLHelper.hpp>
+#include <sim-driver/Camera.hpp>
+#include <sim-driver/ShaderConfig.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace sim {
+
+namespace {
+
+/// Creates a larger buffer and copies the used part of the old one into it on the GPU
+template <typename T>
+std::shared_ptr<GLuint> grow_buffer(const std::shared_ptr<GLuint> &spOld,
+                                    std::size_t usedElements,
+                                    std::size_t newCapacity,
+                                    GLenum type)
+{
+    std::shared_ptr<GLuint> spNew = OpenGLHelper::createBuffer<T>(nullptr, newCapacity, type);
+
+    glBindBuffer(GL_COPY_READ_BUFFER, *spOld);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, *spNew);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER,
+                        GL_COPY_WRITE_BUFFER,
+                        0,
+                        0,
+                        static_cast<GLsizeiptr>(usedElements * sizeof(T)));
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    return spNew;
+}
+
+} // namespace
+
+DrawElementsIndirectCommand make_draw_command(const MeshRange &range)
+{
+    return {range.numIndices, 1, range.firstIndex, range.baseVertex, 0};
+}
+
+std::size_t compact_draws(const unsigned char *visible,
+                          std::vector<DrawElementsIndirectCommand> *pCommands,
+                          std::vector<InstanceData> *pDraws,
+                          std::vector<std::size_t> *pMeshes)
+{
+    std::vector<DrawElementsIndirectCommand> &commands = *pCommands;
+    std::vector<InstanceData> &draws = *pDraws;
+    std::vector<std::size_t> &meshes = *pMeshes;
+
+    // compact in place so the submitted draws keep their queued order
+    std::size_t numVisible = 0;
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        if (visible[i]) {
+            commands[numVisible] = commands[i];
+            draws[numVisible] = draws[i];
+            meshes[numVisible] = meshes[i];
+            ++numVisible;
+        }
+    }
+    commands.resize(numVisible);
+    draws.resize(numVisible);
+    meshes.resize(numVisible);
+
+    return numVisible;
+}
+
+template <typename Vertex>
+MeshPool<Vertex>::MeshPool(GLenum drawMode, std::size_t vertexCapacity, std::size_t indexCapacity)
+    : vertexCapacity_{std::max<std::size_t>(vertexCapacity, 1)}
+    , indexCapacity_{std::max<std::size_t>(indexCapacity, 1)}
+    , drawMode_{drawMode}
+{
+    programs_ = OpenGLHelper::createSeparablePrograms(sim::shader_path() + "shader_pool.vert", sim::frag_shader_file());
+
+    spVbo_ = OpenGLHelper::createBuffer<Vertex>(nullptr, vertexCapacity_);
+    spIbo_ = OpenGLHelper::createBuffer<unsigned>(nullptr, indexCapacity_, GL_ELEMENT_ARRAY_BUFFER);
+    spVao_ = OpenGLHelper::createVao<Vertex>(spVbo_);
+
+    spCommandBuffer_
+        = OpenGLHelper::createBuffer<DrawElementsIndirectCommand>(nullptr, 0, GL_DRAW_INDIRECT_BUFFER, GL_STREAM_DRAW);
+    spDrawSsbo_ = OpenGLHelper::createBuffer<InstanceData>(nullptr, 0, GL_SHADER_STORAGE_BUFFER, GL_STREAM_DRAW);
+}
+
+template <typename Vertex>
+typename MeshPool<Vertex>::MeshId MeshPool<Vertex>::addMesh(const DrawDataView<Vertex> &data)
+{
+    std::vector<unsigned> sequentialIndices;
+    const unsigned *pIndices = data.ibo;
+    std::size_t numIndices = data.iboSize;
+
+    if (numIndices == 0) {
+        sequentialIndices.resize(data.vboSize);
+        std::iota(sequentialIndices.begin(), sequentialIndices.end(), 0u);
+        pIndices = sequentialIndices.data();
+        numIndices = sequentialIndices.size();
+    }
+
+    reserve(numVertices_ + data.vboSize, numIndices_ + numIndices);
+
+    // indices stay relative to the mesh so primitive restart values are untouched (baseVertex is added after)
+    OpenGLHelper::updateBuffer(spVbo_, numVertices_, data.vboSize, data.vbo, GL_ARRAY_BUFFER);
+    OpenGLHelper::updateBuffer(spIbo_, numIndices_, numIndices, pIndices, GL_ELEMENT_ARRAY_BUFFER);
+
+    meshes_.push_back({static_cast<GLuint>(numIndices_),
+                       static_cast<GLuint>(numIndices),
+                       static_cast<GLint>(numVertices_),
+                       static_cast<GLuint>(data.vboSize)});
+    meshSpheres_.push_back(bounding_sphere(compute_bounds(data.vbo, data.vboSize)));
+
+    numVertices_ += data.vboSize;
+    numIndices_ += numIndices;
+
+    return meshes_.size() - 1;
+}
+
+template <typename Vertex>
+void MeshPool<Vertex>::draw(MeshId mesh, const glm::mat4 &worldFromLocal, const glm::vec4 &color)
+{
+    const MeshRange &range = getMeshRange(mesh);
+
+    commands_.push_back(make_draw_command(range));
+    draws_.push_back({worldFromLocal, color});
+    drawMeshes_.push_back(mesh);
+}
+
+template <typename Vertex>
+void MeshPool<Vertex>::render(const Camera *pCamera)
+{
+    cullStats_ = {};
+
+    if (frustumCulling_ && pCamera != nullptr) {
+        cullDraws(*pCamera);
+    }
+    cullStats_.visible = commands_.size();
+
+    if (commands_.empty()) {
+        return;
+    }
+
+    OpenGLHelper::streamBuffer(spCommandBuffer_,
+                               &commandCapacity_,
+                               commands_.data(),
+                               commands_.size(),
+                               GL_DRAW_INDIRECT_BUFFER);
+    OpenGLHelper::streamBuffer(spDrawSsbo_, &drawCapacity_, draws_.data(), draws_.size(), GL_SHADER_STORAGE_BUFFER);
+
+    glUseProgram(0);
+    glUseProgramStages(*programs_.pipeline, GL_VERTEX_SHADER_BIT, *programs_.vert);
+    glUseProgramStages(*programs_.pipeline, GL_GEOMETRY_SHADER_BIT, 0);
+    glUseProgramStages(*programs_.pipeline, GL_FRAGMENT_SHADER_BIT, *programs_.frag);
+    glBindProgramPipeline(*programs_.pipeline);
+
+    if (pCamera != nullptr) {
+        sim::OpenGLHelper::setMatrixUniform(programs_.vert,
+                                            "screen_from_world",
+                                            glm::value_ptr(pCamera->getPerspectiveScreenFromWorldMatrix()));
+        sim::OpenGLHelper::setFloatUniform(programs_.frag, "eye", glm::value_ptr(pCamera->getEyeVector()), 3);
+    }
+
+    // binding 0 is used by the fragment shader lights
+    sim::OpenGLHelper::setSsboUniform(programs_.vert,
+                                      spDrawSsbo_,
+                                      "drawData",
+                                      static_cast<int>(draws_.size() * sizeof(InstanceData)),
+                                      1);
+
+    glm::vec3 lightDir = glm::normalize(lightDir_);
+    sim::OpenGLHelper::setIntUniform(programs_.frag, "displayMode", &displayMode_);
+    sim::OpenGLHelper::setFloatUniform(programs_.frag, "shapeColor", glm::value_ptr(shapeColor_), 3);
+    sim::OpenGLHelper::setFloatUniform(programs_.frag, "lightDir", glm::value_ptr(lightDir), 3);
+
+    sim::OpenGLHelper::renderBufferIndirect(spVao_,
+                                            drawMode_,
+                                            spIbo_,
+                                            spCommandBuffer_,
+                                            static_cast<int>(commands_.size()));
+
+    commands_.clear();
+    draws_.clear();
+    drawMeshes_.clear();
+}
+
+template <typename Vertex>
+void MeshPool<Vertex>::clear()
+{
+    meshes_.clear();
+    meshSpheres_.clear();
+    commands_.clear();
+    draws_.clear();
+    drawMeshes_.clear();
+    numVertices_ = 0;
+    numIndices_ = 0;
+}
+
+template <typename Vertex>
+void MeshPool<Vertex>::reserve(std::size_t numVertices, std::size_t numIndices)
+{
+    if (numVertices > vertexCapacity_) {
+        vertexCapacity_ = std::max(numVertices, vertexCapacity_ * 2);
+        spVbo_ = grow_buffer<Vertex>(spVbo_, numVertices_, vertexCapacity_, GL_ARRAY_BUFFER);
+        spVao_ = OpenGLHelper::createVao<Vertex>(spVbo_);
+    }
+
+    if (numIndices > indexCapacity_) {
+        indexCapacity_ = std::max(numIndices, indexCapacity_ * 2);
+        spIbo_ = grow_buffer<unsigned>(spIbo_, numIndices_, indexCapacity_, GL_ELEMENT_ARRAY_BUFFER);
+    }
+}
+
+template <typename Vertex>
+void MeshPool<Vertex>::cullDraws(const Camera &camera)
+{
+    const std::size_t numDraws = commands_.size();
+    cullX_.resize(numDraws);
+    cullY_.resize(numDraws);
+    cullZ_.resize(numDraws);
+    cullRadius_.resize(numDraws);
+    cullVisible_.resize(numDraws);
+
+    for (std::size_t i = 0; i < numDraws; ++i) {
+        const BoundingSphere sphere = transform_sphere(meshSpheres_[drawMeshes_[i]], draws_[i].worldFromLocal);
+        cullX_[i] = sphere.center.x;
+        cullY_[i] = sphere.center.y;
+        cullZ_[i] = sphere.center.z;
+        cullRadius_[i] = sphere.radius;
+    }
+
+    const Frustum frustum = extract_frustum(camera.getPerspectiveScreenFromWorldMatrix());
+    cull_spheres(frustum,
+                 cullX_.data(),
+                 cullY_.data(),
+                 cullZ_.data(),
+                 cullRadius_.data(),
+                 numDraws,
+                 cullVisible_.data());
+
+    const std::size_t numVisible = compact_draws(cullVisible_.data(), &commands_, &draws_, &drawMeshes_);
+    cullStats_.culled = numDraws - numVisible;
+}
+
+template <typename Vertex>
+const MeshRange &MeshPool<Vertex>::getMeshRange(MeshId mesh) const
+{
+    if (mesh >= meshes_.size()) {
+        throw std::runtime_error("Invalid mesh id: " + std::to_string(mesh));
+    }
+    return meshes_[mesh];
+}
+template <typename Vertex>
+std::size_t MeshPool<Vertex>::getNumMeshes() const
+{
+    return meshes_.size();
+}
+template <typename Vertex>
+std::size_t MeshPool<Vertex>::getNumQueuedDraws() const
+{
+    return commands_.size();
+}
+template <typename Vertex>
+int MeshPool<Vertex>::getDisplayMode() const
+{
+    return displayMode_;
+}
+template <typename Vertex>
+const glm::vec3 &MeshPool<Vertex>::getShapeColor() const
+{
+    return shapeColor_;
+}
+template <typename Vertex>
+const glm::vec3 &MeshPool<Vertex>::getLightDir() const
+{
+    return lightDir_;
+}
+
+template <typename Vertex>
+bool MeshPool<Vertex>::isFrustumCulling() const
+{
+    return frustumCulling_;
+}
+template <typename Vertex>
+const CullStats &MeshPool<Vertex>::getCullStats() const
+{
+    return cullStats_;
+}
+
+template <typename Vertex>
+void MeshPool<Vertex>::setDisplayMode(int displayMode)
+{
+    displayMode_ = displayMode;
+}
+template <typename Vertex>
+void MeshPool<Vertex>::setShapeColor(const glm::vec3 &shapeColor)
+{
+    shapeColor_ = shapeColor;
+}
+template <typename Vertex>
+void MeshPool<Vertex>::setLightDir(const glm::vec3 &lightDir)
+{
+    lightDir_ = lightDir;
+}
+template <typename Vertex>
+void MeshPool<Vertex>::setFrustumCulling(bool frustumCulling)
+{
+    frustumCulling_ = frustumCulling;
+}
+
+template class sim::MeshPool<sim::PosNormTexVertex>;
+
+} // namespace sim
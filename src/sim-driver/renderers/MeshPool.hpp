@@ -0,0 +1,128 @@
+#pragma once
+
+#include <sim-driver/OpenGLTypes.hpp>
+#include <sim-driver/Frustum.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace sim {
+
+/// Command layout defined by the GL spec for glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "Indirect commands must be tightly packed");
+
+/// Location of a single mesh inside the shared pool buffers
+struct MeshRange
+{
+    GLuint firstIndex;
+    GLuint numIndices;
+    GLint baseVertex;
+    GLuint numVertices;
+};
+
+/// Command drawing a single instance of 'range'
+DrawElementsIndirectCommand make_draw_command(const MeshRange &range);
+
+/// Moves the draws with a non-zero 'visible' flag to the front of 'pCommands' (along with the
+/// matching entries of 'pDraws' and 'pMeshes') in their queued order and drops the others.
+/// Returns the number of draws kept.
+std::size_t compact_draws(const unsigned char *visible,
+                          std::vector<DrawElementsIndirectCommand> *pCommands,
+                          std::vector<InstanceData> *pDraws,
+                          std::vector<std::size_t> *pMeshes);
+
+/// Suballocates many meshes from one shared vbo/ibo pair so every queued draw
+/// is submitted with a single glMultiDrawElementsIndirect call. Per draw
+/// transforms and colors are read from an ssbo using gl_DrawIDARB.
+///
+/// Requires OpenGL 4.3 (or ARB_multi_draw_indirect, ARB_shader_draw_parameters
+/// and ARB_shader_storage_buffer_object) so it is not available on macOS.
+///
+/// The pool shader reads normals and texture coordinates so only PosNormTexVertex
+/// pools are instantiated.
+template <typename Vertex>
+class MeshPool
+{
+public:
+    using MeshId = std::size_t;
+
+    explicit MeshPool(GLenum drawMode = GL_TRIANGLE_STRIP,
+                      std::size_t vertexCapacity = 1u << 16u,
+                      std::size_t indexCapacity = 1u << 18u);
+
+    /// Copies the mesh into the shared buffers (growing them if needed). Meshes
+    /// without indices are drawn with sequential ones.
+    MeshId addMesh(const DrawDataView<Vertex> &data);
+
+    /// Queues one copy of 'mesh' for the next call to 'render'
+    void draw(MeshId mesh, const glm::mat4 &worldFromLocal, const glm::vec4 &color = glm::vec4{1});
+
+    /// Draws and then clears all queued draws. When frustum culling is on the queued
+    /// draws are tested in one batch and only the visible ones are submitted.
+    void render(const Camera *pCamera);
+
+    /// Removes all meshes (existing MeshIds become invalid)
+    void clear();
+
+    const MeshRange &getMeshRange(MeshId mesh) const;
+    std::size_t getNumMeshes() const;
+    std::size_t getNumQueuedDraws() const;
+    int getDisplayMode() const;
+    const glm::vec3 &getShapeColor() const;
+    const glm::vec3 &getLightDir() const;
+    bool isFrustumCulling() const;
+    const CullStats &getCullStats() const; // of the last render
+
+    void setDisplayMode(int displayMode);
+    void setShapeColor(const glm::vec3 &shapeColor);
+    void setLightDir(const glm::vec3 &lightDir);
+    void setFrustumCulling(bool frustumCulling);
+
+private:
+    SeparablePrograms programs_;
+
+    std::shared_ptr<GLuint> spVbo_{nullptr};
+    std::shared_ptr<GLuint> spIbo_{nullptr};
+    std::shared_ptr<GLuint> spVao_{nullptr};
+    std::shared_ptr<GLuint> spCommandBuffer_{nullptr};
+    std::shared_ptr<GLuint> spDrawSsbo_{nullptr};
+
+    std::size_t vertexCapacity_;
+    std::size_t indexCapacity_;
+    std::size_t numVertices_{0};
+    std::size_t numIndices_{0};
+    std::size_t commandCapacity_{0};
+    std::size_t drawCapacity_{0};
+
+    std::vector<MeshRange> meshes_;
+    std::vector<BoundingSphere> meshSpheres_; // local space bounds of meshes_[i]
+    std::vector<DrawElementsIndirectCommand> commands_;
+    std::vector<InstanceData> draws_; // draws_[i] is used by commands_[i]
+    std::vector<MeshId> drawMeshes_; // and draws mesh drawMeshes_[i]
+
+    bool frustumCulling_{true};
+    CullStats cullStats_;
+    std::vector<float> cullX_, cullY_, cullZ_, cullRadius_; // world space spheres of the queued draws
+    std::vector<unsigned char> cullVisible_;
+
+    GLenum drawMode_;
+    int displayMode_{5};
+    glm::vec3 shapeColor_{1.0f}; // multiplied by the per draw colors
+    glm::vec3 lightDir_{0.7, 0.85, 1.0};
+
+    void reserve(std::size_t numVertices, std::size_t numIndices);
+    void cullDraws(const Camera &camera);
+};
+
+using PosNormTexMeshPool = sim::MeshPool<sim::PosNormTexVertex>;
+
+} // namespace sim
@@ -1,12 +1,50 @@
 #include <sim-driver/renderers/MeshRenderer.hpp>
+#include <sim-driver/meshes/MeshSimplifier.hpp>
+#include <sim-driver/Camera.hpp>
 #include <imgui.h>
+#include <algorithm>
 #include <iostream>
 
 namespace sim {
 
+namespace {
+
+constexpr int min_lod_divisions = 4;
+constexpr std::size_t max_simplified_chains = 4;
+
+} // namespace
+
 MeshRenderer::MeshRenderer(sim::PosNormTexMesh mesh) : mesh_{std::move(mesh)}
 {
-    renderer_.setDataFun([&]() -> const sim::DrawData<PosNormTexVertex> & { return mesh_.getMeshData(); });
+    renderer_.setDataFun([this] { return sim::PosNormTexDataView(mesh_.getMeshData()); });
+}
+
+void MeshRenderer::update(const Camera &camera)
+{
+    // meshes finished in the background are swapped in whether or not the GUI is shown
+    if (mesh_.pollData()) {
+        updateMeshBuffers();
+    }
+    pollLods();
+
+    if (lods_.size() > 1) {
+        sim::BoundingSphere sphere = sim::transform_sphere(bounds_, modelMatrix_);
+        float distance = glm::length(sphere.center - camera.getEyeVector()) - sphere.radius;
+        distance = std::max(distance, camera.getNearPlane());
+
+        const float scale = sim::max_scale(modelMatrix_);
+        for (std::size_t i = 0; i < lods_.size(); ++i) {
+            lodPixelErrors_[i] = sim::projected_size_pixels(lods_[i].error * scale,
+                                                            distance,
+                                                            camera.getFovYRadians(),
+                                                            viewportHeight_);
+        }
+
+        std::size_t level = lodSelector_.select(lodPixelErrors_);
+        if (level != currentLod_) {
+            useLod(level);
+        }
+    }
 }
 
 void MeshRenderer::render(float alpha, const Camera &camera) const
@@ -14,15 +52,67 @@ void MeshRenderer::render(float alpha, const Camera &camera) const
     renderer_.onRender(alpha, &camera);
 }
 
+void MeshRenderer::renderInstanced(float alpha,
+                                   const Camera &camera,
+                                   const InstanceData *pInstances,
+                                   std::size_t numInstances) const
+{
+    renderer_.onRenderInstanced(alpha, &camera, pInstances, numInstances);
+}
+
 void MeshRenderer::configureGui()
 {
     std::stringstream uid;
     uid << this;
     ImGui::PushID(uid.str().c_str());
+
     if (ImGui::CollapsingHeader("Mesh Options", "mesh_options", false, true)) {
         bool mesh_needs_update = mesh_.configureGui();
         if (mesh_needs_update) {
-            renderer_.rebuild_mesh();
+            updateMeshBuffers();
+        }
+
+        bool caching = (spCache_ != nullptr);
+        if (ImGui::Checkbox("Cache Meshes", &caching)) {
+            setMeshCache(caching ? std::make_shared<sim::PosNormTexMeshCache>() : nullptr);
+        }
+
+        if (spCache_) {
+            const sim::MeshCacheStats &stats = spCache_->getStats();
+            ImGui::Text("Cache: %d hits, %d misses, %d meshes, %.1f / %.1f MB",
+                        static_cast<int>(stats.hits),
+                        static_cast<int>(stats.misses),
+                        static_cast<int>(stats.numEntries),
+                        static_cast<double>(stats.memoryBytes) / (1 << 20),
+                        static_cast<double>(stats.budgetBytes) / (1 << 20));
+        }
+
+        ImGui::Separator();
+
+        int lodMode = static_cast<int>(lodMode_);
+        if (ImGui::Combo("Level of Detail", &lodMode, " Off \0 Resolutions \0 Simplified \0\0")) {
+            setLodMode(static_cast<LodMode>(lodMode));
+        }
+
+        if (lodMode_ != LodMode::Off) {
+            float pixelError = lodSelector_.getPixelThreshold();
+            if (ImGui::SliderFloat("LOD Pixel Error", &pixelError, 0.1f, 10.0f)) {
+                setLodPixelError(pixelError);
+            }
+
+            int numLevels = numLodLevels_;
+            if (ImGui::SliderInt("LOD Levels", &numLevels, 2, 8)) {
+                setNumLodLevels(numLevels);
+            }
+
+            ImGui::Text("LOD: level %d of %d (%.2f px error)",
+                        static_cast<int>(currentLod_),
+                        static_cast<int>(lods_.size()),
+                        lodPixelErrors_.empty() ? 0.0 : static_cast<double>(lodPixelErrors_[currentLod_]));
+
+            if (upLodBuilder_ && upLodBuilder_->isBusy()) {
+                ImGui::Text("Building LODs...");
+            }
         }
     }
 
@@ -32,14 +122,230 @@ void MeshRenderer::configureGui()
     ImGui::PopID();
 }
 
+void MeshRenderer::updateMeshBuffers()
+{
+    // without levels or shared buffers the renderer's own buffers are refilled in place
+    if (lodMode_ == LodMode::Off && !spCache_) {
+        lods_.clear();
+        lodPixelErrors_.clear();
+        currentLod_ = 0;
+        renderer_.rebuild_mesh();
+        buildLods();
+        return;
+    }
+
+    const sim::PosNormTexData &data = mesh_.getMeshData();
+    bounds_ = sim::bounding_sphere(sim::compute_bounds(data.vbo.data(), data.vbo.size()));
+
+    // the full mesh is drawn on its own until the lower levels are ready
+    lods_.clear();
+    lods_.push_back({findOrCreateBuffers(mesh_.getMeshKey(), data), mesh_.getDrawMode(), 0.0f});
+    resetLodSelection();
+
+    buildLods();
+}
+
+sim::MeshBuffers MeshRenderer::findOrCreateBuffers(const sim::MeshKey &key, const sim::PosNormTexData &data)
+{
+    if (!spCache_) {
+        return sim::PosNormTexRenderer::createMeshBuffers(data);
+    }
+
+    // previously visited resolutions only need their buffers rebound
+    if (const sim::MeshBuffers *pBuffers = spCache_->findBuffers(key)) {
+        return *pBuffers;
+    }
+
+    sim::MeshBuffers buffers = sim::PosNormTexRenderer::createMeshBuffers(data);
+    spCache_->setBuffers(key, buffers);
+    return buffers;
+}
+
+void MeshRenderer::buildLods()
+{
+    // levels requested for a previous mesh or setting are out of date
+    if (upLodBuilder_) {
+        upLodBuilder_->cancel();
+    }
+    if (lodMode_ == LodMode::Off) {
+        return;
+    }
+    if (!upLodBuilder_) {
+        upLodBuilder_ = std::make_unique<sim::AsyncLodBuilder>();
+    }
+
+    const sim::MeshKey key = mesh_.getMeshKey();
+    const GLenum drawMode = mesh_.getDrawMode();
+    std::shared_ptr<const sim::PosNormTexData> spData = mesh_.getSharedMeshData();
+
+    if (lodMode_ == LodMode::Resolutions) {
+        std::vector<sim::LodLevelData> levels{{key, spData, drawMode, 0.0f}};
+
+        int divisor = 2;
+        for (int level = 1; level < numLodLevels_; ++level, divisor *= 2) {
+            int u = key.uDivisions / divisor;
+            int v = key.vDivisions / divisor;
+            if (u < min_lod_divisions || v < min_lod_divisions) {
+                break;
+            }
+
+            // cached resolutions are shared with the worker, the others are generated there
+            sim::MeshKey levelKey = mesh_.makeKey(u, v);
+            levels.push_back({levelKey,
+                              spCache_ ? spCache_->findData(levelKey) : nullptr,
+                              mesh_.getDrawMode(levelKey),
+                              0.0f});
+        }
+
+        sim::PosNormTexMesh::MeshDataFun generateFun = mesh_.getGenerateFunction();
+        if (levels.size() < 2 || !generateFun) {
+            return;
+        }
+
+        upLodBuilder_->submit([levels, generateFun]() mutable {
+            for (std::size_t i = 0; i < levels.size(); ++i) {
+                sim::LodLevelData &level = levels[i];
+                if (!level.spData) {
+                    level.spData = std::make_shared<const sim::PosNormTexData>(
+                        generateFun(level.key.uDivisions, level.key.vDivisions));
+                }
+
+                // keep the errors ascending even if the estimate isn't
+                level.error = sim::estimate_tessellation_error(*level.spData, level.drawMode);
+                if (i > 0) {
+                    level.error = std::max(levels[i - 1].error, level.error);
+                }
+            }
+            return levels;
+        });
+
+    } else if (lodMode_ == LodMode::Simplified && !spData->ibo.empty()) {
+        auto iter = std::find_if(simplifiedChains_.begin(), simplifiedChains_.end(), [&](const SimplifiedChain &chain) {
+            return chain.source == key && chain.numLevels == numLodLevels_;
+        });
+
+        // simplifying is slow so chains of recently shown meshes are kept around
+        if (iter != simplifiedChains_.end()) {
+            simplifiedChains_.splice(simplifiedChains_.begin(), simplifiedChains_, iter);
+            lods_.insert(lods_.end(), iter->levels.begin(), iter->levels.end());
+            resetLodSelection();
+            return;
+        }
+
+        const int numLevels = numLodLevels_;
+        upLodBuilder_->submit([spData, drawMode, numLevels] {
+            std::size_t numTriangles = sim::to_triangle_list(spData->ibo, drawMode).size() / 3;
+            std::vector<sim::MeshLod> chain
+                = sim::create_lod_chain(*spData, drawMode, sim::make_lod_targets(numTriangles, numLevels - 1));
+
+            // level 0 of the chain is the mesh itself which is already uploaded
+            std::vector<sim::LodLevelData> levels;
+            for (std::size_t level = 1; level < chain.size(); ++level) {
+                levels.push_back({{0, 0, 0, 0, 0},
+                                  std::make_shared<const sim::PosNormTexData>(std::move(chain[level].data)),
+                                  GL_TRIANGLES,
+                                  chain[level].error});
+            }
+            return levels;
+        });
+    }
+}
+
+void MeshRenderer::pollLods()
+{
+    std::vector<sim::LodLevelData> levels;
+    if (!upLodBuilder_ || !upLodBuilder_->poll(&levels)) {
+        return;
+    }
+
+    if (lodMode_ == LodMode::Resolutions) {
+        lods_.resize(1);
+        lods_[0].error = levels[0].error;
+
+        for (std::size_t i = 1; i < levels.size(); ++i) {
+            const sim::LodLevelData &level = levels[i];
+            if (spCache_ && !spCache_->findData(level.key)) {
+                spCache_->insert(level.key, level.spData);
+            }
+            lods_.push_back({findOrCreateBuffers(level.key, *level.spData), level.drawMode, level.error});
+        }
+
+    } else if (lodMode_ == LodMode::Simplified) {
+        SimplifiedChain chain{mesh_.getMeshKey(), numLodLevels_, {}};
+        for (const sim::LodLevelData &level : levels) {
+            chain.levels.push_back(
+                {sim::PosNormTexRenderer::createMeshBuffers(*level.spData), level.drawMode, level.error});
+        }
+
+        lods_.resize(1);
+        lods_.insert(lods_.end(), chain.levels.begin(), chain.levels.end());
+
+        simplifiedChains_.push_front(std::move(chain));
+        if (simplifiedChains_.size() > max_simplified_chains) {
+            simplifiedChains_.pop_back();
+        }
+    }
+
+    resetLodSelection();
+}
+
+void MeshRenderer::resetLodSelection()
+{
+    lodPixelErrors_.assign(lods_.size(), 0.0f);
+    lodSelector_.reset();
+    useLod(0);
+}
+
+void MeshRenderer::useLod(std::size_t level)
+{
+    currentLod_ = level;
+    renderer_.setMeshBuffers(lods_[level].buffers);
+    renderer_.setDrawMode(lods_[level].drawMode);
+}
+
 void MeshRenderer::resize(int width, int height)
 {
+    viewportHeight_ = height;
     renderer_.onResize(width, height);
 }
 
 void MeshRenderer::setModelMatrix(const glm::mat4 &modelMatrix)
 {
+    modelMatrix_ = modelMatrix;
     renderer_.setModelMatrix(modelMatrix);
 }
 
+void MeshRenderer::setMeshCache(std::shared_ptr<sim::PosNormTexMeshCache> spCache)
+{
+    spCache_ = std::move(spCache);
+    mesh_.setCache(spCache_);
+    updateMeshBuffers();
+}
+
+void MeshRenderer::setLodMode(LodMode lodMode)
+{
+    if (lodMode != lodMode_) {
+        lodMode_ = lodMode;
+        updateMeshBuffers();
+    }
+}
+
+void MeshRenderer::setLodPixelError(float pixels)
+{
+    lodSelector_.setPixelThreshold(pixels);
+}
+
+void MeshRenderer::setNumLodLevels(int numLevels)
+{
+    if (numLevels != numLodLevels_) {
+        numLodLevels_ = std::max(1, numLevels);
+        updateMeshBuffers();
+    }
+}
+
+std::size_t MeshRenderer::getLodLevel() const
+{
+    return currentLod_;
+}
+
 } // namespace sim
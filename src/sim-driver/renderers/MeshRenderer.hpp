@@ -1,24 +1,91 @@
 #pragma once
 
 #include <sim-driver/OpenGLTypes.hpp>
+#include <sim-driver/Bounds.hpp>
+#include <sim-driver/meshes/AsyncLodBuilder.hpp>
 #include <sim-driver/meshes/MeshHelper.hpp>
+#include <sim-driver/renderers/LodSelector.hpp>
+#include <list>
 
 namespace sim {
 
+enum class LodMode : int
+{
+    Off, // always draw the mesh chosen on the sliders
+    Resolutions, // lower generator resolutions
+    Simplified, // quadric simplification of the current mesh
+};
+
 class MeshRenderer
 {
 public:
     explicit MeshRenderer(sim::PosNormTexMesh mesh);
 
+    /// Swaps in meshes and levels of detail finished in the background and selects the level
+    /// whose projected error fits the camera and viewport. Call once per frame before rendering.
+    void update(const Camera &camera);
+
+    /// Draws the level of detail selected by the last call to update
     void render(float alpha, const Camera &camera) const;
+
+    /// Uses the level of detail selected by the last call to update
+    void renderInstanced(float alpha,
+                         const Camera &camera,
+                         const InstanceData *pInstances,
+                         std::size_t numInstances) const;
     void configureGui();
 
     void resize(int width, int height);
     void setModelMatrix(const glm::mat4 &modelMatrix);
 
+    /// Shares generated meshes and their buffers through 'spCache' (nullptr, the default, disables caching)
+    void setMeshCache(std::shared_ptr<sim::PosNormTexMeshCache> spCache);
+
+    void setLodMode(LodMode lodMode);
+    void setLodPixelError(float pixels);
+    void setNumLodLevels(int numLevels);
+    std::size_t getLodLevel() const;
+
 private:
+    struct LodLevel
+    {
+        sim::MeshBuffers buffers;
+        GLenum drawMode;
+        float error; // model units
+    };
+
+    struct SimplifiedChain
+    {
+        sim::MeshKey source;
+        int numLevels;
+        std::vector<LodLevel> levels; // below the source mesh
+    };
+
     sim::PosNormTexRenderer renderer_;
     sim::PosNormTexMesh mesh_;
+    std::shared_ptr<sim::PosNormTexMeshCache> spCache_{nullptr};
+
+    LodMode lodMode_{LodMode::Off};
+    int numLodLevels_{5}; // including the full resolution mesh
+    std::vector<LodLevel> lods_;
+    std::vector<float> lodPixelErrors_;
+    sim::LodSelector lodSelector_;
+    std::size_t currentLod_{0};
+
+    // the levels below the current mesh are built in the background and swapped in by pollLods
+    std::unique_ptr<sim::AsyncLodBuilder> upLodBuilder_{nullptr}; // created once LODs are turned on
+    std::list<SimplifiedChain> simplifiedChains_; // most recently used first
+
+    sim::BoundingSphere bounds_; // of the current mesh in local space
+    glm::mat4 modelMatrix_{1};
+    int viewportHeight_{720};
+
+    void updateMeshBuffers();
+    sim::MeshBuffers findOrCreateBuffers(const sim::MeshKey &key, const sim::PosNormTexData &data);
+    void buildLods();
+    void pollLods();
+    void resetLodSelection();
+    void useLod(std::size_t level);
 };
 
 } // namespace sim
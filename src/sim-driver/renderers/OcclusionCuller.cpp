@@ -0,0 +1,275 @@
+#include <sim-driver/renderers/OcclusionCuller.hpp>
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <sim-driver/OpenGLHelper.hpp>
+#include <sim-driver/Camera.hpp>
+#include <sim-driver/ShaderConfig.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace sim {
+
+namespace {
+
+constexpr int box_indices = 36;
+
+glm::mat4 world_from_unit_box(const AABB &box)
+{
+    glm::mat4 matrix{1};
+    const glm::vec3 size = box.upper - box.lower;
+    matrix[0][0] = size.x;
+    matrix[1][1] = size.y;
+    matrix[2][2] = size.z;
+    matrix[3] = glm::vec4(box.lower, 1.0f);
+    return matrix;
+}
+
+} // namespace
+
+OcclusionAction OcclusionState::next(long long frame, int retestInterval, bool eyeInside)
+{
+    if (visible_ || eyeInside) {
+        if (eyeInside || pending_ || frame - lastQueryFrame_ < retestInterval) {
+            return OcclusionAction::Draw;
+        }
+        pending_ = true;
+        lastQueryFrame_ = frame;
+        return OcclusionAction::DrawInQuery;
+    }
+
+    if (pending_) {
+        return OcclusionAction::ConditionalDraw;
+    }
+    pending_ = true;
+    lastQueryFrame_ = frame;
+    return OcclusionAction::BoxQueryThenConditionalDraw;
+}
+
+void OcclusionState::setResult(bool visible)
+{
+    visible_ = visible;
+    pending_ = false;
+}
+
+bool OcclusionState::isVisible() const
+{
+    return visible_;
+}
+
+bool OcclusionState::isPending() const
+{
+    return pending_;
+}
+
+bool is_eye_inside(const Camera &camera, const AABB &worldBox)
+{
+    // distance from the eye to the corners of the near plane
+    const float tanHalfFov = std::tan(camera.getFovYRadians() * 0.5f);
+    const float nearHeight = tanHalfFov;
+    const float nearWidth = tanHalfFov * camera.getAspectRatio();
+    const float margin = camera.getNearPlane() * std::sqrt(1.0f + nearHeight * nearHeight + nearWidth * nearWidth);
+
+    const glm::vec3 &eye = camera.getEyeVector();
+    for (int axis = 0; axis < 3; ++axis) {
+        if (eye[axis] < worldBox.lower[axis] - margin || eye[axis] > worldBox.upper[axis] + margin) {
+            return false;
+        }
+    }
+    return true;
+}
+
+OcclusionCuller::OcclusionCuller()
+{
+#ifdef __APPLE__
+    queryTarget_ = GL_ANY_SAMPLES_PASSED;
+#else
+    queryTarget_ = GL_ANY_SAMPLES_PASSED_CONSERVATIVE;
+#endif
+
+    programs_ = OpenGLHelper::createSeparablePrograms(sim::shader_path() + "shader_bounds.vert");
+    glUseProgramStages(*programs_.pipeline, GL_VERTEX_SHADER_BIT, *programs_.vert);
+
+    const sim::PosVertex corners[8] = {{{0, 0, 0}},
+                                       {{1, 0, 0}},
+                                       {{0, 1, 0}},
+                                       {{1, 1, 0}},
+                                       {{0, 0, 1}},
+                                       {{1, 0, 1}},
+                                       {{0, 1, 1}},
+                                       {{1, 1, 1}}};
+
+    // both sides of every face are drawn so the winding doesn't matter
+    const unsigned indices[box_indices] = {0, 1, 3, 0, 3, 2, // -z
+                                           4, 5, 7, 4, 7, 6, // +z
+                                           0, 1, 5, 0, 5, 4, // -y
+                                           2, 3, 7, 2, 7, 6, // +y
+                                           0, 2, 6, 0, 6, 4, // -x
+                                           1, 3, 7, 1, 7, 5}; // +x
+
+    spBoxVbo_ = OpenGLHelper::createBuffer(corners, 8);
+    spBoxIbo_ = OpenGLHelper::createBuffer(indices, box_indices, GL_ELEMENT_ARRAY_BUFFER);
+    spBoxVao_ = OpenGLHelper::createVao<sim::PosVertex>(spBoxVbo_);
+}
+
+OcclusionCuller::ObjectId OcclusionCuller::addObject()
+{
+    Object object;
+    object.query = OpenGLHelper::createQuery();
+    objects_.push_back(object);
+    return objects_.size() - 1;
+}
+
+void OcclusionCuller::clear()
+{
+    objects_.clear();
+}
+
+void OcclusionCuller::beginFrame(const Camera &camera)
+{
+    pCamera_ = &camera;
+    frustum_ = extract_frustum(camera.getPerspectiveScreenFromWorldMatrix());
+    stats_ = {};
+    ++frame_;
+
+    // restored after every box query, reading them there would stall on some drivers
+    glGetBooleanv(GL_COLOR_WRITEMASK, frameState_.colorMask);
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &frameState_.depthMask);
+    frameState_.culling = glIsEnabled(GL_CULL_FACE) != 0;
+}
+
+bool OcclusionCuller::render(ObjectId object, const AABB &worldBox, const std::function<void(void)> &draw)
+{
+    if (pCamera_ == nullptr) {
+        throw std::runtime_error("OcclusionCuller::beginFrame must be called before rendering objects");
+    }
+    if (object >= objects_.size()) {
+        throw std::runtime_error("Invalid occlusion object id: " + std::to_string(object));
+    }
+
+    // the last result stays valid for when the object comes back into view
+    if (!intersects(frustum_, worldBox)) {
+        ++stats_.frustumCulled;
+        return false;
+    }
+
+    Object &obj = objects_[object];
+    pollResult(&obj);
+
+    const OcclusionAction action = obj.state.next(frame_, retestInterval_, is_eye_inside(*pCamera_, worldBox));
+
+    if (action == OcclusionAction::Draw) {
+        ++stats_.visible;
+        draw();
+        return true;
+    }
+
+    if (action == OcclusionAction::DrawInQuery) {
+        ++stats_.visible;
+        ++stats_.queries;
+
+        glBeginQuery(queryTarget_, *obj.query);
+        OpenGLHelper::setOcclusionQueryActive(true);
+        draw();
+        OpenGLHelper::setOcclusionQueryActive(false);
+        glEndQuery(queryTarget_);
+        return true;
+    }
+
+    ++stats_.conditional;
+
+    if (action == OcclusionAction::BoxQueryThenConditionalDraw) {
+        renderBoxQuery(&obj, worldBox);
+    }
+
+    // drawn unless the newest query failed, decided on the GPU without waiting for the result
+    glBeginConditionalRender(*obj.query, GL_QUERY_NO_WAIT);
+    draw();
+    glEndConditionalRender();
+    return true;
+}
+
+template <typename Vertex>
+bool OcclusionCuller::render(ObjectId object, const RendererHelper<Vertex> &renderer, float alpha)
+{
+    auto draw = [&] { renderer.onRender(alpha, pCamera_); };
+
+    if (renderer.getBounds().isEmpty()) {
+        draw();
+        return true;
+    }
+
+    const glm::mat4 worldFromAttributes = renderer.getModelMatrix() * renderer.getLocalFromQuantizedMatrix();
+    return render(object, transform_box(renderer.getBounds(), worldFromAttributes), draw);
+}
+
+bool OcclusionCuller::wasVisible(ObjectId object) const
+{
+    return objects_.at(object).state.isVisible();
+}
+
+const OcclusionStats &OcclusionCuller::getStats() const
+{
+    return stats_;
+}
+
+int OcclusionCuller::getRetestInterval() const
+{
+    return retestInterval_;
+}
+
+void OcclusionCuller::setRetestInterval(int frames)
+{
+    retestInterval_ = std::max(1, frames);
+}
+
+void OcclusionCuller::pollResult(Object *pObject) const
+{
+    if (!pObject->state.isPending()) {
+        return;
+    }
+
+    GLuint available = 0;
+    glGetQueryObjectuiv(*pObject->query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if (available) {
+        GLuint samplesPassed = 0;
+        glGetQueryObjectuiv(*pObject->query, GL_QUERY_RESULT, &samplesPassed);
+        pObject->state.setResult(samplesPassed != 0);
+    }
+}
+
+void OcclusionCuller::renderBoxQuery(Object *pObject, const AABB &worldBox)
+{
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    glDisable(GL_CULL_FACE);
+
+    glUseProgram(0);
+    glBindProgramPipeline(*programs_.pipeline);
+
+    const glm::mat4 worldFromBox = world_from_unit_box(worldBox);
+    sim::OpenGLHelper::setMatrixUniform(programs_.vert,
+                                        "screen_from_world",
+                                        glm::value_ptr(pCamera_->getPerspectiveScreenFromWorldMatrix()));
+    sim::OpenGLHelper::setMatrixUniform(programs_.vert, "world_from_box", glm::value_ptr(worldFromBox));
+
+    glBeginQuery(queryTarget_, *pObject->query);
+    sim::OpenGLHelper::renderBuffer(spBoxVao_, 0, box_indices, GL_TRIANGLES, spBoxIbo_);
+    glEndQuery(queryTarget_);
+    ++stats_.queries;
+
+    const GLboolean *colorMask = frameState_.colorMask;
+    glColorMask(colorMask[0], colorMask[1], colorMask[2], colorMask[3]);
+    glDepthMask(frameState_.depthMask);
+    if (frameState_.culling) {
+        glEnable(GL_CULL_FACE);
+    }
+}
+
+template bool OcclusionCuller::render(ObjectId, const RendererHelper<sim::PosNormTexVertex> &, float);
+template bool OcclusionCuller::render(ObjectId, const RendererHelper<sim::PosVertex> &, float);
+template bool OcclusionCuller::render(ObjectId, const RendererHelper<sim::PackedPosNormTexVertex> &, float);
+
+} // namespace sim
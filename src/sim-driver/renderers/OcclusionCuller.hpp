@@ -0,0 +1,128 @@
+#pragma once
+
+#include <sim-driver/OpenGLTypes.hpp>
+#include <sim-driver/Frustum.hpp>
+#include <glm/glm.hpp>
+#include <functional>
+#include <vector>
+
+namespace sim {
+
+struct OcclusionStats
+{
+    std::size_t visible{0}; // drawn normally
+    std::size_t conditional{0}; // hidden last time, drawn only if this frame's box query passes
+    std::size_t frustumCulled{0};
+    std::size_t queries{0};
+};
+
+/// How OcclusionCuller draws an object in view
+enum class OcclusionAction
+{
+    Draw,
+    DrawInQuery, // the draw itself is the query
+    BoxQueryThenConditionalDraw,
+    ConditionalDraw, // on the box query that is still in flight
+};
+
+/// The per object decisions of OcclusionCuller, kept apart from the GL queries
+class OcclusionState
+{
+public:
+    /// Decides how to draw the object in 'frame' and marks a query as pending if one is issued.
+    /// Objects the eye is (nearly) inside of are always drawn without a query.
+    OcclusionAction next(long long frame, int retestInterval, bool eyeInside);
+
+    /// Stores the result of the pending query
+    void setResult(bool visible);
+
+    bool isVisible() const; // as of the latest result
+    bool isPending() const;
+
+private:
+    bool visible_{true};
+    bool pending_{false};
+    long long lastQueryFrame_{-1};
+};
+
+/// True if 'worldBox' is close enough to the eye for the near plane to clip it, in which
+/// case an occlusion query of the box can't be trusted
+bool is_eye_inside(const Camera &camera, const AABB &worldBox);
+
+/// Hardware occlusion culling with temporal coherence. Objects are drawn front to back by
+/// the caller through 'render' and nothing ever waits on the GPU:
+///
+/// - Results are only read once they are available, usually a frame or two later.
+/// - Objects that were visible are drawn normally. Every 'retestInterval' frames their own
+///   draw is wrapped in a query so no extra geometry is submitted for them.
+/// - Objects that were hidden get their bounding box rendered into a query (without color
+///   or depth writes) and their draw is wrapped in a conditional render on that query, so
+///   the GPU skips it if the box is still hidden.
+///
+/// Queries use GL_ANY_SAMPLES_PASSED_CONSERVATIVE (GL_ANY_SAMPLES_PASSED on macOS). The color
+/// and depth write masks and face culling are read in beginFrame and restored to those values
+/// after every box query.
+class OcclusionCuller
+{
+public:
+    using ObjectId = std::size_t;
+
+    OcclusionCuller();
+
+    ObjectId addObject();
+
+    /// Removes all objects (existing ObjectIds become invalid)
+    void clear();
+
+    /// Call once per frame before rendering objects with 'camera'
+    void beginFrame(const Camera &camera);
+
+    /// Calls 'draw' unless 'worldBox' is outside of the frustum, possibly skipped on the GPU
+    /// if it was occluded. Returns false if the object is known to be culled. 'draw' may run
+    /// inside an occlusion query so it must check OpenGLHelper::isOcclusionQueryActive before
+    /// starting its own.
+    bool render(ObjectId object, const AABB &worldBox, const std::function<void(void)> &draw);
+
+    /// Same as above for a renderer using its bounds and model matrix
+    template <typename Vertex>
+    bool render(ObjectId object, const RendererHelper<Vertex> &renderer, float alpha);
+
+    bool wasVisible(ObjectId object) const; // as of the latest available result
+    const OcclusionStats &getStats() const; // since beginFrame
+    int getRetestInterval() const;
+
+    void setRetestInterval(int frames);
+
+private:
+    struct Object
+    {
+        std::shared_ptr<GLuint> query;
+        OcclusionState state;
+    };
+
+    struct RasterState
+    {
+        GLboolean colorMask[4];
+        GLboolean depthMask;
+        bool culling;
+    };
+
+    SeparablePrograms programs_;
+    std::shared_ptr<GLuint> spBoxVbo_;
+    std::shared_ptr<GLuint> spBoxIbo_;
+    std::shared_ptr<GLuint> spBoxVao_;
+    GLenum queryTarget_;
+
+    std::vector<Object> objects_;
+    const Camera *pCamera_{nullptr};
+    Frustum frustum_{};
+    long long frame_{0};
+    int retestInterval_{4};
+    OcclusionStats stats_;
+    RasterState frameState_{}; // read in beginFrame
+
+    void pollResult(Object *pObject) const;
+    void renderBoxQuery(Object *pObject, const AABB &worldBox);
+};
+
+} // namespace sim
@@ -1,22 +1,65 @@
 #include <sim-driver/renderers/RendererHelper.hpp>
 #include <sim-driver/OpenGLHelper.hpp>
+#include <sim-driver/VertexFormat.hpp>
 #include <sim-driver/Camera.hpp>
+#include <sim-driver/EyeRelative.hpp>
 #include <sim-driver/ShaderConfig.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
 #include <imgui.h>
 
 namespace sim {
 
 namespace {
 constexpr int max_point_size = 25;
+
+template <typename Vertex>
+std::string default_vert_shader()
+{
+    return "shader.vert";
+}
+
+template <>
+std::string default_vert_shader<sim::PackedPosNormTexVertex>()
+{
+    return "shader_packed.vert";
+}
+
+/// 16 bit indices halve the index fetch bandwidth. They can only be used when every
+/// vertex is addressable and the (32 bit) primitive restart index isn't used.
+bool fits_16_bit_indices(const unsigned *pIbo, std::size_t iboSize, std::size_t vboSize)
+{
+    if (vboSize > std::numeric_limits<GLushort>::max() + 1u) {
+        return false;
+    }
+    return std::find(pIbo, pIbo + iboSize, sim::primitiveRestart()) == pIbo + iboSize;
+}
+
+std::vector<GLushort> narrow_indices(const unsigned *pIbo, std::size_t iboSize)
+{
+    return std::vector<GLushort>(pIbo, pIbo + iboSize);
+}
+} // namespace
+
+double DepthPrepassStats::overdraw() const
+{
+    return shadedFragments == 0 ? 1.0 : static_cast<double>(fragments) / static_cast<double>(shadedFragments);
+}
+
+std::uint64_t DepthPrepassStats::savedFragments() const
+{
+    return fragments > shadedFragments ? fragments - shadedFragments : 0;
 }
 
 template <typename Vertex>
 RendererHelper<Vertex>::RendererHelper(std::string vertShader)
 {
     if (vertShader.empty()) {
-        vertShader = sim::shader_path() + "shader.vert";
+        vertShader = sim::shader_path() + default_vert_shader<Vertex>();
     }
     glIds_.programs = sim::OpenGLHelper::createSeparablePrograms(vertShader,
                                                                  sim::shader_path() + "shader.geom",
@@ -24,13 +67,160 @@ RendererHelper<Vertex>::RendererHelper(std::string vertShader)
 }
 
 template <typename Vertex>
-void RendererHelper<Vertex>::onRender(float alpha, const Camera *pCamera) const
+void RendererHelper<Vertex>::onRender(float, const Camera *pCamera) const
+{
+    renderFrame(getViewTransforms(pCamera));
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::onRender(float, const CameraD &camera) const
+{
+    renderFrame(getViewTransforms(camera));
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::renderFrame(const ViewTransforms &view) const
+{
+    cullStats_ = {};
+
+    // the write state only matters to the pre-pass and is read once for both draws
+    const RasterState *pState = nullptr;
+    if (displayMode_ == 6 && depthPrepass_ != DepthPrepass::Off) {
+        frameState_ = read_raster_state();
+        pState = &frameState_;
+    }
+
+    if (showNormals_) {
+        cullAndRender(view, pState, drawMode_, 1, shapeColor_, lightDir_, showNormals_, normalScale_, nullptr);
+    }
+
+    cullAndRender(view, pState, drawMode_, displayMode_, shapeColor_, lightDir_, false, normalScale_, nullptr);
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::onRenderInstanced(float,
+                                               const Camera *pCamera,
+                                               const InstanceData *pInstances,
+                                               std::size_t numInstances) const
 {
+    cullStats_ = {};
+
+    if (numInstances == 0 || !glIds_.vao) {
+        return;
+    }
+
+    if (frustumCulling_ && pCamera != nullptr && !bounds_.isEmpty()) {
+        const Frustum frustum = extract_frustum(pCamera->getPerspectiveScreenFromWorldMatrix());
+        // instance matrices replace the model matrix
+        const BoundingSphere localSphere = transform_sphere(bounding_sphere(bounds_), localFromQuantizedMatrix_);
+
+        visibleInstances_.clear();
+        cullStats_.visible = cull_instances(frustum, localSphere, pInstances, numInstances, &visibleInstances_);
+        cullStats_.culled = numInstances - cullStats_.visible;
+
+        if (visibleInstances_.empty()) {
+            return;
+        }
+        pInstances = visibleInstances_.data();
+        numInstances = visibleInstances_.size();
+    } else {
+        cullStats_.visible = numInstances;
+    }
+
+    if (!spInstancedVert_) {
+        spInstancedVert_ = OpenGLHelper::createSeparablePrograms(sim::shader_path() + "shader_instanced.vert").vert;
+    }
+
+    if (!spInstanceVbo_) {
+        spInstanceVbo_ = OpenGLHelper::createBuffer<InstanceData>(nullptr, 0, GL_ARRAY_BUFFER, GL_STREAM_DRAW);
+    }
+    OpenGLHelper::streamBuffer(spInstanceVbo_, &instanceCapacity_, pInstances, numInstances);
+
+    if (!spInstancedVao_) {
+        spInstancedVao_ = OpenGLHelper::createVao<Vertex>(glIds_.vbo);
+        OpenGLHelper::addVertexAttributes<InstanceData>(spInstancedVao_, spInstanceVbo_);
+    }
+
+    const auto instances = static_cast<int>(numInstances);
+
     if (showNormals_) {
-        customRender(alpha, pCamera, drawMode_, 1, shapeColor_, lightDir_, showNormals_, normalScale_);
+        renderMesh(spInstancedVert_,
+                   spInstancedVao_,
+                   instances,
+                   getViewTransforms(pCamera),
+                   drawMode_,
+                   1,
+                   shapeColor_,
+                   lightDir_,
+                   showNormals_,
+                   normalScale_,
+                   nullptr);
     }
 
-    customRender(alpha, pCamera, drawMode_, displayMode_, shapeColor_, lightDir_, false);
+    renderMesh(spInstancedVert_,
+               spInstancedVao_,
+               instances,
+               getViewTransforms(pCamera),
+               drawMode_,
+               displayMode_,
+               shapeColor_,
+               lightDir_,
+               false,
+               normalScale_,
+               nullptr);
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::onRenderMultiView(float,
+                                               const Camera *pCameras,
+                                               std::size_t numCameras,
+                                               MultiViewTarget target) const
+{
+    cullStats_ = {};
+
+    if (numCameras == 0 || !glIds_.vao) {
+        return;
+    }
+
+    const MultiViewBlock block = make_multi_view_block(pCameras, numCameras, target);
+
+    // drawn once if any of the views can see it
+    if (frustumCulling_ && !bounds_.isEmpty() && !glIds_.framebuffer) {
+        const AABB worldBox = transform_box(bounds_, modelMatrix_ * localFromQuantizedMatrix_);
+
+        bool visible = false;
+        for (std::size_t i = 0; i < numCameras && !visible; ++i) {
+            visible = intersects(extract_frustum(block.screenFromWorld[i]), worldBox);
+        }
+        if (!visible) {
+            ++cullStats_.culled;
+            return;
+        }
+    }
+    ++cullStats_.visible;
+
+    if (!spMultiViewGeom_) {
+        spMultiViewGeom_ = OpenGLHelper::createSeparablePrograms(sim::shader_path() + "shader_multiview.geom").geom;
+        spMultiViewUbo_ = OpenGLHelper::createBuffer(&block, 1, GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW);
+    } else {
+        OpenGLHelper::updateBuffer(spMultiViewUbo_, 0, 1, &block, GL_UNIFORM_BUFFER);
+    }
+    OpenGLHelper::setUboUniform(spMultiViewGeom_, spMultiViewUbo_, "MultiViews", 0);
+
+    ViewTransforms view = getViewTransforms(pCameras);
+    view.multiView = true;
+
+    renderMesh(glIds_.programs.vert,
+               glIds_.vao,
+               0,
+               view,
+               drawMode_,
+               displayMode_,
+               shapeColor_,
+               lightDir_,
+               false,
+               normalScale_,
+               nullptr);
 }
 
 template <typename Vertex>
@@ -53,6 +243,11 @@ void RendererHelper<Vertex>::onGuiRender()
         ImGui::Checkbox("Wireframe", &usingWireframe_);
     }
 
+    ImGui::Checkbox("Specialized Shaders", &shaderVariants_);
+    ImGui::Checkbox("Frustum Culling", &frustumCulling_);
+    ImGui::SameLine();
+    ImGui::Text("%d drawn, %d culled", static_cast<int>(cullStats_.visible), static_cast<int>(cullStats_.culled));
+
     ImGui::Separator();
 
     ImGui::Combo("Display Mode",
@@ -76,6 +271,19 @@ void RendererHelper<Vertex>::onGuiRender()
             ImGui::SliderFloat("Shape Roughness", &shapeRoughness_, 0.01f, 1.0f);
             ImGui::SliderFloat3("Shape Index of Refraction", glm::value_ptr(shapeIor_), 1.0f, 10.0f);
 
+            int depthPrepass = static_cast<int>(depthPrepass_);
+            if (ImGui::Combo("Depth Pre-pass", &depthPrepass, " Off \0 On \0 Auto \0\0")) {
+                depthPrepass_ = static_cast<DepthPrepass>(depthPrepass);
+            }
+            if (depthPrepass_ == DepthPrepass::Auto) {
+                ImGui::SliderFloat("Pre-pass Overdraw Threshold", &depthPrepassThreshold_, 1.0f, 4.0f);
+            }
+            ImGui::Text("Overdraw %.2fx, pre-pass %s, %llu of %llu fragments not shaded",
+                        depthPrepassStats_.overdraw(),
+                        depthPrepassStats_.active ? "on" : "off",
+                        static_cast<unsigned long long>(depthPrepassStats_.savedFragments()),
+                        static_cast<unsigned long long>(depthPrepassStats_.fragments));
+
 #ifdef __APPLE__
             ImGui::SliderFloat3("Light Direction", glm::value_ptr(lightDir_), -1, 1);
 #else
@@ -127,6 +335,227 @@ void RendererHelper<Vertex>::customRender(float,
                                           float NormalScale,
                                           std::function<void(void)> programReplacement) const
 {
+    cullAndRender(getViewTransforms(pCamera),
+                  nullptr,
+                  drawMode,
+                  displayMode,
+                  shapeColor,
+                  lightDir,
+                  showNormals,
+                  NormalScale,
+                  programReplacement);
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::customRender(float,
+                                          const CameraD &camera,
+                                          GLenum drawMode,
+                                          int displayMode,
+                                          glm::vec3 shapeColor,
+                                          glm::vec3 lightDir,
+                                          bool showNormals,
+                                          float NormalScale,
+                                          std::function<void(void)> programReplacement) const
+{
+    cullAndRender(getViewTransforms(camera),
+                  nullptr,
+                  drawMode,
+                  displayMode,
+                  shapeColor,
+                  lightDir,
+                  showNormals,
+                  NormalScale,
+                  programReplacement);
+}
+
+template <typename Vertex>
+typename RendererHelper<Vertex>::ViewTransforms RendererHelper<Vertex>::getViewTransforms(const Camera *pCamera) const
+{
+    ViewTransforms view;
+    view.worldFromLocal = modelMatrix_;
+
+    if (pCamera != nullptr) {
+        view.hasCamera = true;
+        view.screenFromWorld = pCamera->getPerspectiveScreenFromWorldMatrix();
+        view.eye = pCamera->getEyeVector();
+    }
+    return view;
+}
+
+template <typename Vertex>
+typename RendererHelper<Vertex>::ViewTransforms RendererHelper<Vertex>::getViewTransforms(const CameraD &camera) const
+{
+    // the shaders see eye space as their world space
+    const EyeRelativeTransforms transforms = eye_relative_transforms(camera, modelMatrixD_);
+
+    ViewTransforms view;
+    view.hasCamera = true;
+    view.screenFromWorld = transforms.screenFromEye;
+    view.eye = transforms.eye;
+    view.worldFromLocal = transforms.eyeFromLocal;
+    return view;
+}
+
+template <typename Vertex>
+typename RendererHelper<Vertex>::RasterState RendererHelper<Vertex>::read_raster_state()
+{
+    RasterState state;
+    glGetBooleanv(GL_COLOR_WRITEMASK, state.colorMask);
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &state.depthMask);
+    glGetIntegerv(GL_DEPTH_FUNC, &state.depthFunc);
+    return state;
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::cullAndRender(const ViewTransforms &view,
+                                           const RasterState *pState,
+                                           GLenum drawMode,
+                                           int displayMode,
+                                           glm::vec3 shapeColor,
+                                           glm::vec3 lightDir,
+                                           bool showNormals,
+                                           float NormalScale,
+                                           const std::function<void(void)> &programReplacement) const
+{
+    // offscreen targets are cleared by renderMesh so their draws are never skipped
+    if (frustumCulling_ && view.hasCamera && !bounds_.isEmpty() && !glIds_.framebuffer) {
+        const Frustum frustum = extract_frustum(view.screenFromWorld);
+        if (!intersects(frustum, transform_box(bounds_, view.worldFromLocal * localFromQuantizedMatrix_))) {
+            ++cullStats_.culled;
+            return;
+        }
+    }
+    ++cullStats_.visible;
+
+    auto render = [&](bool depthOnly) {
+        renderMesh(glIds_.programs.vert,
+                   glIds_.vao,
+                   0,
+                   view,
+                   drawMode,
+                   displayMode,
+                   shapeColor,
+                   lightDir,
+                   showNormals,
+                   NormalScale,
+                   programReplacement,
+                   depthOnly);
+    };
+
+    if (!usesDepthPrepass(displayMode, showNormals, programReplacement != nullptr)) {
+        render(false);
+        return;
+    }
+
+    if (!spDepthFrag_) {
+        spDepthFrag_ = OpenGLHelper::createSeparablePrograms(sim::shader_path() + "shader_depth.frag").frag;
+        spDepthQuery_ = OpenGLHelper::createQuery();
+        spShadedQuery_ = OpenGLHelper::createQuery();
+    }
+
+    // sample queries can't start inside an enclosing occlusion query (e.g. of an OcclusionCuller)
+    const bool measure = !depthQueriesPending_ && !OpenGLHelper::isOcclusionQueryActive();
+
+    const RasterState state = pState ? *pState : read_raster_state();
+
+    // depth only: every fragment that would have been shaded passes here
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    if (measure) {
+        glBeginQuery(GL_SAMPLES_PASSED, *spDepthQuery_);
+    }
+    render(true);
+    if (measure) {
+        glEndQuery(GL_SAMPLES_PASSED);
+    }
+
+    // the same vertex program produces the same depths so only the front-most fragments pass
+    glColorMask(state.colorMask[0], state.colorMask[1], state.colorMask[2], state.colorMask[3]);
+    glDepthFunc(GL_EQUAL);
+    glDepthMask(GL_FALSE);
+    if (measure) {
+        glBeginQuery(GL_SAMPLES_PASSED, *spShadedQuery_);
+    }
+    render(false);
+    if (measure) {
+        glEndQuery(GL_SAMPLES_PASSED);
+        depthQueriesPending_ = true;
+    }
+
+    glDepthFunc(static_cast<GLenum>(state.depthFunc));
+    glDepthMask(state.depthMask);
+}
+
+template <typename Vertex>
+bool RendererHelper<Vertex>::usesDepthPrepass(int displayMode, bool showNormals, bool replacedProgram) const
+{
+    // only the advanced shading is expensive enough, and offscreen targets are cleared per pass
+    const bool eligible = displayMode == 6 && depthPrepass_ != DepthPrepass::Off && !showNormals && !replacedProgram
+        && !showingVertsOnly_ && !glIds_.framebuffer;
+
+    if (!eligible) {
+        return false;
+    }
+
+    pollDepthPrepassQueries();
+
+    // Auto still runs the pre-pass every few draws to measure the overdraw
+    bool use = depthPrepass_ == DepthPrepass::On || depthPrepassProfitable_;
+    if (!use && !depthQueriesPending_) {
+        use = depthPrepassDraws_ % depthPrepassInterval_ == 0;
+    }
+    ++depthPrepassDraws_;
+
+    depthPrepassStats_.active = use;
+    return use;
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::pollDepthPrepassQueries() const
+{
+    if (!depthQueriesPending_) {
+        return;
+    }
+
+    // the shading query ends last so both results are ready once it is
+    GLuint available = 0;
+    glGetQueryObjectuiv(*spShadedQuery_, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return;
+    }
+
+    GLuint64 fragments = 0;
+    GLuint64 shadedFragments = 0;
+    glGetQueryObjectui64v(*spDepthQuery_, GL_QUERY_RESULT, &fragments);
+    glGetQueryObjectui64v(*spShadedQuery_, GL_QUERY_RESULT, &shadedFragments);
+    depthQueriesPending_ = false;
+
+    depthPrepassStats_.fragments = fragments;
+    depthPrepassStats_.shadedFragments = shadedFragments;
+    depthPrepassProfitable_ = depthPrepassStats_.overdraw() > depthPrepassThreshold_;
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::renderMesh(const std::shared_ptr<GLuint> &spVert,
+                                        const std::shared_ptr<GLuint> &spVao,
+                                        int instances,
+                                        const ViewTransforms &view,
+                                        GLenum drawMode,
+                                        int displayMode,
+                                        glm::vec3 shapeColor,
+                                        glm::vec3 lightDir,
+                                        bool showNormals,
+                                        float NormalScale,
+                                        const std::function<void(void)> &programReplacement,
+                                        bool depthOnly) const
+{
+    auto render = [&](int verts, GLenum mode, const std::shared_ptr<GLuint> &spIbo) {
+        if (instances > 0) {
+            sim::OpenGLHelper::renderBufferInstanced(spVao, 0, verts, mode, instances, spIbo, nullptr, iboType_);
+        } else {
+            sim::OpenGLHelper::renderBuffer(spVao, 0, verts, mode, spIbo, nullptr, iboType_);
+        }
+    };
+
     if (glIds_.framebuffer) {
         glBindFramebuffer(GL_FRAMEBUFFER, *glIds_.framebuffer);
         glViewport(0, 0, fboWidth_, fboHeight_);
@@ -137,45 +566,52 @@ void RendererHelper<Vertex>::customRender(float,
         programReplacement();
     } else {
         glUseProgram(0);
-        glUseProgramStages(*glIds_.programs.pipeline, GL_VERTEX_SHADER_BIT, *glIds_.programs.vert);
-        glUseProgramStages(*glIds_.programs.pipeline, GL_GEOMETRY_SHADER_BIT, showNormals ? *glIds_.programs.geom : 0);
-        glUseProgramStages(*glIds_.programs.pipeline, GL_FRAGMENT_SHADER_BIT, *glIds_.programs.frag);
+        glUseProgramStages(*glIds_.programs.pipeline, GL_VERTEX_SHADER_BIT, *spVert);
+        const GLuint geom = view.multiView ? *spMultiViewGeom_ : (showNormals ? *glIds_.programs.geom : 0);
+        glUseProgramStages(*glIds_.programs.pipeline, GL_GEOMETRY_SHADER_BIT, geom);
+        const std::shared_ptr<GLuint> &spFrag = depthOnly ? spDepthFrag_ : getFragmentProgram(displayMode);
+        glUseProgramStages(*glIds_.programs.pipeline, GL_FRAGMENT_SHADER_BIT, *spFrag);
         glBindProgramPipeline(*glIds_.programs.pipeline);
 
         lightDir = glm::normalize(lightDir);
-        if (pCamera != nullptr) {
-            sim::OpenGLHelper::setMatrixUniform(glIds_.programs.vert,
-                                                "screen_from_world",
-                                                glm::value_ptr(pCamera->getPerspectiveScreenFromWorldMatrix()));
-            sim::OpenGLHelper::setFloatUniform(glIds_.programs.frag, "eye", glm::value_ptr(pCamera->getEyeVector()), 3);
+        if (view.hasCamera) {
+            sim::OpenGLHelper::setMatrixUniform(spVert, "screen_from_world", glm::value_ptr(view.screenFromWorld));
+            sim::OpenGLHelper::setFloatUniform(spFrag, "eye", glm::value_ptr(view.eye), 3);
         }
-        sim::OpenGLHelper::setMatrixUniform(glIds_.programs.vert, "world_from_local", glm::value_ptr(modelMatrix_));
-        sim::OpenGLHelper::setMatrixUniform(glIds_.programs.vert,
+        sim::OpenGLHelper::setMatrixUniform(spVert, "world_from_local", glm::value_ptr(view.worldFromLocal));
+        sim::OpenGLHelper::setMatrixUniform(spVert,
                                             "world_from_local_normals",
                                             glm::value_ptr(normalMatrix_),
                                             3);
+        sim::OpenGLHelper::setMatrixUniform(spVert,
+                                            "local_from_quantized",
+                                            glm::value_ptr(localFromQuantizedMatrix_));
+        sim::OpenGLHelper::setFloatUniform(spVert, "tex_from_quantized", glm::value_ptr(texFromQuantized_), 4);
 
         if (showNormals) {
-            if (pCamera != nullptr) {
+            if (view.hasCamera) {
                 sim::OpenGLHelper::setMatrixUniform(glIds_.programs.geom,
                                                     "screen_from_world",
-                                                    glm::value_ptr(pCamera->getPerspectiveScreenFromWorldMatrix()));
+                                                    glm::value_ptr(view.screenFromWorld));
             }
             sim::OpenGLHelper::setFloatUniform(glIds_.programs.geom, "normal_scale", &NormalScale);
         }
 
         if (glIds_.texture) {
-            sim::OpenGLHelper::setTextureUniform(glIds_.programs.frag, "tex", glIds_.texture, 0);
+            sim::OpenGLHelper::setTextureUniform(spFrag, "tex", glIds_.texture, 0);
         }
 
-        sim::OpenGLHelper::setIntUniform(glIds_.programs.frag, "displayMode", &displayMode);
-        sim::OpenGLHelper::setFloatUniform(glIds_.programs.frag, "shapeColor", glm::value_ptr(shapeColor), 3);
-        sim::OpenGLHelper::setFloatUniform(glIds_.programs.frag, "lightDir", glm::value_ptr(lightDir), 3);
-        sim::OpenGLHelper::setFloatUniform(glIds_.programs.frag, "roughness", &shapeRoughness_);
-        sim::OpenGLHelper::setFloatUniform(glIds_.programs.frag, "IOR", glm::value_ptr(shapeIor_), 3);
+        sim::OpenGLHelper::setIntUniform(spFrag, "displayMode", &displayMode);
+        sim::OpenGLHelper::setUintUniform(spFrag, "object_id", &objectId_);
+        sim::OpenGLHelper::setFloatUniform(spFrag, "shapeColor", glm::value_ptr(shapeColor), 3);
+        sim::OpenGLHelper::setFloatUniform(spFrag, "lightDir", glm::value_ptr(lightDir), 3);
+        sim::OpenGLHelper::setFloatUniform(spFrag, "roughness", &shapeRoughness_);
+        sim::OpenGLHelper::setFloatUniform(spFrag, "IOR", glm::value_ptr(shapeIor_), 3);
 
-        if (spLightSsbo_) {
-            sim::OpenGLHelper::setSsboUniform(glIds_.programs.frag,
+        // every variant declares the light block but only advanced shading reads it, elsewhere the
+        // compiler strips it so it has no block index to bind
+        if (spLightSsbo_ && !depthOnly && (!shaderVariants_ || displayMode == 6)) {
+            sim::OpenGLHelper::setSsboUniform(spFrag,
                                               spLightSsbo_,
                                               "lightData",
                                               static_cast<int>(sizeof(lights_[0]) * lights_.size()),
@@ -185,11 +621,14 @@ void RendererHelper<Vertex>::customRender(float,
 
     bool culling = glIsEnabled(GL_CULL_FACE) != 0;
 
-    if (showingVertsOnly_ || showNormals) {
+    // the multi-view geometry stage only takes triangles
+    if ((showingVertsOnly_ || showNormals) && !view.multiView) {
         glPointSize(static_cast<float>(pointSize_));
-        sim::OpenGLHelper::renderBuffer(glIds_.vao, 0, glIds_.vboSize, GL_POINTS);
+        render(glIds_.vboSize, GL_POINTS, nullptr);
         glPointSize(1);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (glIds_.framebuffer) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
         return;
     }
 
@@ -199,7 +638,7 @@ void RendererHelper<Vertex>::customRender(float,
     }
 
     int drawSize = glIds_.ibo ? glIds_.iboSize : glIds_.vboSize;
-    sim::OpenGLHelper::renderBuffer(glIds_.vao, 0, drawSize, drawMode, glIds_.ibo);
+    render(drawSize, drawMode, glIds_.ibo);
 
     if (culling) {
         glEnable(GL_CULL_FACE);
@@ -210,6 +649,29 @@ void RendererHelper<Vertex>::customRender(float,
     }
 }
 
+template <typename Vertex>
+const std::shared_ptr<GLuint> &RendererHelper<Vertex>::getFragmentProgram(int displayMode) const
+{
+    if (!shaderVariants_) {
+        return glIds_.programs.frag;
+    }
+
+    // the texture only matters for the texture display mode
+    const bool hasTexture = displayMode == 4 && glIds_.texture != nullptr;
+    const int key = displayMode * 2 + (hasTexture ? 1 : 0);
+
+    auto variant = fragVariants_.find(key);
+    if (variant == fragVariants_.end()) {
+        std::vector<std::string> defines{"DISPLAY_MODE=" + std::to_string(displayMode)};
+        if (hasTexture) {
+            defines.emplace_back("HAS_TEXTURE");
+        }
+        std::shared_ptr<GLuint> spProgram = OpenGLHelper::createSeparableProgram(sim::frag_shader_file(), defines);
+        variant = fragVariants_.emplace(key, std::move(spProgram)).first;
+    }
+    return variant->second;
+}
+
 template <typename Vertex>
 void RendererHelper<Vertex>::renderToFramebuffer(int width,
                                                  int height,
@@ -229,21 +691,105 @@ void RendererHelper<Vertex>::rebuild_mesh()
         return;
     }
 
-    glIds_.vbo = glIds_.vao = glIds_.ibo = nullptr;
+    const sim::DrawDataView<Vertex> data = dataFun_();
+
+    if (!ownsBuffers_) {
+        glIds_.vbo = glIds_.vao = glIds_.ibo = nullptr;
+        spInstancedVao_ = nullptr;
+        vboCapacity_ = iboCapacity_ = 0;
+        iboType_ = GL_UNSIGNED_INT;
+        ownsBuffers_ = true;
+    }
+
+    // the vertex layout is fixed by the Vertex type so the vao only has to be created once
+    if (!glIds_.vbo) {
+        glIds_.vbo = OpenGLHelper::createBuffer<Vertex>(nullptr, 0, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
+        glIds_.vao = OpenGLHelper::createVao<Vertex>(glIds_.vbo);
+    }
+    OpenGLHelper::writeBuffer(glIds_.vbo, &vboCapacity_, data.vbo, data.vboSize);
+    glIds_.vboSize = static_cast<int>(data.vboSize);
+    bounds_ = compute_bounds(data.vbo, data.vboSize);
 
-    const sim::DrawData<Vertex> &data = dataFun_();
-    glIds_.vbo = OpenGLHelper::createBuffer(data.vbo.data(), data.vbo.size());
+    if (data.iboSize == 0) {
+        glIds_.ibo = nullptr;
+        glIds_.iboSize = 0;
+        iboCapacity_ = 0;
+    } else {
+        if (!glIds_.ibo) {
+            glIds_.ibo = OpenGLHelper::createBuffer<unsigned>(nullptr, 0, GL_ELEMENT_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
+        }
 
-    glIds_.vao = OpenGLHelper::createVao(glIds_.programs.vert, glIds_.vbo, sizeof(Vertex), data.vaoElements);
-    glIds_.vboSize = static_cast<int>(data.vbo.size());
+        bool narrow = fits_16_bit_indices(data.ibo, data.iboSize, data.vboSize);
+        GLenum iboType = narrow ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        if (iboType != iboType_) {
+            iboCapacity_ = 0; // capacity is counted in elements of the previous type
+            iboType_ = iboType;
+        }
 
-    if (!data.ibo.empty()) {
-        glIds_.ibo
-            = sim::OpenGLHelper::createBuffer<unsigned>(data.ibo.data(), data.ibo.size(), GL_ELEMENT_ARRAY_BUFFER);
-        glIds_.iboSize = static_cast<int>(data.ibo.size());
+        if (iboType_ == GL_UNSIGNED_SHORT) {
+            std::vector<GLushort> indices = narrow_indices(data.ibo, data.iboSize);
+            OpenGLHelper::writeBuffer(glIds_.ibo,
+                                      &iboCapacity_,
+                                      indices.data(),
+                                      indices.size(),
+                                      GL_ELEMENT_ARRAY_BUFFER);
+        } else {
+            OpenGLHelper::writeBuffer(glIds_.ibo, &iboCapacity_, data.ibo, data.iboSize, GL_ELEMENT_ARRAY_BUFFER);
+        }
+        glIds_.iboSize = static_cast<int>(data.iboSize);
     }
 }
 
+template <typename Vertex>
+MeshBuffers RendererHelper<Vertex>::createMeshBuffers(const DrawDataView<Vertex> &data)
+{
+    MeshBuffers buffers;
+    buffers.vbo = OpenGLHelper::createBuffer(data.vbo, data.vboSize);
+    buffers.vao = OpenGLHelper::createVao<Vertex>(buffers.vbo);
+    buffers.vboSize = static_cast<int>(data.vboSize);
+    buffers.bounds = compute_bounds(data.vbo, data.vboSize);
+
+    if (data.iboSize > 0) {
+        if (fits_16_bit_indices(data.ibo, data.iboSize, data.vboSize)) {
+            std::vector<GLushort> indices = narrow_indices(data.ibo, data.iboSize);
+            buffers.ibo = OpenGLHelper::createBuffer(indices.data(), indices.size(), GL_ELEMENT_ARRAY_BUFFER);
+            buffers.iboType = GL_UNSIGNED_SHORT;
+        } else {
+            buffers.ibo = OpenGLHelper::createBuffer(data.ibo, data.iboSize, GL_ELEMENT_ARRAY_BUFFER);
+        }
+        buffers.iboSize = static_cast<int>(data.iboSize);
+    }
+    return buffers;
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::setMeshBuffers(const MeshBuffers &buffers)
+{
+    glIds_.vbo = buffers.vbo;
+    glIds_.ibo = buffers.ibo;
+    glIds_.vao = buffers.vao;
+    glIds_.vboSize = buffers.vboSize;
+    glIds_.iboSize = buffers.iboSize;
+    iboType_ = buffers.iboType;
+    bounds_ = buffers.bounds;
+
+    spInstancedVao_ = nullptr;
+    vboCapacity_ = iboCapacity_ = 0;
+    ownsBuffers_ = false;
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::updateVertices(std::size_t firstVertex, const Vertex *pVertices, std::size_t numVertices)
+{
+    if (!glIds_.vbo || firstVertex + numVertices > static_cast<std::size_t>(glIds_.vboSize)) {
+        throw std::runtime_error("Vertex update is outside of the current vertex buffer");
+    }
+    if (!ownsBuffers_) {
+        throw std::runtime_error("Shared mesh buffers can't be updated in place. Call rebuild_mesh first");
+    }
+    OpenGLHelper::updateBuffer(glIds_.vbo, firstVertex, numVertices, pVertices, GL_ARRAY_BUFFER);
+}
+
 template <typename Vertex>
 void RendererHelper<Vertex>::addLight(glm::vec3 lightDir, float intensity)
 {
@@ -280,6 +826,12 @@ bool RendererHelper<Vertex>::isUsingWireframe() const
 {
     return usingWireframe_;
 }
+
+template <typename Vertex>
+bool RendererHelper<Vertex>::isUsingShaderVariants() const
+{
+    return shaderVariants_;
+}
 template <typename Vertex>
 bool RendererHelper<Vertex>::isShowNormals() const
 {
@@ -325,6 +877,45 @@ GLenum RendererHelper<Vertex>::getDrawMode() const
 {
     return drawMode_;
 }
+template <typename Vertex>
+bool RendererHelper<Vertex>::isFrustumCulling() const
+{
+    return frustumCulling_;
+}
+template <typename Vertex>
+const AABB &RendererHelper<Vertex>::getBounds() const
+{
+    return bounds_;
+}
+template <typename Vertex>
+const CullStats &RendererHelper<Vertex>::getCullStats() const
+{
+    return cullStats_;
+}
+
+template <typename Vertex>
+DepthPrepass RendererHelper<Vertex>::getDepthPrepass() const
+{
+    return depthPrepass_;
+}
+
+template <typename Vertex>
+float RendererHelper<Vertex>::getDepthPrepassThreshold() const
+{
+    return depthPrepassThreshold_;
+}
+
+template <typename Vertex>
+const DepthPrepassStats &RendererHelper<Vertex>::getDepthPrepassStats() const
+{
+    return depthPrepassStats_;
+}
+
+template <typename Vertex>
+unsigned RendererHelper<Vertex>::getObjectId() const
+{
+    return objectId_;
+}
 
 template <typename Vertex>
 void RendererHelper<Vertex>::setFboWidth(int fboWidth)
@@ -346,6 +937,12 @@ void RendererHelper<Vertex>::setUsingWireframe(bool usingWireframe)
 {
     usingWireframe_ = usingWireframe;
 }
+
+template <typename Vertex>
+void RendererHelper<Vertex>::setUsingShaderVariants(bool usingShaderVariants)
+{
+    shaderVariants_ = usingShaderVariants;
+}
 template <typename Vertex>
 void RendererHelper<Vertex>::setShowNormals(bool showNormals)
 {
@@ -405,6 +1002,29 @@ void RendererHelper<Vertex>::setDrawMode(GLenum drawMode)
 {
     drawMode_ = drawMode;
 }
+template <typename Vertex>
+void RendererHelper<Vertex>::setFrustumCulling(bool frustumCulling)
+{
+    frustumCulling_ = frustumCulling;
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::setDepthPrepass(DepthPrepass depthPrepass)
+{
+    depthPrepass_ = depthPrepass;
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::setDepthPrepassThreshold(float overdraw)
+{
+    depthPrepassThreshold_ = overdraw;
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::setObjectId(unsigned objectId)
+{
+    objectId_ = objectId;
+}
 
 template <typename Vertex>
 void RendererHelper<Vertex>::updateLights()
@@ -418,17 +1038,62 @@ const glm::mat4 &RendererHelper<Vertex>::getModelMatrix() const
     return modelMatrix_;
 }
 
+template <typename Vertex>
+const glm::dmat4 &RendererHelper<Vertex>::getModelMatrixD() const
+{
+    return modelMatrixD_;
+}
+
 template <typename Vertex>
 void RendererHelper<Vertex>::setModelMatrix(const glm::mat4 &modelMatrix)
 {
     modelMatrix_ = modelMatrix;
+    modelMatrixD_ = glm::dmat4(modelMatrix);
+    normalMatrix_ = glm::transpose(glm::inverse(glm::mat3(modelMatrix_)));
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::setModelMatrix(const glm::dmat4 &modelMatrix)
+{
+    modelMatrixD_ = modelMatrix;
+    modelMatrix_ = glm::mat4(modelMatrix);
     normalMatrix_ = glm::transpose(glm::inverse(glm::mat3(modelMatrix_)));
 }
 
+template <typename Vertex>
+const glm::mat4 &RendererHelper<Vertex>::getLocalFromQuantizedMatrix() const
+{
+    return localFromQuantizedMatrix_;
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::setLocalFromQuantizedMatrix(const glm::mat4 &localFromQuantizedMatrix)
+{
+    localFromQuantizedMatrix_ = localFromQuantizedMatrix;
+}
+
+template <typename Vertex>
+const glm::vec4 &RendererHelper<Vertex>::getTexFromQuantized() const
+{
+    return texFromQuantized_;
+}
+
+template <typename Vertex>
+void RendererHelper<Vertex>::setTexFromQuantized(const glm::vec4 &texFromQuantized)
+{
+    texFromQuantized_ = texFromQuantized;
+}
+
 template class sim::RendererHelper<sim::PosNormTexVertex>;
 template class sim::RendererHelper<sim::PosVertex>;
+template class sim::RendererHelper<sim::PackedPosNormTexVertex>;
 
 template struct sim::DrawData<sim::PosNormTexVertex>;
 template struct sim::DrawData<sim::PosVertex>;
+template struct sim::DrawData<sim::PackedPosNormTexVertex>;
+
+template struct sim::DrawDataView<sim::PosNormTexVertex>;
+template struct sim::DrawDataView<sim::PosVertex>;
+template struct sim::DrawDataView<sim::PackedPosNormTexVertex>;
 
 } // namespace sim
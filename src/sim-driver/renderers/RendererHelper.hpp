@@ -1,9 +1,16 @@
 #pragma once
 
 #include <sim-driver/OpenGLTypes.hpp>
+#include <sim-driver/Frustum.hpp>
+#include <sim-driver/MultiView.hpp>
+#include <sim-driver/renderers/IdBuffer.hpp>
 #include <glm/glm.hpp>
 #include <vector>
 #include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include <string>
 
 namespace sim {
@@ -13,23 +20,96 @@ struct DrawData
 {
     std::vector<Vertex> vbo;
     std::vector<unsigned> ibo;
-    std::vector<sim::VAOElement> vaoElements;
+};
+
+/// Non-owning view of mesh data that is uploaded straight from its owner's memory.
+/// The vertex layout is given by VertexFormat<Vertex>.
+template <typename Vertex>
+struct DrawDataView
+{
+    const Vertex *vbo{nullptr};
+    std::size_t vboSize{0};
+    const unsigned *ibo{nullptr};
+    std::size_t iboSize{0};
+
+    DrawDataView() = default;
+
+    DrawDataView(const Vertex *pVbo, std::size_t numVerts, const unsigned *pIbo = nullptr, std::size_t numIndices = 0)
+        : vbo{pVbo}, vboSize{numVerts}, ibo{pIbo}, iboSize{numIndices}
+    {
+    }
+
+    // implicit so anything that owns a DrawData can hand it out without copying
+    DrawDataView(const DrawData<Vertex> &data)
+        : vbo{data.vbo.data()}, vboSize{data.vbo.size()}, ibo{data.ibo.data()}, iboSize{data.ibo.size()}
+    {
+    }
+
+    // a view of a temporary would dangle before the upload
+    DrawDataView(const DrawData<Vertex> &&) = delete;
+};
+
+/// When advanced shading (display mode 6) first lays down depth so only the front-most
+/// fragments run the Cook-Torrance shader. Only onRender and customRender draws use it;
+/// instanced and multi-view draws always shade every fragment.
+enum class DepthPrepass
+{
+    Off,
+    On,
+    Auto, // on while the measured overdraw is above the threshold
+};
+
+/// Latest sample counts of a pre-pass draw (results arrive a few frames late)
+struct DepthPrepassStats
+{
+    std::uint64_t fragments{0}; // passing the depth test in the pre-pass, i.e. shaded without it
+    std::uint64_t shadedFragments{0}; // passing the GL_EQUAL test of the shading pass
+    bool active{false}; // whether the last advanced shading draw used the pre-pass
+
+    double overdraw() const; // fragments per visible fragment
+    std::uint64_t savedFragments() const; // shader invocations skipped thanks to the pre-pass
 };
 
 template <typename Vertex>
 class RendererHelper
 {
 public:
-    using DataFun = std::function<DrawData<Vertex>(void)>;
+    /// Called on every rebuild_mesh. The returned view only has to stay valid until the upload is done.
+    using DataFun = std::function<DrawDataView<Vertex>(void)>;
 
     explicit RendererHelper(std::string vertShader = "");
 
+    /// Draws the mesh (and its normals when shown). The cull stats only count these draws.
     void onRender(float alpha, const Camera *pCamera) const;
 
+    /// Renders relative to the eye of a double precision camera (see EyeRelativeTransforms) using
+    /// the double precision model matrix. Scenes far from the origin render without jitter and
+    /// without re-centering the vertex data.
+    void onRender(float alpha, const CameraD &camera) const;
+
+    /// Draws one copy of the mesh per instance with a single instanced draw call.
+    /// The instances are streamed to the GPU every call so they may change each frame.
+    /// Instances outside of the camera frustum are dropped first when frustum culling is on.
+    void onRenderInstanced(float alpha,
+                           const Camera *pCamera,
+                           const InstanceData *pInstances,
+                           std::size_t numInstances) const;
+
+    /// Draws the mesh once for up to max_views cameras with a single draw call. A geometry
+    /// shader invocation per view routes the triangles to a layer of the bound layered
+    /// framebuffer or to a viewport of the viewport array. Normals and vertex-only display
+    /// aren't drawn and advanced shading uses the first camera's eye for every view.
+    void onRenderMultiView(float alpha,
+                           const Camera *pCameras,
+                           std::size_t numCameras,
+                           MultiViewTarget target = MultiViewTarget::Layers) const;
+
     void onGuiRender();
 
     void onResize(int width, int height);
 
+    /// Skips the draw if the mesh bounds are outside of the camera frustum (and culling is on).
+    /// Unlike onRender, a pre-pass draw reads the GL write masks it restores on every call.
     void customRender(float alpha,
                       const Camera *pCamera,
                       GLenum drawMode = GL_TRIANGLE_STRIP,
@@ -40,13 +120,36 @@ public:
                       float NormalScale = 0.5f,
                       std::function<void(void)> programReplacement = nullptr) const;
 
+    void customRender(float alpha,
+                      const CameraD &camera,
+                      GLenum drawMode = GL_TRIANGLE_STRIP,
+                      int displayMode = 5,
+                      glm::vec3 shapeColor = glm::vec3{0.7},
+                      glm::vec3 lightDir = glm::vec3{0.7f, 0.85f, 1.0f},
+                      bool showNormals = false,
+                      float NormalScale = 0.5f,
+                      std::function<void(void)> programReplacement = nullptr) const;
+
     void renderToFramebuffer(int width,
                              int height,
                              const std::shared_ptr<GLuint> &spColorTex = nullptr,
                              const std::shared_ptr<GLuint> &spDepthTex = nullptr);
 
+    /// Re-uploads the data from the DataFun. Buffers are updated in place, their storage only
+    /// grows when the new data is larger than any previous upload, and the vao is always reused.
     void rebuild_mesh();
 
+    /// Uploads 'data' into new buffers that can be shared with setMeshBuffers
+    static MeshBuffers createMeshBuffers(const DrawDataView<Vertex> &data);
+
+    /// Renders from shared buffers (e.g. from a MeshCache) instead of this renderer's own.
+    /// The next rebuild_mesh goes back to private buffers so shared ones are never overwritten.
+    void setMeshBuffers(const MeshBuffers &buffers);
+
+    /// Overwrites part of the current vertex buffer (e.g. for deforming meshes
+    /// whose topology doesn't change)
+    void updateVertices(std::size_t firstVertex, const Vertex *pVertices, std::size_t numVertices);
+
     void addLight(glm::vec3 lightDir, float intensity);
 
     void setTexture(std::shared_ptr<GLuint> texture);
@@ -55,6 +158,7 @@ public:
     int getFboHeight() const;
     bool isShowingVertsOnly() const;
     bool isUsingWireframe() const;
+    bool isUsingShaderVariants() const;
     bool isShowNormals() const;
     int getDisplayMode() const;
     const glm::vec3 &getShapeColor() const;
@@ -64,11 +168,22 @@ public:
     int getPointSize() const;
     float getNormalScale() const;
     GLenum getDrawMode() const;
+    bool isFrustumCulling() const;
+    const AABB &getBounds() const;
+    const CullStats &getCullStats() const; // since the last onRender or onRenderInstanced
+    DepthPrepass getDepthPrepass() const;
+    float getDepthPrepassThreshold() const;
+    const DepthPrepassStats &getDepthPrepassStats() const;
+    unsigned getObjectId() const;
 
     void setFboWidth(int fboWidth);
     void setFboHeight(int fboHeight);
     void setShowingVertsOnly(bool showingVertsOnly);
     void setUsingWireframe(bool usingWireframe);
+
+    /// Draws with a fragment shader specialized for the display mode (compiled on first use)
+    /// instead of the one branching on it at runtime. On by default.
+    void setUsingShaderVariants(bool usingShaderVariants);
     void setShowNormals(bool showNormals);
     void setDisplayMode(int displayMode);
     void setShapeColor(const glm::vec3 &shapeColor);
@@ -79,9 +194,21 @@ public:
     void setNormalScale(float normalScale);
     void setDataFun(const DataFun &dataFun);
     void setDrawMode(GLenum drawMode);
+    void setFrustumCulling(bool frustumCulling);
+    void setDepthPrepass(DepthPrepass depthPrepass);
+    void setDepthPrepassThreshold(float overdraw); // Auto turns the pre-pass on above this overdraw
+    void setObjectId(unsigned objectId); // written to the IdBuffer being rendered into, if any
 
     const glm::mat4 &getModelMatrix() const;
+    const glm::dmat4 &getModelMatrixD() const;
     void setModelMatrix(const glm::mat4 &modelMatrix);
+    void setModelMatrix(const glm::dmat4 &modelMatrix); // keeps full precision for CameraD rendering
+
+    const glm::mat4 &getLocalFromQuantizedMatrix() const;
+    void setLocalFromQuantizedMatrix(const glm::mat4 &localFromQuantizedMatrix);
+
+    const glm::vec4 &getTexFromQuantized() const;
+    void setTexFromQuantized(const glm::vec4 &texFromQuantized); // scale (xy) and offset (zw)
 
 private:
     SeparablePipeline glIds_;
@@ -106,18 +233,118 @@ private:
     float normalScale_{0.5f};
 
     glm::mat4 modelMatrix_{1};
+    glm::dmat4 modelMatrixD_{1};
     glm::mat3 normalMatrix_{1};
+    glm::mat4 localFromQuantizedMatrix_{1}; // only used by quantized vertex formats
+    glm::vec4 texFromQuantized_{1, 1, 0, 0}; // only used by quantized vertex formats
+
+    std::size_t vboCapacity_{0};
+    std::size_t iboCapacity_{0};
+    GLenum iboType_{GL_UNSIGNED_INT}; // GL_UNSIGNED_SHORT when the mesh has at most 65536 vertices
+    bool ownsBuffers_{true};
 
     DataFun dataFun_{nullptr};
     GLenum drawMode_{GL_TRIANGLE_STRIP};
 
+    AABB bounds_{}; // vertex attribute space, computed on upload
+    bool frustumCulling_{true};
+    mutable CullStats cullStats_;
+    mutable std::vector<InstanceData> visibleInstances_;
+
+    unsigned objectId_{IdBuffer::no_object}; // not pickable by default
+
+    DepthPrepass depthPrepass_{DepthPrepass::Auto};
+    float depthPrepassThreshold_{1.5f};
+    int depthPrepassInterval_{30}; // draws between measurements when Auto has the pre-pass off
+    mutable DepthPrepassStats depthPrepassStats_;
+    mutable bool depthPrepassProfitable_{false};
+    mutable long long depthPrepassDraws_{0};
+    mutable bool depthQueriesPending_{false};
+    mutable std::shared_ptr<GLuint> spDepthFrag_{nullptr};
+    mutable std::shared_ptr<GLuint> spDepthQuery_{nullptr};
+    mutable std::shared_ptr<GLuint> spShadedQuery_{nullptr};
+
+    bool shaderVariants_{true};
+    mutable std::unordered_map<int, std::shared_ptr<GLuint>> fragVariants_; // by display mode and texture
+
+    // instanced rendering state, created on the first instanced draw
+    mutable std::shared_ptr<GLuint> spInstancedVert_{nullptr};
+    mutable std::shared_ptr<GLuint> spInstanceVbo_{nullptr};
+    mutable std::shared_ptr<GLuint> spInstancedVao_{nullptr};
+    mutable std::size_t instanceCapacity_{0};
+
+    // multi-view state, created on the first multi-view draw
+    mutable std::shared_ptr<GLuint> spMultiViewGeom_{nullptr};
+    mutable std::shared_ptr<GLuint> spMultiViewUbo_{nullptr};
+
+    // camera dependent uniforms, in world space or relative to the eye
+    struct ViewTransforms
+    {
+        bool hasCamera{false};
+        glm::mat4 screenFromWorld{1};
+        glm::vec3 eye{0};
+        glm::mat4 worldFromLocal{1};
+        bool multiView{false}; // positions are projected by the multi-view geometry stage
+    };
+
+    // write state restored after a depth pre-pass
+    struct RasterState
+    {
+        GLboolean colorMask[4];
+        GLboolean depthMask;
+        GLint depthFunc;
+    };
+
+    mutable RasterState frameState_{}; // read in onRender when the pre-pass may run
+
     void updateLights();
+
+    ViewTransforms getViewTransforms(const Camera *pCamera) const;
+    ViewTransforms getViewTransforms(const CameraD &camera) const;
+
+    static RasterState read_raster_state();
+
+    void renderFrame(const ViewTransforms &view) const; // the onRender draws
+
+    void cullAndRender(const ViewTransforms &view,
+                       const RasterState *pState, // read on demand when null
+                       GLenum drawMode,
+                       int displayMode,
+                       glm::vec3 shapeColor,
+                       glm::vec3 lightDir,
+                       bool showNormals,
+                       float NormalScale,
+                       const std::function<void(void)> &programReplacement) const;
+
+    const std::shared_ptr<GLuint> &getFragmentProgram(int displayMode) const;
+
+    bool usesDepthPrepass(int displayMode, bool showNormals, bool replacedProgram) const;
+    void pollDepthPrepassQueries() const;
+
+    void renderMesh(const std::shared_ptr<GLuint> &spVert,
+                    const std::shared_ptr<GLuint> &spVao,
+                    int instances, // 0 for a regular (non-instanced) draw
+                    const ViewTransforms &view,
+                    GLenum drawMode,
+                    int displayMode,
+                    glm::vec3 shapeColor,
+                    glm::vec3 lightDir,
+                    bool showNormals,
+                    float NormalScale,
+                    const std::function<void(void)> &programReplacement,
+                    bool depthOnly = false) const;
 };
 
 using PosNormTexRenderer = sim::RendererHelper<sim::PosNormTexVertex>;
 using PosRenderer = sim::RendererHelper<sim::PosVertex>;
+using PackedPosNormTexRenderer = sim::RendererHelper<sim::PackedPosNormTexVertex>;
 
 using PosNormTexData = sim::DrawData<sim::PosNormTexVertex>;
 using PosData = sim::DrawData<sim::PosVertex>;
+using PackedPosNormTexData = sim::DrawData<sim::PackedPosNormTexVertex>;
+
+using PosNormTexDataView = sim::DrawDataView<sim::PosNormTexVertex>;
+using PosDataView = sim::DrawDataView<sim::PosVertex>;
+using PackedPosNormTexDataView = sim::DrawDataView<sim::PackedPosNormTexVertex>;
 
 } // namespace sim
@@ -0,0 +1,94 @@
+#include <sim-driver/meshes/AsyncLodBuilder.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+
+namespace {
+
+bool wait_for_result(sim::AsyncLodBuilder *pBuilder, std::vector<sim::LodLevelData> *pLevels)
+{
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    while (std::chrono::steady_clock::now() < timeout) {
+        if (pBuilder->poll(pLevels)) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+sim::AsyncLodBuilder::BuildFun make_levels(std::size_t numLevels)
+{
+    return [numLevels] {
+        std::vector<sim::LodLevelData> levels;
+        for (std::size_t i = 0; i < numLevels; ++i) {
+            levels.push_back({{0, 0, 0, 0, 0}, nullptr, GL_TRIANGLES, static_cast<float>(i)});
+        }
+        return levels;
+    };
+}
+
+} // namespace
+
+TEST(AsyncLodBuilderTests, builds_requests_in_the_background)
+{
+    sim::AsyncLodBuilder builder;
+    builder.submit(make_levels(3));
+
+    std::vector<sim::LodLevelData> levels;
+    ASSERT_TRUE(wait_for_result(&builder, &levels));
+
+    ASSERT_EQ(3u, levels.size());
+    EXPECT_EQ(2.0f, levels[2].error);
+    EXPECT_FALSE(builder.poll(&levels));
+}
+
+TEST(AsyncLodBuilderTests, superseded_and_cancelled_requests_are_dropped)
+{
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+
+    sim::AsyncLodBuilder builder;
+    builder.submit([&] {
+        started = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+        return make_levels(1)();
+    });
+
+    while (!started) {
+        std::this_thread::yield();
+    }
+    EXPECT_TRUE(builder.isBusy());
+
+    builder.submit(make_levels(2)); // replaced before it starts
+    builder.submit(make_levels(4));
+    release = true;
+
+    std::vector<sim::LodLevelData> levels;
+    ASSERT_TRUE(wait_for_result(&builder, &levels));
+    EXPECT_EQ(4u, levels.size());
+
+    started = false;
+    release = false;
+    builder.submit([&] {
+        started = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+        return make_levels(5)();
+    });
+
+    while (!started) {
+        std::this_thread::yield();
+    }
+    builder.cancel();
+    release = true;
+
+    while (builder.isBusy()) {
+        std::this_thread::yield();
+    }
+    EXPECT_FALSE(builder.poll(&levels));
+}
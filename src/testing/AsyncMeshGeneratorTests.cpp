@@ -0,0 +1,158 @@
+#include <sim-driver/meshes/AsyncMeshGenerator.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+
+namespace {
+
+sim::MeshKey make_key(int u, int v)
+{
+    return {0, 1, u, v, 0};
+}
+
+template <typename V>
+bool wait_for_result(sim::AsyncMeshGenerator<V> *pGenerator,
+                     sim::MeshKey *pKey,
+                     std::shared_ptr<const sim::DrawData<V>> *pspData)
+{
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    while (std::chrono::steady_clock::now() < timeout) {
+        if (pGenerator->poll(pKey, pspData)) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+} // namespace
+
+TEST(AsyncMeshGeneratorTests, generates_requests_in_the_background)
+{
+    sim::AsyncMeshGenerator<sim::PosVertex> generator([](int u, int v) {
+        sim::PosData data;
+        data.vbo.resize(static_cast<std::size_t>(u * v));
+        return data;
+    });
+
+    generator.submit(make_key(3, 4));
+
+    sim::MeshKey key{0, 0, 0, 0, 0};
+    std::shared_ptr<const sim::PosData> spData;
+    ASSERT_TRUE(wait_for_result(&generator, &key, &spData));
+
+    EXPECT_EQ(3, key.uDivisions);
+    EXPECT_EQ(4, key.vDivisions);
+    EXPECT_EQ(12u, spData->vbo.size());
+    EXPECT_FALSE(generator.poll(&key, &spData));
+}
+
+TEST(AsyncMeshGeneratorTests, superseded_requests_are_dropped)
+{
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    std::atomic<int> numGenerated{0};
+
+    sim::AsyncMeshGenerator<sim::PosVertex> generator([&](int u, int) {
+        started = true;
+        while (u == 1 && !release) {
+            std::this_thread::yield();
+        }
+        ++numGenerated;
+        sim::PosData data;
+        data.vbo.resize(static_cast<std::size_t>(u));
+        return data;
+    });
+
+    generator.submit(make_key(1, 1)); // blocks the worker until released
+
+    while (!started) {
+        std::this_thread::yield();
+    }
+    EXPECT_TRUE(generator.isBusy());
+
+    generator.submit(make_key(2, 2)); // replaced before it starts
+    generator.submit(make_key(3, 3));
+    release = true;
+
+    sim::MeshKey key{0, 0, 0, 0, 0};
+    std::shared_ptr<const sim::PosData> spData;
+    ASSERT_TRUE(wait_for_result(&generator, &key, &spData));
+
+    EXPECT_EQ(3, key.uDivisions);
+    EXPECT_EQ(3u, spData->vbo.size());
+    EXPECT_EQ(2, numGenerated.load());
+}
+
+TEST(AsyncMeshGeneratorTests, superseded_requests_skip_processing)
+{
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    std::atomic<int> numProcessed{0};
+
+    sim::AsyncMeshGenerator<sim::PosVertex> generator(
+        [&](int u, int) {
+            started = true;
+            while (u == 1 && !release) {
+                std::this_thread::yield();
+            }
+            sim::PosData data;
+            data.vbo.resize(static_cast<std::size_t>(u));
+            return data;
+        },
+        [&](const sim::MeshKey &key, sim::PosData *pData) {
+            EXPECT_EQ(key.uDivisions, static_cast<int>(pData->vbo.size()));
+            pData->ibo = {0};
+            ++numProcessed;
+        });
+
+    generator.submit(make_key(1, 1)); // blocks the worker until released
+
+    while (!started) {
+        std::this_thread::yield();
+    }
+    generator.submit(make_key(2, 2));
+    release = true;
+
+    sim::MeshKey key{0, 0, 0, 0, 0};
+    std::shared_ptr<const sim::PosData> spData;
+    ASSERT_TRUE(wait_for_result(&generator, &key, &spData));
+
+    EXPECT_EQ(2, key.uDivisions);
+    EXPECT_EQ(1u, spData->ibo.size());
+    EXPECT_EQ(1, numProcessed.load());
+}
+
+TEST(AsyncMeshGeneratorTests, cancelled_requests_are_dropped)
+{
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+
+    sim::AsyncMeshGenerator<sim::PosVertex> generator([&](int u, int) {
+        started = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+        sim::PosData data;
+        data.vbo.resize(static_cast<std::size_t>(u));
+        return data;
+    });
+
+    generator.submit(make_key(1, 1));
+
+    while (!started) {
+        std::this_thread::yield();
+    }
+    generator.cancel();
+    release = true;
+
+    while (generator.isBusy()) {
+        std::this_thread::yield();
+    }
+
+    sim::MeshKey key{0, 0, 0, 0, 0};
+    std::shared_ptr<const sim::PosData> spData;
+    EXPECT_FALSE(generator.poll(&key, &spData));
+}
@@ -0,0 +1,96 @@
+#include <sim-driver/Camera.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void expect_matrix_near(const glm::mat4 &expected, const glm::mat4 &actual)
+{
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            EXPECT_NEAR(expected[c][r], actual[c][r], 1e-5f) << "column " << c << " row " << r;
+        }
+    }
+}
+
+} // namespace
+
+TEST(CameraTests, matrices_reflect_every_setter)
+{
+    sim::Camera camera;
+    camera.setEyeVector({1, 2, 3});
+    camera.setLookVector({0, 0, -2});
+    camera.setFovYDegrees(45.0f);
+    camera.setAspectRatio(2.0f);
+    camera.setNearPlane(0.5f);
+    camera.setFarPlane(50.0f);
+
+    glm::mat4 view = glm::lookAt(glm::vec3(1, 2, 3), glm::vec3(1, 2, 2), glm::vec3(0, 1, 0));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 2.0f, 0.5f, 50.0f);
+
+    expect_matrix_near(view, camera.getViewFromWorldMatrix());
+    expect_matrix_near(projection, camera.getPerspectiveScreenFromViewMatrix());
+    expect_matrix_near(projection * view, camera.getPerspectiveScreenFromWorldMatrix());
+
+    camera.setOrthoLeft(-4.0f);
+    camera.setOrthoTop(3.0f);
+    glm::mat4 ortho = glm::ortho(-4.0f, 1.0f, -1.0f, 3.0f);
+    expect_matrix_near(ortho, camera.getOrthographicScreenFromViewMatrix());
+    expect_matrix_near(ortho * view, camera.getOrthoScreenFromWorldMatrix());
+}
+
+TEST(CameraTests, batch_set_matches_individual_setters)
+{
+    sim::Camera individual;
+    individual.setEyeVector({0, 1, 5});
+    individual.setLookVector({0, 0, -1});
+    individual.setUpVector({0, 1, 0});
+    individual.setAspectRatio(1.5f);
+    individual.setNearPlane(0.1f);
+
+    sim::Camera batched;
+    batched.set(sim::CameraUpdate().eye({0, 1, 5}).look({0, 0, -1}).up({0, 1, 0}).aspectRatio(1.5f).nearPlane(0.1f));
+
+    EXPECT_EQ(individual.getEyeVector(), batched.getEyeVector());
+    EXPECT_EQ(individual.getFovYDegrees(), batched.getFovYDegrees()); // untouched fields are kept
+    EXPECT_EQ(individual.getNearPlane(), batched.getNearPlane());
+    expect_matrix_near(individual.getPerspectiveScreenFromWorldMatrix(), batched.getPerspectiveScreenFromWorldMatrix());
+}
+
+TEST(CameraTests, copies_are_independent)
+{
+    sim::Camera original;
+    original.setEyeVector({0, 0, 10});
+
+    sim::Camera copy = original;
+    original.setEyeVector({0, 0, -10});
+
+    EXPECT_EQ(glm::vec3(0, 0, 10), copy.getEyeVector());
+    EXPECT_NEAR(-10.0f, copy.getViewFromWorldMatrix()[3][2], 1e-5f);
+    EXPECT_NEAR(10.0f, original.getViewFromWorldMatrix()[3][2], 1e-5f);
+}
+
+TEST(CameraTests, concurrent_const_reads_see_the_same_matrices)
+{
+    sim::Camera camera;
+    camera.setEyeVector({3, 2, 1});
+    camera.setAspectRatio(0.75f);
+
+    const sim::Camera &constCamera = camera;
+    std::vector<glm::mat4> results(8);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&constCamera, &results, i] {
+            results[i] = constCamera.getPerspectiveScreenFromWorldMatrix();
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (const glm::mat4 &result : results) {
+        EXPECT_EQ(results.front(), result);
+    }
+}
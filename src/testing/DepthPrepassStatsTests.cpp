@@ -0,0 +1,38 @@
+#include <sim-driver/renderers/RendererHelper.hpp>
+#include <gtest/gtest.h>
+
+TEST(DepthPrepassStatsTests, overdraw_is_fragments_per_visible_fragment)
+{
+    sim::DepthPrepassStats stats;
+    stats.fragments = 3000;
+    stats.shadedFragments = 1000;
+    EXPECT_DOUBLE_EQ(3.0, stats.overdraw());
+
+    // every fragment visible
+    stats.fragments = 1000;
+    EXPECT_DOUBLE_EQ(1.0, stats.overdraw());
+}
+
+TEST(DepthPrepassStatsTests, no_measurement_means_no_overdraw)
+{
+    sim::DepthPrepassStats stats;
+    EXPECT_DOUBLE_EQ(1.0, stats.overdraw());
+    EXPECT_EQ(0u, stats.savedFragments());
+
+    // nothing visible (e.g. fully clipped) doesn't divide by zero
+    stats.fragments = 500;
+    EXPECT_DOUBLE_EQ(1.0, stats.overdraw());
+}
+
+TEST(DepthPrepassStatsTests, saved_fragments_never_underflow)
+{
+    sim::DepthPrepassStats stats;
+    stats.fragments = 2500;
+    stats.shadedFragments = 1000;
+    EXPECT_EQ(1500u, stats.savedFragments());
+
+    // a shading pass that counted more samples than the pre-pass saved nothing
+    stats.fragments = 900;
+    EXPECT_EQ(0u, stats.savedFragments());
+    EXPECT_DOUBLE_EQ(0.9, stats.overdraw());
+}
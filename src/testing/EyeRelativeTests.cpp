@@ -0,0 +1,59 @@
+#include <sim-driver/EyeRelative.hpp>
+#include <sim-driver/Camera.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+
+glm::dvec3 ndc(const glm::dvec4 &clip)
+{
+    return glm::dvec3(clip) / clip.w;
+}
+
+} // namespace
+
+TEST(EyeRelativeTests, matches_translating_by_the_eye)
+{
+    const glm::dvec3 eye{1.0, -2.0, 3.0};
+    const glm::dmat4 worldFromLocal = glm::translate(glm::scale(glm::dmat4(1.0), glm::dvec3(2.0)), glm::dvec3(4, 5, 6));
+
+    const glm::mat4 expected{glm::translate(glm::dmat4(1.0), -eye) * worldFromLocal};
+    const glm::mat4 eyeFromLocal = sim::eye_from_local(eye, worldFromLocal);
+
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            EXPECT_FLOAT_EQ(expected[c][r], eyeFromLocal[c][r]);
+        }
+    }
+}
+
+TEST(EyeRelativeTests, large_coordinates_stay_precise)
+{
+    // roughly the radius of the earth away from the origin
+    const glm::dvec3 eye{6378137.25, 1234.5, -2500000.75};
+    const glm::dmat4 worldFromLocal = glm::translate(glm::dmat4(1.0), eye + glm::dvec3(3.3, -0.7, -25.1));
+    const glm::dvec4 local{0.123, 0.456, 0.789, 1.0};
+
+    sim::CameraD camera;
+    camera.lookAt(eye, eye + glm::dvec3(0.2, -0.1, -1.0));
+    camera.perspective(60.0, 1.5, 0.1, 1000.0);
+
+    const glm::dvec3 expected = ndc(camera.getPerspectiveScreenFromWorldMatrix() * worldFromLocal * local);
+
+    const sim::EyeRelativeTransforms transforms = sim::eye_relative_transforms(camera, worldFromLocal);
+    EXPECT_EQ(glm::vec3(0.0f), transforms.eye);
+
+    const glm::vec4 relativeClip = transforms.screenFromEye * (transforms.eyeFromLocal * glm::vec4(local));
+    const glm::dvec3 relative = ndc(glm::dvec4(relativeClip));
+
+    // everything in float like a naive upload would do
+    const glm::mat4 screenFromWorld{camera.getPerspectiveScreenFromWorldMatrix()};
+    const glm::vec4 naiveClip = screenFromWorld * (glm::mat4(worldFromLocal) * glm::vec4(local));
+    const glm::dvec3 naive = ndc(glm::dvec4(naiveClip));
+
+    const double relativeError = glm::length(relative - expected);
+    const double naiveError = glm::length(naive - expected);
+
+    EXPECT_LT(relativeError, 1e-5);
+    EXPECT_GT(naiveError, 100.0 * relativeError);
+}
@@ -0,0 +1,105 @@
+#include <sim-driver/Frustum.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace {
+
+// looking down -z from the origin with a 90 degree field of view
+sim::Frustum make_test_frustum()
+{
+    glm::mat4 screenFromView = glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 100.0f);
+    glm::mat4 viewFromWorld = glm::lookAt(glm::vec3(0), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+    return sim::extract_frustum(screenFromView * viewFromWorld);
+}
+
+} // namespace
+
+TEST(FrustumTests, planes_point_inside_and_are_normalized)
+{
+    sim::Frustum frustum = make_test_frustum();
+
+    const glm::vec3 inside{0, 0, -10};
+    for (const glm::vec4 &plane : frustum.planes) {
+        EXPECT_NEAR(1.0f, glm::length(glm::vec3(plane)), 1e-5f);
+        EXPECT_GT(glm::dot(glm::vec3(plane), inside) + plane.w, 0.0f);
+    }
+
+    // near and far planes are at the clip distances
+    EXPECT_NEAR(-1.0f, glm::dot(glm::vec3(frustum.planes[4]), glm::vec3(0, 0, 0)) + frustum.planes[4].w, 1e-4f);
+    EXPECT_NEAR(0.0f, glm::dot(glm::vec3(frustum.planes[5]), glm::vec3(0, 0, -100)) + frustum.planes[5].w, 1e-3f);
+}
+
+TEST(FrustumTests, spheres_and_boxes)
+{
+    sim::Frustum frustum = make_test_frustum();
+
+    EXPECT_TRUE(sim::intersects(frustum, sim::BoundingSphere{{0, 0, -10}, 1}));
+    EXPECT_FALSE(sim::intersects(frustum, sim::BoundingSphere{{0, 0, 10}, 1})); // behind
+    EXPECT_FALSE(sim::intersects(frustum, sim::BoundingSphere{{0, 0, -200}, 1})); // past the far plane
+    EXPECT_FALSE(sim::intersects(frustum, sim::BoundingSphere{{20, 0, -10}, 1}));
+    EXPECT_TRUE(sim::intersects(frustum, sim::BoundingSphere{{20, 0, -10}, 15})); // overlaps the right plane
+
+    sim::AABB box;
+    box.expand(glm::vec3(-1, -1, -11));
+    box.expand(glm::vec3(1, 1, -9));
+    EXPECT_TRUE(sim::intersects(frustum, box));
+
+    EXPECT_FALSE(sim::intersects(frustum, sim::transform_box(box, glm::translate(glm::mat4(1), {0, 0, 20}))));
+    EXPECT_TRUE(sim::intersects(frustum, sim::transform_box(box, glm::translate(glm::mat4(1), {10, 0, 0}))));
+}
+
+TEST(FrustumTests, batched_culling_matches_single_tests)
+{
+    sim::Frustum frustum = make_test_frustum();
+
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> position(-150.0f, 150.0f);
+    std::uniform_real_distribution<float> size(0.0f, 10.0f);
+
+    constexpr std::size_t count = 1000; // multiple blocks with a partial one at the end
+    std::vector<float> x(count), y(count), z(count), radius(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        x[i] = position(gen);
+        y[i] = position(gen);
+        z[i] = position(gen);
+        radius[i] = size(gen);
+    }
+
+    std::vector<unsigned char> visible(count);
+    std::size_t numVisible
+        = sim::cull_spheres(frustum, x.data(), y.data(), z.data(), radius.data(), count, visible.data());
+
+    std::size_t expectedVisible = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        bool expected = sim::intersects(frustum, sim::BoundingSphere{{x[i], y[i], z[i]}, radius[i]});
+        EXPECT_EQ(expected, visible[i] != 0) << i;
+        expectedVisible += expected;
+    }
+    EXPECT_EQ(expectedVisible, numVisible);
+    EXPECT_GT(numVisible, 0u);
+    EXPECT_LT(numVisible, count);
+}
+
+TEST(FrustumTests, instances_are_culled_in_order)
+{
+    sim::Frustum frustum = make_test_frustum();
+
+    std::vector<sim::InstanceData> instances;
+    for (int i = 0; i < 600; ++i) {
+        float x = static_cast<float>(i % 3 - 1) * 50.0f; // only x == 0 is visible
+        glm::mat4 worldFromLocal = glm::translate(glm::mat4(1), {x, 0, -10}) * glm::scale(glm::mat4(1), glm::vec3(2));
+        instances.push_back({worldFromLocal, glm::vec4(static_cast<float>(i))});
+    }
+
+    std::vector<sim::InstanceData> visible;
+    std::size_t numVisible
+        = sim::cull_instances(frustum, {{0, 0, 0}, 1}, instances.data(), instances.size(), &visible);
+
+    ASSERT_EQ(200u, numVisible);
+    ASSERT_EQ(200u, visible.size());
+    for (std::size_t i = 0; i < visible.size(); ++i) {
+        EXPECT_EQ(static_cast<float>(i * 3 + 1), visible[i].color.x);
+    }
+}
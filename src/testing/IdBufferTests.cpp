@@ -0,0 +1,68 @@
+#include <sim-driver/renderers/IdBuffer.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+TEST(IdBufferTests, slots_are_reused_once_finished)
+{
+    sim::PickRing ring(2);
+    EXPECT_EQ(2u, ring.size());
+    EXPECT_EQ(-1, ring.getLatest().frame);
+
+    bool dropped = true;
+    EXPECT_EQ(0u, ring.request(1, 2, 1, &dropped));
+    EXPECT_FALSE(dropped);
+    EXPECT_EQ(1u, ring.request(3, 4, 2, &dropped));
+    EXPECT_FALSE(dropped);
+    EXPECT_EQ(std::vector<std::size_t>({0, 1}), ring.getPending());
+
+    ring.complete(0, 7, 11);
+    EXPECT_EQ(1u, ring.getNumPending());
+
+    const sim::PickResult &latest = ring.getLatest();
+    EXPECT_TRUE(latest.hit);
+    EXPECT_EQ(7u, latest.object);
+    EXPECT_EQ(11u, latest.primitive);
+    EXPECT_EQ(1, latest.x);
+    EXPECT_EQ(2, latest.y);
+    EXPECT_EQ(1, latest.frame);
+
+    // the finished slot comes around again without dropping anything
+    EXPECT_EQ(0u, ring.request(5, 6, 3, &dropped));
+    EXPECT_FALSE(dropped);
+    EXPECT_EQ(std::vector<std::size_t>({1, 0}), ring.getPending());
+}
+
+TEST(IdBufferTests, oldest_request_is_dropped_when_every_fence_is_pending)
+{
+    sim::PickRing ring(3);
+    bool dropped = false;
+    for (int frame = 1; frame <= 3; ++frame) {
+        ring.request(frame, 0, frame, &dropped);
+        EXPECT_FALSE(dropped);
+    }
+
+    // the fourth request replaces the first one instead of being refused
+    EXPECT_EQ(0u, ring.request(4, 0, 4, &dropped));
+    EXPECT_TRUE(dropped);
+    EXPECT_EQ(3u, ring.getNumPending());
+    EXPECT_EQ(std::vector<std::size_t>({1, 2, 0}), ring.getPending());
+
+    ring.complete(0, 9, 0);
+    EXPECT_EQ(4, ring.getLatest().x);
+    EXPECT_EQ(4, ring.getLatest().frame);
+
+    // results of older requests finishing later don't replace the newest one
+    ring.complete(1, 8, 0);
+    EXPECT_EQ(9u, ring.getLatest().object);
+    EXPECT_EQ(4, ring.getLatest().frame);
+}
+
+TEST(IdBufferTests, misses_and_empty_rings)
+{
+    sim::PickRing ring(1);
+    ring.complete(ring.request(0, 0, 1), sim::PickRing::no_object, 0);
+    EXPECT_FALSE(ring.getLatest().hit);
+    EXPECT_EQ(1, ring.getLatest().frame);
+
+    EXPECT_THROW(sim::PickRing(0), std::runtime_error);
+}
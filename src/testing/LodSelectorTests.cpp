@@ -0,0 +1,67 @@
+#include <sim-driver/renderers/LodSelector.hpp>
+#include <sim-driver/Bounds.hpp>
+#include <glm/gtc/constants.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+
+/// Projected errors of levels with model space errors 0, 1, 2, 4 at 'distance'
+std::vector<float> pixel_errors(float distance)
+{
+    std::vector<float> errors;
+    for (float error : {0.0f, 1.0f, 2.0f, 4.0f}) {
+        errors.push_back(sim::projected_size_pixels(error, distance, glm::half_pi<float>(), 200));
+    }
+    return errors;
+}
+
+} // namespace
+
+TEST(LodSelectorTests, projected_size_shrinks_with_distance)
+{
+    // a 90 degree field of view spans 2 * distance
+    EXPECT_FLOAT_EQ(100.0f, sim::projected_size_pixels(1.0f, 1.0f, glm::half_pi<float>(), 200));
+    EXPECT_FLOAT_EQ(10.0f, sim::projected_size_pixels(1.0f, 10.0f, glm::half_pi<float>(), 200));
+}
+
+TEST(LodSelectorTests, coarser_levels_are_chosen_further_away)
+{
+    sim::LodSelector selector(1.0f, 0.0f);
+
+    EXPECT_EQ(0u, selector.select(pixel_errors(10.0f)));
+    EXPECT_EQ(1u, selector.select(pixel_errors(100.0f)));
+    EXPECT_EQ(2u, selector.select(pixel_errors(200.0f)));
+    EXPECT_EQ(3u, selector.select(pixel_errors(1000.0f)));
+    EXPECT_EQ(0u, selector.select(pixel_errors(1.0f)));
+}
+
+TEST(LodSelectorTests, hysteresis_prevents_switching_back_and_forth)
+{
+    sim::LodSelector selector(1.0f, 0.25f);
+
+    // level 1 reaches 1 px at 100 but is only used once it drops below 0.75 px
+    EXPECT_EQ(0u, selector.select(pixel_errors(110.0f)));
+    EXPECT_EQ(1u, selector.select(pixel_errors(140.0f)));
+
+    // and is kept until it exceeds 1.25 px
+    EXPECT_EQ(1u, selector.select(pixel_errors(90.0f)));
+    EXPECT_EQ(0u, selector.select(pixel_errors(70.0f)));
+}
+
+TEST(LodSelectorTests, bounding_spheres_follow_the_model_matrix)
+{
+    sim::AABB box;
+    box.expand(glm::vec3(-1.0f, -2.0f, -2.0f));
+    box.expand(glm::vec3(1.0f, 2.0f, 2.0f));
+
+    sim::BoundingSphere sphere = sim::bounding_sphere(box);
+    EXPECT_FLOAT_EQ(3.0f, sphere.radius);
+
+    glm::mat4 model{1};
+    model[0][0] = 2.0f;
+    model[3] = glm::vec4(5.0f, 0.0f, 0.0f, 1.0f);
+
+    sim::BoundingSphere world = sim::transform_sphere(sphere, model);
+    EXPECT_FLOAT_EQ(6.0f, world.radius);
+    EXPECT_FLOAT_EQ(5.0f, world.center.x);
+}
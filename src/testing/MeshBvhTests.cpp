@@ -0,0 +1,250 @@
+#include <sim-driver/meshes/MeshBvh.hpp>
+#include <sim-driver/meshes/MeshFunctions.hpp>
+#include <sim-driver/Camera.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace {
+
+/// Random triangle soup with some large and many small triangles
+sim::MeshBvh make_random_bvh(std::size_t numTriangles,
+                             std::mt19937 *pGen,
+                             std::vector<glm::vec3> *pPositions,
+                             const sim::BvhBuildOptions &options = {})
+{
+    std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+
+    pPositions->clear();
+    std::vector<unsigned> triangles;
+    for (std::size_t t = 0; t < numTriangles; ++t) {
+        glm::vec3 center{position(*pGen), position(*pGen), position(*pGen)};
+        float scale = (t % 50 == 0) ? 8.0f : 1.0f;
+        for (int k = 0; k < 3; ++k) {
+            triangles.push_back(static_cast<unsigned>(pPositions->size()));
+            pPositions->push_back(center + glm::vec3(offset(*pGen), offset(*pGen), offset(*pGen)) * scale);
+        }
+    }
+    return sim::MeshBvh(*pPositions, triangles, options);
+}
+
+/// Reference nearest hit by testing every triangle on its own
+class BruteForce
+{
+public:
+    explicit BruteForce(const std::vector<glm::vec3> &positions)
+    {
+        for (std::size_t t = 0; t < positions.size() / 3; ++t) {
+            std::vector<glm::vec3> corners{positions[t * 3], positions[t * 3 + 1], positions[t * 3 + 2]};
+            triangles_.emplace_back(std::move(corners), std::vector<unsigned>{0, 1, 2});
+        }
+    }
+
+    float nearest(const sim::Ray &ray) const
+    {
+        float t = std::numeric_limits<float>::infinity();
+        for (const sim::MeshBvh &triangle : triangles_) {
+            sim::RayHit hit = triangle.intersect(ray);
+            if (hit.hit) {
+                t = std::min(t, hit.t);
+            }
+        }
+        return t;
+    }
+
+private:
+    std::vector<sim::MeshBvh> triangles_;
+};
+
+sim::Ray random_ray(std::mt19937 *pGen)
+{
+    std::uniform_real_distribution<float> position(-15.0f, 15.0f);
+    std::uniform_real_distribution<float> target(-8.0f, 8.0f);
+
+    sim::Ray ray;
+    ray.origin = {position(*pGen), position(*pGen), 20.0f};
+    ray.direction = glm::normalize(glm::vec3(target(*pGen), target(*pGen), target(*pGen)) - ray.origin);
+    return ray;
+}
+
+} // namespace
+
+TEST(MeshBvhTests, hit_reports_distance_and_barycentrics)
+{
+    sim::MeshBvh bvh({{0, 0, 0}, {1, 0, 0}, {0, 1, 0}}, {0, 1, 2});
+
+    sim::Ray ray;
+    ray.origin = {0.25f, 0.5f, 2.0f};
+    ray.direction = {0, 0, -1};
+
+    sim::RayHit hit = bvh.intersect(ray);
+    ASSERT_TRUE(hit.hit);
+    EXPECT_FLOAT_EQ(2.0f, hit.t);
+    EXPECT_EQ(0u, hit.triangle);
+    EXPECT_FLOAT_EQ(0.25f, hit.barycentrics.x);
+    EXPECT_FLOAT_EQ(0.5f, hit.barycentrics.y);
+    EXPECT_EQ(glm::vec3(0.25f, 0.5f, 0.0f), hit.position);
+
+    ray.tMax = 1.5f;
+    EXPECT_FALSE(bvh.intersect(ray).hit);
+
+    ray.tMax = std::numeric_limits<float>::infinity();
+    ray.origin = {0.75f, 0.75f, 2.0f};
+    EXPECT_FALSE(bvh.intersect(ray).hit);
+    EXPECT_FALSE(bvh.occluded(ray));
+}
+
+TEST(MeshBvhTests, matches_brute_force_on_random_triangles)
+{
+    std::mt19937 gen(3);
+    std::vector<glm::vec3> positions;
+    sim::MeshBvh bvh = make_random_bvh(2000, &gen, &positions);
+
+    ASSERT_EQ(2000u, bvh.getNumTriangles());
+    EXPECT_LE(bvh.getNodes().size(), 2 * 2000u - 1);
+
+    BruteForce reference(positions);
+    std::size_t hits = 0;
+    for (int i = 0; i < 200; ++i) {
+        sim::Ray ray = random_ray(&gen);
+        float expected = reference.nearest(ray);
+        sim::RayHit hit = bvh.intersect(ray);
+
+        ASSERT_EQ(expected != std::numeric_limits<float>::infinity(), hit.hit) << i;
+        if (hit.hit) {
+            EXPECT_FLOAT_EQ(expected, hit.t) << i;
+            ++hits;
+        }
+    }
+    EXPECT_GT(hits, 50u);
+}
+
+TEST(MeshBvhTests, occluded_matches_brute_force)
+{
+    std::mt19937 gen(5);
+    std::vector<glm::vec3> positions;
+    sim::MeshBvh bvh = make_random_bvh(2000, &gen, &positions);
+
+    BruteForce reference(positions);
+    std::size_t hits = 0, clipped = 0;
+    for (int i = 0; i < 200; ++i) {
+        sim::Ray ray = random_ray(&gen);
+        float expected = reference.nearest(ray);
+        bool hit = expected != std::numeric_limits<float>::infinity();
+
+        EXPECT_EQ(hit, bvh.occluded(ray)) << i;
+        hits += hit ? 1 : 0;
+
+        // only hits before tMax count
+        if (hit) {
+            ray.tMax = expected * 0.999f;
+            EXPECT_EQ(reference.nearest(ray) <= ray.tMax, bvh.occluded(ray)) << i;
+            clipped += bvh.occluded(ray) ? 0 : 1;
+        }
+    }
+    EXPECT_GT(hits, 50u);
+    EXPECT_GT(clipped, 0u);
+}
+
+TEST(MeshBvhTests, parallel_build_matches_brute_force)
+{
+    // low thresholds and more threads than the machine may have so every parallel path runs
+    sim::BvhBuildOptions options;
+    options.parallelBinTriangles = 512;
+    options.parallelSubtreeTriangles = 256;
+    options.maxThreads = 8;
+
+    std::mt19937 gen(7);
+    std::vector<glm::vec3> positions;
+    sim::MeshBvh bvh = make_random_bvh(4000, &gen, &positions, options);
+
+    ASSERT_EQ(4000u, bvh.getNumTriangles());
+    EXPECT_LE(bvh.getNodes().size(), 2 * 4000u - 1);
+
+    // the subtrees built on other threads still add up to every triangle
+    std::size_t numInLeaves = 0;
+    for (const sim::BvhNode &node : bvh.getNodes()) {
+        numInLeaves += node.count;
+    }
+    EXPECT_EQ(bvh.getNumTriangles(), numInLeaves);
+
+    BruteForce reference(positions);
+    std::size_t hits = 0;
+    for (int i = 0; i < 200; ++i) {
+        sim::Ray ray = random_ray(&gen);
+        float expected = reference.nearest(ray);
+        sim::RayHit hit = bvh.intersect(ray);
+
+        ASSERT_EQ(expected != std::numeric_limits<float>::infinity(), hit.hit) << i;
+        EXPECT_EQ(hit.hit, bvh.occluded(ray)) << i;
+        if (hit.hit) {
+            EXPECT_FLOAT_EQ(expected, hit.t) << i;
+            ++hits;
+        }
+    }
+    EXPECT_GT(hits, 50u);
+}
+
+TEST(MeshBvhTests, refit_follows_moved_vertices)
+{
+    std::mt19937 gen(5);
+    std::vector<glm::vec3> positions;
+    sim::MeshBvh bvh = make_random_bvh(500, &gen, &positions);
+
+    for (glm::vec3 &p : positions) {
+        p = p * 0.5f + glm::vec3(0, 3, 0);
+    }
+    bvh.refit(positions);
+
+    sim::AABB expectedBounds;
+    for (const glm::vec3 &p : positions) {
+        expectedBounds.expand(p);
+    }
+    EXPECT_EQ(expectedBounds.lower, bvh.getBounds().lower);
+    EXPECT_EQ(expectedBounds.upper, bvh.getBounds().upper);
+
+    BruteForce reference(positions);
+    for (int i = 0; i < 100; ++i) {
+        sim::Ray ray = random_ray(&gen);
+        float expected = reference.nearest(ray);
+        sim::RayHit hit = bvh.intersect(ray);
+        ASSERT_EQ(expected != std::numeric_limits<float>::infinity(), hit.hit) << i;
+        if (hit.hit) {
+            EXPECT_FLOAT_EQ(expected, hit.t) << i;
+        }
+    }
+
+    EXPECT_THROW(bvh.refit(std::vector<glm::vec3>(3)), std::runtime_error);
+}
+
+TEST(MeshBvhTests, builds_from_strip_draw_data)
+{
+    auto data = sim::create_sphere_mesh_data<sim::PosNormTexVertex>(32, 16);
+    sim::MeshBvh bvh(sim::PosNormTexDataView(data), GL_TRIANGLE_STRIP);
+
+    sim::Ray ray;
+    ray.origin = {0, 0, 5};
+    ray.direction = {0, 0, -1};
+
+    sim::RayHit hit = bvh.intersect(ray);
+    ASSERT_TRUE(hit.hit);
+    EXPECT_NEAR(1.0f, glm::length(hit.position), 0.02f);
+    EXPECT_GT(hit.position.z, 0.0f);
+}
+
+TEST(MeshBvhTests, screen_ray_goes_through_the_cursor)
+{
+    sim::Camera camera;
+    camera.lookAt({0, 0, 5}, {0, 0, 0});
+    camera.perspective(90.0f, 2.0f, 0.5f, 100.0f);
+
+    // center of the window looks straight ahead
+    sim::Ray center = sim::screen_ray(400, 200, 800, 400, camera);
+    EXPECT_NEAR(0.0f, glm::length(center.direction - glm::vec3(0, 0, -1)), 1e-5f);
+    EXPECT_NEAR(0.0f, glm::length(center.origin - glm::vec3(0, 0, 4.5f)), 1e-5f);
+
+    // top right corner: tan(45) = 1 up and 2 right per unit forward
+    sim::Ray corner = sim::screen_ray(800, 0, 800, 400, camera);
+    EXPECT_NEAR(0.0f, glm::length(corner.direction - glm::normalize(glm::vec3(2, 1, -1))), 1e-5f);
+}
@@ -0,0 +1,79 @@
+#include <sim-driver/meshes/MeshCache.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+
+std::shared_ptr<const sim::PosData> make_data(std::size_t numVerts)
+{
+    auto spData = std::make_shared<sim::PosData>();
+    spData->vbo.resize(numVerts);
+    return spData;
+}
+
+sim::MeshKey make_key(int u, int v)
+{
+    return {0, 1, u, v, 0};
+}
+
+} // namespace
+
+TEST(MeshCacheTests, hits_and_misses_are_counted)
+{
+    sim::PosMeshCache cache;
+
+    EXPECT_EQ(nullptr, cache.findData(make_key(1, 1)));
+    cache.insert(make_key(1, 1), make_data(10));
+
+    auto spData = cache.findData(make_key(1, 1));
+    ASSERT_NE(nullptr, spData);
+    EXPECT_EQ(10u, spData->vbo.size());
+
+    EXPECT_EQ(1u, cache.getStats().hits);
+    EXPECT_EQ(1u, cache.getStats().misses);
+    EXPECT_EQ(1u, cache.getStats().numEntries);
+    EXPECT_EQ(10 * sizeof(sim::PosVertex), cache.getStats().memoryBytes);
+
+    // same resolution of a different generator
+    EXPECT_EQ(nullptr, cache.findData({0, 2, 1, 1, 0}));
+}
+
+TEST(MeshCacheTests, least_recently_used_entries_are_evicted_first)
+{
+    const std::size_t meshBytes = 100 * sizeof(sim::PosVertex);
+    sim::PosMeshCache cache(meshBytes * 2);
+
+    cache.insert(make_key(1, 1), make_data(100));
+    cache.insert(make_key(2, 2), make_data(100));
+    EXPECT_NE(nullptr, cache.findData(make_key(1, 1))); // (2, 2) is now the oldest
+
+    cache.insert(make_key(3, 3), make_data(100));
+
+    EXPECT_NE(nullptr, cache.findData(make_key(1, 1)));
+    EXPECT_EQ(nullptr, cache.findData(make_key(2, 2)));
+    EXPECT_NE(nullptr, cache.findData(make_key(3, 3)));
+    EXPECT_EQ(1u, cache.getStats().evictions);
+    EXPECT_EQ(meshBytes * 2, cache.getStats().memoryBytes);
+
+    cache.setBudget(0);
+    EXPECT_EQ(0u, cache.getStats().numEntries);
+    EXPECT_EQ(0u, cache.getStats().memoryBytes);
+}
+
+TEST(MeshCacheTests, buffers_are_only_returned_once_uploaded)
+{
+    sim::PosMeshCache cache;
+    cache.insert(make_key(4, 4), make_data(10));
+
+    EXPECT_EQ(nullptr, cache.findBuffers(make_key(4, 4)));
+
+    sim::MeshBuffers buffers;
+    buffers.vbo = std::make_shared<GLuint>(7);
+    buffers.vboSize = 10;
+    cache.setBuffers(make_key(4, 4), buffers);
+
+    const sim::MeshBuffers *pBuffers = cache.findBuffers(make_key(4, 4));
+    ASSERT_NE(nullptr, pBuffers);
+    EXPECT_EQ(7u, *pBuffers->vbo);
+    EXPECT_EQ(2 * 10 * sizeof(sim::PosVertex), cache.getStats().memoryBytes); // cpu + gpu copies
+}
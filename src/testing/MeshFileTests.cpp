@@ -0,0 +1,202 @@
+#include <sim-driver/meshes/MeshFile.hpp>
+#include <sim-driver/OpenGLHelper.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string temp_filename(const std::string &name)
+{
+    return ::testing::TempDir() + name;
+}
+
+sim::PosNormTexData make_quad()
+{
+    sim::PosNormTexData data;
+    data.vbo = {{{0, 0, 0}, {0, 0, 1}, {0, 0}},
+                {{1, 0, 0}, {0, 0, 1}, {1, 0}},
+                {{1, 1, 0}, {0, 0, 1}, {1, 1}},
+                {{0, 1, 0}, {0, 0, 1}, {0, 1}}};
+    data.ibo = {0, 1, 2, 0, 2, 3};
+    return data;
+}
+
+std::vector<char> read_file(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void write_file(const std::string &filename, const std::vector<char> &bytes)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+std::size_t section_offset(const std::vector<char> &bytes, sim::MeshFileSectionType type)
+{
+    sim::MeshFileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    for (std::uint32_t i = 0; i < header.numSections; ++i) {
+        sim::MeshFileSection section;
+        std::memcpy(&section, bytes.data() + sizeof(header) + sizeof(section) * i, sizeof(section));
+        if (section.type == static_cast<std::uint32_t>(type)) {
+            return static_cast<std::size_t>(section.offset);
+        }
+    }
+    throw std::runtime_error("Section not found");
+}
+
+} // namespace
+
+TEST(MeshFileTests, single_level_round_trip)
+{
+    const std::string filename = temp_filename("single_level.simmesh");
+    sim::PosNormTexData quad = make_quad();
+    quad.vbo.resize(70000, quad.vbo.back()); // forces 32 bit indices
+
+    sim::write_mesh_file(filename, quad, GL_TRIANGLES);
+    sim::MeshFile file(filename);
+
+    EXPECT_EQ(GLenum{GL_TRIANGLES}, file.getDrawMode());
+    EXPECT_EQ(GLenum{GL_UNSIGNED_INT}, file.getIndexType());
+    EXPECT_EQ(1u, file.getNumLevels());
+    EXPECT_TRUE(file.hasLayout<sim::PosNormTexVertex>());
+    EXPECT_FALSE(file.hasLayout<sim::PosVertex>());
+
+    sim::PosNormTexDataView view = file.getDataView<sim::PosNormTexVertex>();
+    ASSERT_EQ(quad.vbo.size(), view.vboSize);
+    ASSERT_EQ(quad.ibo.size(), view.iboSize);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(view.vbo) % sim::mesh_file_alignment);
+
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t k = 0; k < 3; ++k) {
+            EXPECT_EQ(quad.vbo[i].position[k], view.vbo[i].position[k]);
+        }
+    }
+    for (std::size_t i = 0; i < quad.ibo.size(); ++i) {
+        EXPECT_EQ(quad.ibo[i], view.ibo[i]);
+    }
+
+    ASSERT_NE(nullptr, file.getBounds());
+    EXPECT_EQ(glm::vec3(0, 0, 0), file.getBox().lower);
+    EXPECT_EQ(glm::vec3(1, 1, 0), file.getBox().upper);
+
+    std::remove(filename.c_str());
+}
+
+TEST(MeshFileTests, lod_chain_round_trip)
+{
+    const std::string filename = temp_filename("lod_chain.simmesh");
+    sim::PosNormTexData quad = make_quad();
+
+    sim::PosNormTexData triangle;
+    triangle.vbo = {quad.vbo[0], quad.vbo[1], quad.vbo[2]};
+    triangle.ibo = {0, 1, 2};
+
+    std::vector<sim::MeshLod> lods = {{quad, 0.0f}, {triangle, 0.5f}};
+    sim::write_mesh_file(filename, lods);
+    sim::MeshFile file(filename);
+
+    EXPECT_EQ(GLenum{GL_UNSIGNED_SHORT}, file.getIndexType());
+    ASSERT_EQ(2u, file.getNumLevels());
+
+    sim::MeshFileLod level = file.getLevel(1);
+    EXPECT_EQ(6u, level.firstIndex);
+    EXPECT_EQ(3u, level.numIndices);
+    EXPECT_EQ(4u, level.baseVertex);
+    EXPECT_EQ(3u, level.numVertices);
+    EXPECT_EQ(0.5f, level.error);
+
+    // level indices are relative to their first vertex
+    const auto *pIndices = static_cast<const GLushort *>(file.getIndexData());
+    EXPECT_EQ(0u, pIndices[level.firstIndex]);
+    EXPECT_EQ(2u, pIndices[level.firstIndex + 2]);
+
+    EXPECT_THROW(file.getDataView<sim::PosNormTexVertex>(), std::runtime_error);
+    EXPECT_THROW(file.getLevel(2), std::runtime_error);
+
+    std::remove(filename.c_str());
+}
+
+TEST(MeshFileTests, invalid_files_throw)
+{
+    const std::string filename = temp_filename("invalid.simmesh");
+    {
+        std::FILE *pFile = std::fopen(filename.c_str(), "wb");
+        std::fputs("definitely not a mesh file, but long enough to hold a header", pFile);
+        std::fclose(pFile);
+    }
+    EXPECT_THROW(sim::MeshFile file(filename), std::runtime_error);
+    EXPECT_THROW(sim::MeshFile file(temp_filename("missing.simmesh")), std::runtime_error);
+
+    std::remove(filename.c_str());
+}
+
+TEST(MeshFileTests, out_of_range_indices_throw)
+{
+    const std::string filename = temp_filename("bad_indices.simmesh");
+
+    sim::PosNormTexData quad = make_quad();
+    quad.ibo.back() = 4; // one past the last vertex
+    sim::write_mesh_file(filename, quad, GL_TRIANGLES);
+    EXPECT_THROW(sim::MeshFile file(filename, true), std::runtime_error);
+
+    // the indices are only read when asked to
+    EXPECT_NO_THROW(sim::MeshFile file(filename));
+
+    // restart indices don't refer to a vertex
+    quad.ibo = {0, 1, 2, sim::primitiveRestart(), 0, 2, 3};
+    sim::write_mesh_file(filename, quad, GL_TRIANGLE_STRIP);
+    sim::MeshFile file(filename, true);
+    EXPECT_EQ(7u, file.getLevel(0).numIndices);
+
+    std::remove(filename.c_str());
+}
+
+TEST(MeshFileTests, wrapping_counts_throw)
+{
+    const std::string filename = temp_filename("wrapping.simmesh");
+    sim::PosNormTexData quad = make_quad();
+
+    sim::PosNormTexData triangle;
+    triangle.vbo = {quad.vbo[0], quad.vbo[1], quad.vbo[2]};
+    triangle.ibo = {0, 1, 2};
+
+    std::vector<sim::MeshLod> lods = {{quad, 0.0f}, {triangle, 0.5f}};
+    sim::write_mesh_file(filename, lods);
+    const std::vector<char> original = read_file(filename);
+
+    sim::MeshFileHeader header;
+    std::memcpy(&header, original.data(), sizeof(header));
+
+    // firstIndex + numIndices wraps around to a count inside the index data
+    std::vector<char> bytes = original;
+    sim::MeshFileLod lod;
+    const std::size_t lodOffset = section_offset(bytes, sim::MeshFileSectionType::Lods) + sizeof(lod);
+    std::memcpy(&lod, bytes.data() + lodOffset, sizeof(lod));
+    lod.firstIndex = std::numeric_limits<std::uint64_t>::max() - 1;
+    std::memcpy(bytes.data() + lodOffset, &lod, sizeof(lod));
+    write_file(filename, bytes);
+    EXPECT_THROW(sim::MeshFile file(filename), std::runtime_error);
+
+    // stride * numVertices wraps around to the size of the vertex section
+    bytes = original;
+    header.numVertices += std::uint64_t{1} << 59u; // 2^64 / sizeof(PosNormTexVertex)
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    write_file(filename, bytes);
+    EXPECT_THROW(sim::MeshFile file(filename), std::runtime_error);
+
+    write_file(filename, original);
+    EXPECT_NO_THROW(sim::MeshFile file(filename));
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,91 @@
+#include <sim-driver/meshes/MeshHelper.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+namespace {
+
+sim::PosData make_fan(int u, int v)
+{
+    sim::PosData data;
+    data.vbo.resize(static_cast<std::size_t>(u * v));
+    for (unsigned i = 2; i < data.vbo.size(); ++i) {
+        data.ibo.insert(data.ibo.end(), {0, i - 1, i});
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(MeshHelperTests, cache_hit_supersedes_background_request)
+{
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+
+    sim::PosMesh mesh([&](int u, int v) {
+        if (u == 1) {
+            started = true;
+            while (!release) {
+                std::this_thread::yield();
+            }
+        }
+        sim::PosData data;
+        data.vbo.resize(static_cast<std::size_t>(u * v));
+        return data;
+    });
+
+    auto spCache = std::make_shared<sim::PosMeshCache>();
+    sim::PosData cached;
+    cached.vbo.resize(6);
+    spCache->insert(mesh.makeKey(2, 3), std::make_shared<const sim::PosData>(cached));
+
+    mesh.setCache(spCache);
+    mesh.setAsync(true);
+
+    // A is generated in the background
+    EXPECT_FALSE(mesh.setDivisions(1, 1));
+    while (!started) {
+        std::this_thread::yield();
+    }
+
+    // B comes from the cache while A is still generating
+    EXPECT_TRUE(mesh.setDivisions(2, 3));
+    release = true;
+
+    while (mesh.isGenerating()) {
+        std::this_thread::yield();
+    }
+
+    EXPECT_FALSE(mesh.pollData());
+    EXPECT_EQ(mesh.makeKey(2, 3), mesh.getMeshKey());
+    EXPECT_EQ(6u, mesh.getMeshData().vbo.size());
+}
+
+TEST(MeshHelperTests, cached_meshes_keep_their_optimization_stats)
+{
+    auto spCache = std::make_shared<sim::PosMeshCache>();
+
+    sim::PosMesh first(make_fan);
+    first.setCache(spCache);
+    first.setIndexOptimization(true, GL_TRIANGLES);
+    first.setDivisions(4, 5);
+
+    sim::MeshOptimizationStats stats;
+    ASSERT_TRUE(first.getOptimizationStats(&stats));
+    EXPECT_EQ(18u, stats.numTriangles);
+
+    // the second helper uses the same generator so it finds the first one's mesh in the cache
+    sim::PosMesh second(make_fan);
+    second.setCache(spCache);
+    second.setIndexOptimization(true, GL_TRIANGLES);
+    const std::size_t misses = spCache->getStats().misses;
+    second.setDivisions(4, 5);
+    EXPECT_EQ(misses, spCache->getStats().misses);
+
+    sim::MeshOptimizationStats cachedStats;
+    ASSERT_TRUE(second.getOptimizationStats(&cachedStats));
+    EXPECT_EQ(stats.numTriangles, cachedStats.numTriangles);
+
+    second.setIndexOptimization(false, GL_TRIANGLES);
+    EXPECT_FALSE(second.getOptimizationStats(&cachedStats));
+}
@@ -0,0 +1,197 @@
+#include <sim-driver/meshes/MeshImport.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+TEST(MeshImportTests, obj_polygons_are_triangulated_and_vertices_shared)
+{
+    const std::string obj = "# quad\n"
+                            "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+                            "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+                            "f 1/1 2/2 3/3 4/4\n"
+                            "f -4/-4 -2/-2 -1/-1\n";
+
+    sim::PosNormTexData data = sim::import_obj(obj.data(), obj.size());
+
+    EXPECT_EQ(4u, data.vbo.size());
+    EXPECT_EQ((std::vector<unsigned>{0, 1, 2, 0, 2, 3, 0, 2, 3}), data.ibo);
+    EXPECT_FLOAT_EQ(1.0f, data.vbo[2].texCoords[1]);
+    EXPECT_FLOAT_EQ(1.0f, data.vbo[0].normal[2]); // computed from the winding
+}
+
+TEST(MeshImportTests, ascii_ply)
+{
+    const std::string ply = "ply\n"
+                            "format ascii 1.0\n"
+                            "element vertex 3\n"
+                            "property float x\nproperty float y\nproperty float z\n"
+                            "property float nx\nproperty float ny\nproperty float nz\n"
+                            "element face 1\n"
+                            "property list uchar int vertex_indices\n"
+                            "end_header\n"
+                            "0 0 0 0 0 -1\n"
+                            "1 0 0 0 0 -1\n"
+                            "0 1 0 0 0 -1\n"
+                            "3 0 1 2\n";
+
+    sim::PosNormTexData data = sim::import_ply(ply.data(), ply.size());
+
+    ASSERT_EQ(3u, data.vbo.size());
+    EXPECT_EQ((std::vector<unsigned>{0, 1, 2}), data.ibo);
+    EXPECT_FLOAT_EQ(-1.0f, data.vbo[1].normal[2]); // stored normals are kept
+    EXPECT_FLOAT_EQ(1.0f, data.vbo[2].position[1]);
+}
+
+TEST(MeshImportTests, ascii_ply_lists_before_scalars)
+{
+    const std::string ply = "ply\n"
+                            "format ascii 1.0\n"
+                            "element vertex 3\n"
+                            "property list uchar int bones\n"
+                            "property float x\nproperty float y\nproperty float z\n"
+                            "property float s\nproperty float t\n"
+                            "element face 1\n"
+                            "property list uchar int vertex_indices\n"
+                            "end_header\n"
+                            "2 9 9 1 2 3 0.25 0.75\n"
+                            "0 4 5 6 0.5 1\n"
+                            "1 7 0 1 0 0 0\n"
+                            "3 0 1 2\n";
+
+    sim::PosNormTexData data = sim::import_ply(ply.data(), ply.size());
+
+    ASSERT_EQ(3u, data.vbo.size());
+    EXPECT_EQ((std::vector<unsigned>{0, 1, 2}), data.ibo);
+    EXPECT_EQ(1.0f, data.vbo[0].position[0]);
+    EXPECT_EQ(3.0f, data.vbo[0].position[2]);
+    EXPECT_EQ(0.75f, data.vbo[0].texCoords[1]);
+    EXPECT_EQ(4.0f, data.vbo[1].position[0]);
+    EXPECT_EQ(0.5f, data.vbo[1].texCoords[0]);
+}
+
+TEST(MeshImportTests, binary_ply)
+{
+    std::string ply = "ply\n"
+                      "format binary_little_endian 1.0\n"
+                      "element vertex 3\n"
+                      "property float x\nproperty float y\nproperty float z\n"
+                      "element face 1\n"
+                      "property list uchar uint vertex_indices\n"
+                      "end_header\n";
+
+    const float positions[9] = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+    const unsigned indices[3] = {0, 1, 2};
+    ply.append(reinterpret_cast<const char *>(positions), sizeof(positions));
+    ply.push_back('\3');
+    ply.append(reinterpret_cast<const char *>(indices), sizeof(indices));
+
+    sim::PosNormTexData data = sim::import_ply(ply.data(), ply.size());
+
+    ASSERT_EQ(3u, data.vbo.size());
+    EXPECT_EQ((std::vector<unsigned>{0, 1, 2}), data.ibo);
+    EXPECT_FLOAT_EQ(1.0f, data.vbo[1].position[0]);
+    EXPECT_FLOAT_EQ(1.0f, data.vbo[0].normal[2]);
+
+    EXPECT_THROW(sim::import_ply(ply.data(), ply.size() - 1), std::runtime_error);
+}
+
+TEST(MeshImportTests, parse_float_matches_strtof)
+{
+    const char *inputs[] = {"0", "-1.5", "+3.25e2", "1e-7", "123456789.123456789", ".5", "6.02214076E23", "-0.0001"};
+
+    for (const char *input : inputs) {
+        const char *p = input;
+        float value = 0.0f;
+        ASSERT_TRUE(sim::parse_float(p, input + std::strlen(input), &value)) << input;
+        EXPECT_EQ(std::strtof(input, nullptr), value) << input;
+        EXPECT_EQ(input + std::strlen(input), p);
+    }
+
+    const std::string text = "  nan x";
+    const char *p = text.c_str();
+    float value = 0.0f;
+    EXPECT_TRUE(sim::parse_float(p, text.c_str() + text.size(), &value));
+    EXPECT_TRUE(std::isnan(value));
+    EXPECT_FALSE(sim::parse_float(p, text.c_str() + text.size(), &value));
+}
+
+TEST(MeshImportTests, chunked_obj_matches_single_chunk)
+{
+    // a grid of quads with shared texture coordinates and normals spread over many lines
+    std::ostringstream obj;
+    const int n = 20;
+    for (int y = 0; y <= n; ++y) {
+        for (int x = 0; x <= n; ++x) {
+            obj << "v " << x * 0.1 << ' ' << y * 0.1 << " 0\n";
+            obj << "vt " << x / float(n) << ' ' << y / float(n) << '\n';
+        }
+    }
+    obj << "vn 0 0 1\n";
+    for (int y = 0; y < n; ++y) {
+        for (int x = 0; x < n; ++x) {
+            int a = y * (n + 1) + x + 1;
+            int b = a + 1;
+            int c = a + n + 2;
+            int d = a + n + 1;
+            obj << "f " << a << '/' << a << "/1 " << b << '/' << b << "/1 " << c << '/' << c << "/1 " << d << '/'
+                << d << "/1\n";
+        }
+    }
+    // relative indices refer to the attributes read before the face, whichever chunk they're in
+    obj << "v 5 5 5\nf -1//1 1//1 2//1\n";
+    const std::string text = obj.str();
+
+    sim::PosNormTexData single = sim::import_obj(text.data(), text.size(), text.size());
+    sim::PosNormTexData chunked = sim::import_obj(text.data(), text.size(), 64);
+
+    ASSERT_EQ((n + 1) * (n + 1) + 3u, single.vbo.size());
+    ASSERT_EQ(single.vbo.size(), chunked.vbo.size());
+    EXPECT_EQ(single.ibo, chunked.ibo);
+    for (std::size_t v = 0; v < single.vbo.size(); ++v) {
+        for (std::size_t k = 0; k < 3; ++k) {
+            EXPECT_EQ(single.vbo[v].position[k], chunked.vbo[v].position[k]);
+        }
+    }
+    EXPECT_FLOAT_EQ(5.0f, single.vbo[single.ibo[single.ibo.size() - 3]].position[0]);
+}
+
+TEST(MeshImportTests, chunked_ascii_ply_matches_single_chunk)
+{
+    std::ostringstream ply;
+    const int numVertices = 200;
+    ply << "ply\nformat ascii 1.0\nelement vertex " << numVertices << "\n"
+        << "property float x\nproperty float y\nproperty float z\n"
+        << "element face " << numVertices - 2 << "\nproperty list uchar int vertex_indices\nend_header\n";
+    for (int v = 0; v < numVertices; ++v) {
+        ply << v % 2 << ' ' << v / 2 << " 0\n";
+    }
+    for (int f = 0; f + 2 < numVertices; ++f) {
+        ply << "3 " << f << ' ' << f + 1 << ' ' << f + 2 << '\n';
+    }
+    const std::string text = ply.str();
+
+    sim::PosNormTexData single = sim::import_ply(text.data(), text.size(), text.size());
+    sim::PosNormTexData chunked = sim::import_ply(text.data(), text.size(), 32);
+
+    ASSERT_EQ(std::size_t(numVertices), chunked.vbo.size());
+    EXPECT_EQ(single.ibo, chunked.ibo);
+    EXPECT_EQ(3u * (numVertices - 2), chunked.ibo.size());
+    EXPECT_FLOAT_EQ(99.0f, chunked.vbo[numVertices - 1].position[1]);
+}
+
+TEST(MeshImportTests, malformed_input_throws)
+{
+    const std::string badIndex = "v 0 0 0\nf 1 2 3\n";
+    EXPECT_THROW(sim::import_obj(badIndex.data(), badIndex.size()), std::runtime_error);
+
+    const std::string badNumber = "v 0 zero 0\n";
+    EXPECT_THROW(sim::import_obj(badNumber.data(), badNumber.size()), std::runtime_error);
+
+    const std::string shortPly = "ply\nformat ascii 1.0\nelement vertex 2\nproperty float x\nproperty float y\n"
+                                 "property float z\nend_header\n0 0 0\n";
+    EXPECT_THROW(sim::import_ply(shortPly.data(), shortPly.size()), std::runtime_error);
+}
@@ -0,0 +1,103 @@
+#include <sim-driver/meshes/MeshNormals.hpp>
+#include <sim-driver/meshes/MeshFunctions.hpp>
+#include <sim-driver/VertexFormat.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+
+sim::PosNormTexData make_quad(float vSign)
+{
+    sim::PosNormTexData data;
+    data.vbo = {{{0, 0, 0}, {0, 0, 0}, {0, 0}},
+                {{1, 0, 0}, {0, 0, 0}, {1, 0}},
+                {{1, 1, 0}, {0, 0, 0}, {1, vSign}},
+                {{0, 1, 0}, {0, 0, 0}, {0, vSign}}};
+    data.ibo = {0, 1, 2, 0, 2, 3};
+    return data;
+}
+
+glm::vec3 normal_of(const sim::PosNormTexVertex &vertex)
+{
+    return {vertex.normal[0], vertex.normal[1], vertex.normal[2]};
+}
+
+} // namespace
+
+TEST(MeshNormalsTests, sphere_strip_normals_point_outwards)
+{
+    auto reference = sim::create_sphere_mesh_data<sim::PosNormTexVertex>(32, 16);
+
+    for (sim::NormalWeighting weighting : {sim::NormalWeighting::Area, sim::NormalWeighting::Angle}) {
+        sim::PosNormTexData data = reference;
+        sim::compute_normals(&data, GL_TRIANGLE_STRIP, weighting);
+
+        for (std::size_t v = 0; v < data.vbo.size(); ++v) {
+            glm::vec3 expected = glm::normalize(normal_of(reference.vbo[v]));
+            glm::vec3 computed = normal_of(data.vbo[v]);
+            if (computed == glm::vec3(0.0f)) {
+                continue; // unused vertices
+            }
+            EXPECT_NEAR(1.0f, glm::length(computed), 1e-5f);
+            EXPECT_GT(glm::dot(expected, computed), 0.99f) << "vertex " << v;
+        }
+    }
+}
+
+TEST(MeshNormalsTests, angle_weighting_ignores_tessellation_and_area)
+{
+    // a corner of a box: the z = 0 face is larger and split into many thin triangles around the corner
+    sim::PosNormTexData data;
+    data.vbo = {{{0, 0, 0}, {}, {}}, {{1, 0, 0}, {}, {}}, {{0, 1, 0}, {}, {}}, {{0, 0, 1}, {}, {}}};
+    data.ibo = {0, 2, 3, 0, 3, 1};
+
+    const int numSplits = 10;
+    for (int i = 0; i <= numSplits + 1; ++i) {
+        float t = float(i) / (numSplits + 1);
+        data.vbo.push_back({{3 * (1 - t), 3 * t, 0}, {}, {}});
+    }
+    for (int i = 0; i <= numSplits; ++i) {
+        data.ibo.insert(data.ibo.end(), {0, unsigned(4 + i), unsigned(5 + i)});
+    }
+
+    const glm::vec3 expected = glm::normalize(glm::vec3(1.0f));
+
+    sim::compute_normals(&data, GL_TRIANGLES, sim::NormalWeighting::Angle);
+    EXPECT_NEAR(1.0f, glm::dot(normal_of(data.vbo[0]), expected), 1e-5f);
+
+    sim::compute_normals(&data, GL_TRIANGLES, sim::NormalWeighting::Area);
+    EXPECT_GT(normal_of(data.vbo[0]).z, expected.z + 0.1f); // pulled towards the large face
+}
+
+TEST(MeshNormalsTests, kernel_refreshes_deformed_vertices)
+{
+    sim::PosNormTexData data = make_quad(1.0f);
+    sim::NormalKernel kernel(data, GL_TRIANGLES);
+    EXPECT_EQ(2u, kernel.getNumTriangles());
+
+    kernel.computeNormals(data.vbo.data());
+    EXPECT_EQ(glm::vec3(0, 0, 1), normal_of(data.vbo[0]));
+
+    // rotate the quad into the xz plane
+    for (sim::PosNormTexVertex &vertex : data.vbo) {
+        std::swap(vertex.position[1], vertex.position[2]);
+    }
+    kernel.computeNormals(data.vbo.data());
+    EXPECT_EQ(glm::vec3(0, -1, 0), normal_of(data.vbo[2]));
+}
+
+TEST(MeshNormalsTests, tangents_follow_texture_coordinates)
+{
+    for (float vSign : {1.0f, -1.0f}) {
+        sim::PosNormTexData data = make_quad(vSign);
+        sim::compute_normals(&data, GL_TRIANGLES);
+        std::vector<glm::vec4> tangents = sim::compute_tangents(data, GL_TRIANGLES);
+
+        ASSERT_EQ(data.vbo.size(), tangents.size());
+        for (const glm::vec4 &tangent : tangents) {
+            EXPECT_NEAR(1.0f, tangent.x, 1e-6f);
+            EXPECT_NEAR(0.0f, tangent.y, 1e-6f);
+            EXPECT_NEAR(0.0f, tangent.z, 1e-6f);
+            EXPECT_EQ(vSign, tangent.w); // mirrored texture mapping flips the bitangent
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include <sim-driver/meshes/MeshOptimizer.hpp>
+#include <sim-driver/meshes/MeshFunctions.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+
+namespace {
+
+using Triangle = std::array<float, 9>;
+
+/// Positions of every triangle, rotated so the smallest vertex comes first (keeps winding)
+std::vector<Triangle> sorted_triangles(const sim::PosNormTexData &data)
+{
+    std::vector<Triangle> triangles;
+
+    for (std::size_t t = 0; t + 2 < data.ibo.size(); t += 3) {
+        std::array<std::array<float, 3>, 3> corners;
+        for (std::size_t k = 0; k < 3; ++k) {
+            const auto &p = data.vbo[data.ibo[t + k]].position;
+            corners[k] = {{p[0], p[1], p[2]}};
+        }
+        auto first = std::min_element(corners.begin(), corners.end());
+        std::rotate(corners.begin(), first, corners.end());
+
+        Triangle triangle;
+        for (std::size_t k = 0; k < 9; ++k) {
+            triangle[k] = corners[k / 3][k % 3];
+        }
+        triangles.push_back(triangle);
+    }
+
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+} // namespace
+
+TEST(MeshOptimizerTests, strips_are_converted_with_consistent_winding)
+{
+    const unsigned restart = sim::primitiveRestart();
+    std::vector<unsigned> strips = {0, 1, 2, 3, restart, 4, 5, 6, 6, 7};
+
+    std::vector<unsigned> expected = {0, 1, 2, 2, 1, 3, 4, 5, 6};
+    EXPECT_EQ(expected, sim::to_triangle_list(strips, GL_TRIANGLE_STRIP));
+
+    EXPECT_THROW(sim::to_triangle_list(strips, GL_LINES), std::runtime_error);
+}
+
+TEST(MeshOptimizerTests, acmr_counts_fifo_cache_misses)
+{
+    std::vector<unsigned> triangles = {0, 1, 2, 2, 1, 3};
+    EXPECT_FLOAT_EQ(2.0f, sim::compute_acmr(triangles, 4, 16));
+    EXPECT_FLOAT_EQ(3.0f, sim::compute_acmr(triangles, 4, 1)); // 1 and 2 were evicted by 2 and 3
+}
+
+TEST(MeshOptimizerTests, optimized_sphere_keeps_its_triangles_and_improves_acmr)
+{
+    sim::PosNormTexData data = sim::create_sphere_mesh_data<sim::PosNormTexVertex>(60, 60);
+    sim::PosNormTexData expected = data;
+    expected.ibo = sim::to_triangle_list(expected.ibo, GL_TRIANGLE_STRIP);
+
+    sim::MeshOptimizationStats stats = sim::optimize_mesh(&data, GL_TRIANGLE_STRIP);
+
+    EXPECT_EQ(expected.ibo.size() / 3, stats.numTriangles);
+    EXPECT_EQ(expected.ibo.size(), data.ibo.size());
+    EXPECT_EQ(expected.vbo.size(), data.vbo.size());
+    EXPECT_LT(stats.acmrAfter, stats.acmrBefore);
+    EXPECT_LT(stats.acmrAfter, 0.8f);
+
+    EXPECT_EQ(sorted_triangles(expected), sorted_triangles(data));
+
+    // vertices are stored in the order they are first used
+    unsigned nextNew = 0;
+    for (unsigned index : data.ibo) {
+        ASSERT_LE(index, nextNew);
+        nextNew = std::max(nextNew, index + 1);
+    }
+}
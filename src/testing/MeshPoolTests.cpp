@@ -0,0 +1,75 @@
+#include <sim-driver/renderers/MeshPool.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+
+sim::InstanceData make_instance(float x)
+{
+    sim::InstanceData instance;
+    instance.worldFromLocal = glm::mat4(1.0f);
+    instance.worldFromLocal[3] = glm::vec4(x, 0, 0, 1);
+    instance.color = glm::vec4(x);
+    return instance;
+}
+
+} // namespace
+
+TEST(MeshPoolTests, draw_command_uses_mesh_range)
+{
+    const sim::MeshRange range{120, 36, 48, 24};
+    const sim::DrawElementsIndirectCommand command = sim::make_draw_command(range);
+
+    EXPECT_EQ(36u, command.count);
+    EXPECT_EQ(1u, command.instanceCount);
+    EXPECT_EQ(120u, command.firstIndex);
+    EXPECT_EQ(48, command.baseVertex);
+    EXPECT_EQ(0u, command.baseInstance);
+}
+
+TEST(MeshPoolTests, compaction_keeps_queued_order)
+{
+    std::vector<sim::DrawElementsIndirectCommand> commands;
+    std::vector<sim::InstanceData> draws;
+    std::vector<std::size_t> meshes;
+    for (unsigned i = 0; i < 6; ++i) {
+        commands.push_back(sim::make_draw_command({i * 10, i + 1, static_cast<GLint>(i), 3}));
+        draws.push_back(make_instance(static_cast<float>(i)));
+        meshes.push_back(i % 2);
+    }
+
+    const unsigned char visible[] = {0, 1, 1, 0, 0, 1};
+    EXPECT_EQ(3u, sim::compact_draws(visible, &commands, &draws, &meshes));
+
+    ASSERT_EQ(3u, commands.size());
+    ASSERT_EQ(3u, draws.size());
+    ASSERT_EQ(3u, meshes.size());
+
+    const unsigned kept[] = {1, 2, 5};
+    for (std::size_t i = 0; i < 3; ++i) {
+        // every array still refers to the same draw
+        EXPECT_EQ(kept[i] * 10, commands[i].firstIndex);
+        EXPECT_EQ(kept[i] + 1, commands[i].count);
+        EXPECT_EQ(static_cast<float>(kept[i]), draws[i].worldFromLocal[3].x);
+        EXPECT_EQ(kept[i] % 2, meshes[i]);
+    }
+}
+
+TEST(MeshPoolTests, compaction_of_all_or_no_draws)
+{
+    std::vector<sim::DrawElementsIndirectCommand> commands(4, sim::make_draw_command({0, 3, 0, 3}));
+    std::vector<sim::InstanceData> draws(4, make_instance(1));
+    std::vector<std::size_t> meshes(4, 0);
+
+    const unsigned char allVisible[] = {1, 1, 1, 1};
+    EXPECT_EQ(4u, sim::compact_draws(allVisible, &commands, &draws, &meshes));
+    EXPECT_EQ(4u, commands.size());
+
+    const unsigned char noneVisible[] = {0, 0, 0, 0};
+    EXPECT_EQ(0u, sim::compact_draws(noneVisible, &commands, &draws, &meshes));
+    EXPECT_TRUE(commands.empty());
+    EXPECT_TRUE(draws.empty());
+    EXPECT_TRUE(meshes.empty());
+
+    // nothing queued
+    EXPECT_EQ(0u, sim::compact_draws(nullptr, &commands, &draws, &meshes));
+}
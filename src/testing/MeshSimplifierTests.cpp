@@ -0,0 +1,157 @@
+#include <sim-driver/meshes/MeshSimplifier.hpp>
+#include <sim-driver/meshes/MeshFunctions.hpp>
+#include <sim-driver/meshes/MeshOptimizer.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+
+glm::vec3 position(const sim::PosNormTexData &data, const std::vector<unsigned> &indices, std::size_t index)
+{
+    const float *p = data.vbo[indices[index]].position;
+    return {p[0], p[1], p[2]};
+}
+
+glm::vec3 position(const sim::PosNormTexData &data, std::size_t index)
+{
+    return position(data, data.ibo, index);
+}
+
+} // namespace
+
+TEST(MeshSimplifierTests, simplified_sphere_stays_a_closed_outward_facing_sphere)
+{
+    sim::PosNormTexData sphere = sim::create_sphere_mesh_data<sim::PosNormTexVertex>(80, 80);
+
+    sim::SimplifyOptions options;
+    options.clusterSize = 1000; // force several clusters
+    float error = -1.0f;
+    sim::PosNormTexData simplified = sim::simplify_mesh(sphere, GL_TRIANGLE_STRIP, 3000, options, &error);
+
+    std::size_t numTriangles = simplified.ibo.size() / 3;
+    EXPECT_LT(numTriangles, 4000u);
+    EXPECT_GT(numTriangles, 0u);
+    EXPECT_GT(error, 0.0f);
+    EXPECT_LT(error, 0.5f);
+    EXPECT_LT(simplified.vbo.size(), sphere.vbo.size());
+
+    for (unsigned index : simplified.ibo) {
+        ASSERT_LT(index, simplified.vbo.size());
+    }
+
+    for (std::size_t t = 0; t < numTriangles; ++t) {
+        glm::vec3 a = position(simplified, t * 3);
+        glm::vec3 b = position(simplified, t * 3 + 1);
+        glm::vec3 c = position(simplified, t * 3 + 2);
+        glm::vec3 normal = glm::cross(b - a, c - a);
+
+        // (nearly) degenerate pole triangles have no reliable orientation
+        if (glm::length(normal) > 1e-5f) {
+            float cosine = glm::dot(normal, a + b + c) / (glm::length(normal) * glm::length(a + b + c));
+            EXPECT_GT(cosine, -1e-3f);
+        }
+    }
+}
+
+TEST(MeshSimplifierTests, lod_chain_levels_get_smaller_and_less_accurate)
+{
+    sim::PosNormTexData torus = sim::create_torus_mesh_data<sim::PosNormTexVertex>(100, 100);
+
+    sim::SimplifyOptions options;
+    options.clusterSize = 2000;
+    std::vector<sim::MeshLod> lods
+        = sim::create_lod_chain(torus, GL_TRIANGLE_STRIP, sim::make_lod_targets(20000, 4), options);
+
+    ASSERT_GE(lods.size(), 3u);
+    EXPECT_EQ(0.0f, lods[0].error);
+
+    for (std::size_t level = 1; level < lods.size(); ++level) {
+        EXPECT_LT(lods[level].data.ibo.size(), lods[level - 1].data.ibo.size());
+        EXPECT_GE(lods[level].error, lods[level - 1].error);
+    }
+}
+
+TEST(MeshSimplifierTests, max_error_limits_the_simplification)
+{
+    sim::PosNormTexData sphere = sim::create_sphere_mesh_data<sim::PosNormTexVertex>(40, 40);
+
+    sim::SimplifyOptions options;
+    options.maxError = 0.0f;
+    float error = -1.0f;
+    sim::PosNormTexData simplified = sim::simplify_mesh(sphere, GL_TRIANGLE_STRIP, 10, options, &error);
+
+    EXPECT_GT(simplified.ibo.size(), 30u);
+    EXPECT_EQ(0.0f, error);
+}
+
+TEST(MeshSimplifierTests, error_is_positional)
+{
+    // texture coordinates change across a plane but its surface doesn't move
+    sim::PosNormTexData plane = sim::create_plane_mesh_data<sim::PosNormTexVertex>(30, 30);
+
+    float error = -1.0f;
+    sim::PosNormTexData simplified = sim::simplify_mesh(plane, GL_TRIANGLE_STRIP, 200, {}, &error);
+
+    EXPECT_LT(simplified.ibo.size(), sim::to_triangle_list(plane.ibo, GL_TRIANGLE_STRIP).size() / 2);
+    EXPECT_NEAR(0.0f, error, 1e-6f);
+}
+
+TEST(MeshSimplifierTests, hard_edges_simplify_but_texture_seams_stay)
+{
+    sim::PosNormTexData sphere = sim::create_sphere_mesh_data<sim::PosNormTexVertex>(40, 40);
+    std::vector<unsigned> triangles = sim::to_triangle_list(sphere.ibo, GL_TRIANGLE_STRIP);
+
+    // every triangle gets its own vertices with the face normal: a faceted sphere
+    sim::PosNormTexData faceted;
+    for (std::size_t t = 0; t < triangles.size() / 3; ++t) {
+        glm::vec3 a = position(sphere, triangles, t * 3);
+        glm::vec3 b = position(sphere, triangles, t * 3 + 1);
+        glm::vec3 c = position(sphere, triangles, t * 3 + 2);
+        glm::vec3 normal = glm::cross(b - a, c - a);
+        if (glm::length(normal) <= 0.0f) {
+            continue;
+        }
+        normal = glm::normalize(normal);
+
+        for (std::size_t k = 0; k < 3; ++k) {
+            sim::PosNormTexVertex vertex = sphere.vbo[triangles[t * 3 + k]];
+            std::copy(&normal.x, &normal.x + 3, vertex.normal);
+            faceted.ibo.push_back(static_cast<unsigned>(faceted.vbo.size()));
+            faceted.vbo.push_back(vertex);
+        }
+    }
+
+    const std::size_t numTriangles = faceted.ibo.size() / 3;
+    sim::PosNormTexData simplified = sim::simplify_mesh(faceted, GL_TRIANGLES, numTriangles / 4);
+    EXPECT_LT(simplified.ibo.size() / 3, numTriangles / 2);
+
+    // the copies picked for each triangle are the ones facing the same way
+    for (std::size_t t = 0; t < simplified.ibo.size() / 3; ++t) {
+        glm::vec3 a = position(simplified, t * 3);
+        glm::vec3 normal = glm::cross(position(simplified, t * 3 + 1) - a, position(simplified, t * 3 + 2) - a);
+        if (glm::length(normal) <= 1e-5f) {
+            continue;
+        }
+        for (std::size_t k = 0; k < 3; ++k) {
+            const float *n = simplified.vbo[simplified.ibo[t * 3 + k]].normal;
+            EXPECT_GT(glm::dot(glm::vec3(n[0], n[1], n[2]), normal), 0.0f);
+        }
+    }
+
+    // giving every copy its own texture coordinates turns all of them into seams
+    for (std::size_t v = 0; v < faceted.vbo.size(); ++v) {
+        faceted.vbo[v].texCoords[0] = static_cast<float>(v);
+    }
+    simplified = sim::simplify_mesh(faceted, GL_TRIANGLES, numTriangles / 4);
+    EXPECT_EQ(faceted.ibo.size(), simplified.ibo.size());
+}
+
+TEST(MeshSimplifierTests, tessellation_error_shrinks_with_resolution)
+{
+    float coarse = sim::estimate_tessellation_error(sim::create_sphere_mesh_data<sim::PosNormTexVertex>(10, 10),
+                                                    GL_TRIANGLE_STRIP);
+    float fine = sim::estimate_tessellation_error(sim::create_sphere_mesh_data<sim::PosNormTexVertex>(100, 100),
+                                                  GL_TRIANGLE_STRIP);
+
+    EXPECT_GT(coarse, 0.0f);
+    EXPECT_LT(fine, coarse * 0.05f); // sagitta shrinks quadratically
+}
@@ -0,0 +1,60 @@
+#include <sim-driver/MultiView.hpp>
+#include <sim-driver/Camera.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+TEST(MultiViewTests, block_holds_every_view)
+{
+    sim::Camera cameras[2];
+    cameras[0].lookAt(glm::vec3(0, 0, 5), glm::vec3(0));
+    cameras[1].lookAt(glm::vec3(5, 0, 0), glm::vec3(0));
+
+    sim::MultiViewBlock block = sim::make_multi_view_block(cameras, 2, sim::MultiViewTarget::Viewports);
+    EXPECT_EQ(2, block.viewInfo.x);
+    EXPECT_EQ(0, block.viewInfo.y);
+    EXPECT_EQ(cameras[0].getPerspectiveScreenFromWorldMatrix(), block.screenFromWorld[0]);
+    EXPECT_EQ(cameras[1].getPerspectiveScreenFromWorldMatrix(), block.screenFromWorld[1]);
+
+    block = sim::make_multi_view_block(cameras, 2, sim::MultiViewTarget::Layers);
+    EXPECT_EQ(1, block.viewInfo.y);
+
+    sim::Camera tooMany[sim::max_views + 1];
+    EXPECT_THROW(sim::make_multi_view_block(tooMany, sim::max_views + 1, sim::MultiViewTarget::Layers),
+                 std::runtime_error);
+}
+
+TEST(MultiViewTests, cube_map_faces_look_along_their_axis)
+{
+    const glm::vec3 center{1, 2, 3};
+    const std::array<sim::Camera, 6> cameras = sim::cube_map_cameras(center, 0.1f, 100.0f);
+
+    const glm::vec3 axes[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+
+    for (std::size_t face = 0; face < cameras.size(); ++face) {
+        // a point along the face axis lands in the middle of that face
+        const glm::vec4 clip = cameras[face].getPerspectiveScreenFromWorldMatrix() * glm::vec4(center + axes[face], 1);
+        EXPECT_NEAR(0.0f, clip.x / clip.w, 1e-5f) << face;
+        EXPECT_NEAR(0.0f, clip.y / clip.w, 1e-5f) << face;
+        EXPECT_GT(clip.w, 0.0f) << face;
+
+        EXPECT_FLOAT_EQ(90.0f, cameras[face].getFovYDegrees());
+        EXPECT_FLOAT_EQ(1.0f, cameras[face].getAspectRatio());
+    }
+}
+
+TEST(MultiViewTests, split_viewports_cover_the_window)
+{
+    EXPECT_TRUE(sim::split_viewports(800, 600, 0).empty());
+
+    std::vector<glm::vec4> viewports = sim::split_viewports(800, 600, 2);
+    ASSERT_EQ(2u, viewports.size());
+    EXPECT_EQ(glm::vec4(0, 0, 400, 600), viewports[0]);
+    EXPECT_EQ(glm::vec4(400, 0, 400, 600), viewports[1]);
+
+    // 2x2 grid, the first view at the top left
+    viewports = sim::split_viewports(800, 600, 3);
+    ASSERT_EQ(3u, viewports.size());
+    EXPECT_EQ(glm::vec4(0, 300, 400, 300), viewports[0]);
+    EXPECT_EQ(glm::vec4(400, 300, 400, 300), viewports[1]);
+    EXPECT_EQ(glm::vec4(0, 0, 400, 300), viewports[2]);
+}
@@ -0,0 +1,87 @@
+#include <sim-driver/renderers/OcclusionCuller.hpp>
+#include <sim-driver/Camera.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr int retest_interval = 4;
+
+sim::Camera make_camera()
+{
+    sim::Camera camera;
+    camera.setEyeVector({0, 0, 0});
+    camera.setLookVector({0, 0, -1});
+    camera.setFovYDegrees(90.0f);
+    camera.setAspectRatio(1.0f);
+    camera.setNearPlane(1.0f);
+    return camera;
+}
+
+} // namespace
+
+TEST(OcclusionCullerTests, visible_objects_are_retested_in_their_own_draw)
+{
+    sim::OcclusionState state;
+    EXPECT_TRUE(state.isVisible());
+
+    // queried every 'retest_interval' frames, counting from frame -1
+    EXPECT_EQ(sim::OcclusionAction::Draw, state.next(1, retest_interval, false));
+    EXPECT_EQ(sim::OcclusionAction::Draw, state.next(2, retest_interval, false));
+    EXPECT_EQ(sim::OcclusionAction::DrawInQuery, state.next(3, retest_interval, false));
+    EXPECT_TRUE(state.isPending());
+    EXPECT_EQ(sim::OcclusionAction::Draw, state.next(4, retest_interval, false));
+
+    state.setResult(true);
+    EXPECT_FALSE(state.isPending());
+    EXPECT_EQ(sim::OcclusionAction::Draw, state.next(6, retest_interval, false));
+    EXPECT_EQ(sim::OcclusionAction::DrawInQuery, state.next(7, retest_interval, false));
+
+    // a result that is late doesn't cause another query
+    EXPECT_EQ(sim::OcclusionAction::Draw, state.next(20, retest_interval, false));
+}
+
+TEST(OcclusionCullerTests, hidden_objects_are_drawn_conditionally)
+{
+    sim::OcclusionState state;
+    state.setResult(false);
+    EXPECT_FALSE(state.isVisible());
+
+    // the box is queried every frame a result is available, without waiting for the interval
+    EXPECT_EQ(sim::OcclusionAction::BoxQueryThenConditionalDraw, state.next(2, retest_interval, false));
+    EXPECT_EQ(sim::OcclusionAction::ConditionalDraw, state.next(3, retest_interval, false));
+
+    state.setResult(false);
+    EXPECT_EQ(sim::OcclusionAction::BoxQueryThenConditionalDraw, state.next(4, retest_interval, false));
+
+    // back in view: drawn normally and retested once the interval passed
+    state.setResult(true);
+    EXPECT_TRUE(state.isVisible());
+    EXPECT_EQ(sim::OcclusionAction::Draw, state.next(5, retest_interval, false));
+    EXPECT_EQ(sim::OcclusionAction::DrawInQuery, state.next(8, retest_interval, false));
+}
+
+TEST(OcclusionCullerTests, eye_inside_objects_are_drawn_without_queries)
+{
+    sim::OcclusionState state;
+    EXPECT_EQ(sim::OcclusionAction::Draw, state.next(1, retest_interval, true));
+    EXPECT_FALSE(state.isPending());
+
+    // even if the last result said hidden
+    state.setResult(false);
+    EXPECT_EQ(sim::OcclusionAction::Draw, state.next(3, retest_interval, true));
+    EXPECT_FALSE(state.isPending());
+}
+
+TEST(OcclusionCullerTests, eye_inside_includes_the_near_plane)
+{
+    const sim::Camera camera = make_camera();
+
+    // the near plane corners are sqrt(3) from the eye
+    EXPECT_TRUE(sim::is_eye_inside(camera, {{-1, -1, -1}, {1, 1, 1}}));
+    EXPECT_TRUE(sim::is_eye_inside(camera, {{-1, -1, -3}, {1, 1, -1.5f}}));
+    EXPECT_FALSE(sim::is_eye_inside(camera, {{-1, -1, -4}, {1, 1, -2}}));
+    EXPECT_FALSE(sim::is_eye_inside(camera, {{2, -1, -3}, {3, 1, -1}}));
+
+    // boxes behind the eye count too since they would be clipped the same way
+    EXPECT_TRUE(sim::is_eye_inside(camera, {{-1, -1, 1.5f}, {1, 1, 2}}));
+}
@@ -0,0 +1,109 @@
+#include <sim-driver/meshes/MeshFunctions.hpp>
+#include <sim-driver/ParallelFor.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+
+namespace {
+
+constexpr float eps = 1e-5f;
+
+glm::vec3 to_vec3(const float (&v)[3])
+{
+    return {v[0], v[1], v[2]};
+}
+
+} // namespace
+
+TEST(ParametricSurfaceTests, parallel_for_visits_every_index_once)
+{
+    std::vector<std::atomic<int>> visits(100000);
+    for (auto &visit : visits) {
+        visit = 0;
+    }
+
+    sim::parallel_for(0, visits.size(), 1000, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+    });
+
+    for (const auto &visit : visits) {
+        EXPECT_EQ(1, visit);
+    }
+}
+
+TEST(ParametricSurfaceTests, parallel_for_rethrows_worker_exceptions)
+{
+    EXPECT_THROW(sim::parallel_for(0, 64, 1, [](std::size_t begin, std::size_t) {
+        if (begin == 0) {
+            throw std::runtime_error("chunk failed");
+        }
+    }),
+                 std::runtime_error);
+}
+
+TEST(ParametricSurfaceTests, nested_parallel_for_finishes)
+{
+    std::atomic<int> visits{0};
+
+    // inner calls run on pool workers while the outer chunks still hold them
+    for (int repeat = 0; repeat < 20; ++repeat) {
+        sim::parallel_for(0, 16, 1, [&](std::size_t outerBegin, std::size_t outerEnd) {
+            for (std::size_t i = outerBegin; i < outerEnd; ++i) {
+                sim::parallel_for(0, 1000, 10, [&](std::size_t begin, std::size_t end) {
+                    visits += static_cast<int>(end - begin);
+                });
+            }
+        });
+    }
+
+    EXPECT_EQ(20 * 16 * 1000, visits);
+}
+
+TEST(ParametricSurfaceTests, sphere_grid_matches_strip_layout)
+{
+    const int u_divisions = 37;
+    const int v_divisions = 23;
+    sim::PosNormTexData data = sim::create_sphere_mesh_data<sim::PosNormTexVertex>(u_divisions, v_divisions);
+
+    const std::size_t rows = u_divisions + 2;
+    const std::size_t cols = v_divisions + 2;
+    ASSERT_EQ(rows * cols, data.vbo.size());
+    ASSERT_EQ((rows - 1) * (cols * 2 + 1), data.ibo.size());
+
+    for (const auto &vertex : data.vbo) {
+        EXPECT_NEAR(1.0f, glm::length(to_vec3(vertex.position)), eps);
+    }
+
+    // first strip alternates between the first two rows then restarts
+    EXPECT_EQ(0u, data.ibo[0]);
+    EXPECT_EQ(cols, data.ibo[1]);
+    EXPECT_EQ(1u, data.ibo[2]);
+    EXPECT_EQ(sim::primitiveRestart(), data.ibo[cols * 2]);
+    EXPECT_EQ(cols, data.ibo[cols * 2 + 1]);
+
+    // north pole at v = 0
+    EXPECT_NEAR(1.0f, data.vbo[0].position[1], eps);
+    EXPECT_NEAR(1.0f, data.vbo[0].texCoords[0], eps);
+}
+
+TEST(ParametricSurfaceTests, surfaces_face_along_their_normals)
+{
+    using DataFun = sim::PosNormTexData (*)(int, int);
+
+    for (DataFun fun : {&sim::create_sphere_mesh_data<sim::PosNormTexVertex>,
+                        &sim::create_torus_mesh_data<sim::PosNormTexVertex>,
+                        &sim::create_plane_mesh_data<sim::PosNormTexVertex>,
+                        &sim::create_cylinder_mesh_data<sim::PosNormTexVertex>}) {
+        sim::PosNormTexData data = fun(8, 8);
+
+        // the first (counter-clockwise) triangle of a strip in the middle of the grid
+        std::size_t strip = 4 * (8 + 2 + 8 + 2 + 1) + 8;
+        glm::vec3 a = to_vec3(data.vbo[data.ibo[strip]].position);
+        glm::vec3 b = to_vec3(data.vbo[data.ibo[strip + 1]].position);
+        glm::vec3 c = to_vec3(data.vbo[data.ibo[strip + 2]].position);
+
+        glm::vec3 faceNormal = glm::cross(b - a, c - a);
+        EXPECT_GT(glm::dot(faceNormal, to_vec3(data.vbo[data.ibo[strip]].normal)), 0.0f);
+    }
+}
@@ -0,0 +1,43 @@
+#include <sim-driver/ShaderVariants.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+TEST(ShaderVariantsTests, defines_follow_the_version_line)
+{
+    const std::string source = "#version 410\n#extension GL_ARB_separate_shader_objects : enable\nvoid main() {}\n";
+
+    EXPECT_EQ(source, sim::inject_defines(source, {}));
+
+    EXPECT_EQ("#version 410\n"
+              "#define DISPLAY_MODE 5\n"
+              "#define HAS_TEXTURE\n"
+              "#extension GL_ARB_separate_shader_objects : enable\nvoid main() {}\n",
+              sim::inject_defines(source, {"DISPLAY_MODE=5", "HAS_TEXTURE"}));
+
+    // comments before the version line and no version at all
+    EXPECT_EQ("// header\n#version 410\n#define A 1\nvoid main() {}",
+              sim::inject_defines("// header\n#version 410\nvoid main() {}", {"A=1"}));
+    EXPECT_EQ("#define A\nvoid main() {}", sim::inject_defines("void main() {}", {"A"}));
+    EXPECT_EQ("#version 410\n#define A\n", sim::inject_defines("#version 410", {"A"}));
+
+    EXPECT_THROW(sim::inject_defines(source, {""}), std::runtime_error);
+}
+
+TEST(ShaderVariantsTests, keys_ignore_define_order)
+{
+    EXPECT_EQ(sim::shader_variant_key("shader.frag", {"A", "B=2"}),
+              sim::shader_variant_key("shader.frag", {"B=2", "A"}));
+    EXPECT_NE(sim::shader_variant_key("shader.frag", {"A"}), sim::shader_variant_key("shader.frag", {"B"}));
+    EXPECT_NE(sim::shader_variant_key("shader.frag", {}), sim::shader_variant_key("shader.vert", {}));
+}
+
+TEST(ShaderVariantsTests, binary_names_change_with_source_and_driver)
+{
+    const std::string key = sim::shader_variant_key("shader.frag", {"DISPLAY_MODE=6"});
+    const std::string name = sim::program_binary_file_name(key, "void main() {}", "driver 1");
+
+    EXPECT_EQ(name, sim::program_binary_file_name(key, "void main() {}", "driver 1"));
+    EXPECT_NE(name, sim::program_binary_file_name(key, "void main() { }", "driver 1"));
+    EXPECT_NE(name, sim::program_binary_file_name(key, "void main() {}", "driver 2"));
+    EXPECT_EQ(std::string(".glbin"), name.substr(name.size() - 6));
+}
@@ -0,0 +1,77 @@
+#include <sim-driver/StateInterpolator.hpp>
+#include <gtest/gtest.h>
+
+TEST(StateInterpolatorTests, registered_values_start_at_their_initial_value)
+{
+    sim::StateInterpolator interpolator;
+    const float block[] = {1, 2, 3};
+    auto blockHandle = interpolator.addBlock(block, 3);
+    auto matrixHandle = interpolator.addMatrix(glm::mat4(2.0f));
+
+    EXPECT_EQ(19u, interpolator.getNumFloats());
+
+    interpolator.beginUpdate();
+    interpolator.interpolate(0.5f);
+
+    EXPECT_EQ(2.0f, interpolator.getBlock(blockHandle)[1]);
+    EXPECT_EQ(glm::mat4(2.0f), interpolator.getMatrix(matrixHandle));
+}
+
+TEST(StateInterpolatorTests, interpolates_between_the_last_two_updates)
+{
+    sim::StateInterpolator interpolator;
+    auto matrixHandle = interpolator.addMatrix(glm::mat4(0.0f));
+
+    interpolator.beginUpdate();
+    interpolator.setMatrix(matrixHandle, glm::mat4(4.0f));
+    interpolator.beginUpdate();
+    interpolator.setMatrix(matrixHandle, glm::mat4(8.0f));
+
+    interpolator.interpolate(0.0f);
+    EXPECT_EQ(glm::mat4(4.0f), interpolator.getMatrix(matrixHandle));
+
+    interpolator.interpolate(0.25f);
+    EXPECT_EQ(glm::mat4(5.0f), interpolator.getMatrix(matrixHandle));
+
+    interpolator.interpolate(1.0f);
+    EXPECT_EQ(glm::mat4(8.0f), interpolator.getMatrix(matrixHandle));
+
+    // not set during this step so it stays put
+    interpolator.beginUpdate();
+    interpolator.interpolate(0.5f);
+    EXPECT_EQ(glm::mat4(8.0f), interpolator.getMatrix(matrixHandle));
+}
+
+TEST(StateInterpolatorTests, interpolates_camera_parameters)
+{
+    sim::Camera start;
+    start.lookAt({0, 0, 0}, {0, 0, -1});
+    start.perspective(60.0f, 1.0f, 0.1f, 100.0f);
+
+    sim::Camera end;
+    end.lookAt({2, 4, 0}, {2, 4, -1});
+    end.perspective(60.0f, 2.0f, 0.1f, 100.0f);
+
+    sim::StateInterpolator interpolator;
+    auto cameraHandle = interpolator.addCamera(start);
+    const sim::Camera &camera = interpolator.getCamera(cameraHandle);
+
+    interpolator.beginUpdate();
+    interpolator.setCamera(cameraHandle, end);
+    interpolator.interpolate(0.5f);
+
+    EXPECT_EQ(glm::vec3(1, 2, 0), camera.getEyeVector());
+    EXPECT_EQ(glm::vec3(0, 0, -1), camera.getLookVector());
+    EXPECT_FLOAT_EQ(1.5f, camera.getAspectRatio());
+    EXPECT_FLOAT_EQ(60.0f, camera.getFovYDegrees());
+
+    sim::Camera expected;
+    expected.lookAt({1, 2, 0}, {1, 2, -1});
+    expected.perspective(60.0f, 1.5f, 0.1f, 100.0f);
+    EXPECT_EQ(expected.getPerspectiveScreenFromWorldMatrix(), camera.getPerspectiveScreenFromWorldMatrix());
+
+    // registering more state keeps the camera reference valid
+    interpolator.addMatrix(glm::mat4(1.0f));
+    interpolator.interpolate(1.0f);
+    EXPECT_EQ(glm::vec3(2, 4, 0), camera.getEyeVector());
+}
@@ -0,0 +1,140 @@
+#include <sim-driver/meshes/VertexCompression.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+TEST(VertexCompressionTests, unorm16_round_trip_and_clamping)
+{
+    // rounding to the nearest step keeps the error within half a step
+    const float halfStep = 0.5f / 65535.0f;
+    for (int i = 0; i <= 1000; ++i) {
+        const float value = static_cast<float>(i) / 1000.0f;
+        EXPECT_NEAR(value, sim::unpack_unorm16(sim::pack_unorm16(value)), halfStep + 1e-7f);
+    }
+
+    EXPECT_EQ(0u, sim::pack_unorm16(0.0f));
+    EXPECT_EQ(65535u, sim::pack_unorm16(1.0f));
+    EXPECT_EQ(0u, sim::pack_unorm16(-3.0f));
+    EXPECT_EQ(65535u, sim::pack_unorm16(2.5f));
+}
+
+TEST(VertexCompressionTests, snorm_2_10_10_10_rev_sign_and_w)
+{
+    const float halfStep = 0.5f / 511.0f;
+
+    const glm::vec3 normals[] = {{1, 0, 0}, {0, -1, 0}, {0, 0, 1}, {0.6f, -0.8f, 0}, {-0.48f, 0.6f, -0.64f}};
+    for (const glm::vec3 &normal : normals) {
+        const unsigned packed = sim::pack_snorm_2_10_10_10_rev(normal);
+
+        // the 2 bit w component is always zero
+        EXPECT_EQ(0u, packed >> 30u);
+
+        const glm::vec3 unpacked = sim::unpack_snorm_2_10_10_10_rev(packed);
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_NEAR(normal[i], unpacked[i], halfStep + 1e-6f);
+        }
+    }
+
+    // x in the low bits, two's complement negatives
+    EXPECT_EQ(511u, sim::pack_snorm_2_10_10_10_rev({1, 0, 0}));
+    EXPECT_EQ(0x201u, sim::pack_snorm_2_10_10_10_rev({-1, 0, 0}));
+    EXPECT_EQ(0x201u << 10u, sim::pack_snorm_2_10_10_10_rev({0, -1, 0}));
+    EXPECT_EQ(511u << 20u, sim::pack_snorm_2_10_10_10_rev({0, 0, 1}));
+
+    // out of range input is clamped to [-1, 1]
+    EXPECT_EQ(sim::pack_snorm_2_10_10_10_rev({1, -1, 1}), sim::pack_snorm_2_10_10_10_rev({5, -7, 1.5f}));
+
+    // -512 is also -1 (GL clamps it the same way)
+    EXPECT_EQ(-1.0f, sim::unpack_snorm_2_10_10_10_rev(0x200u).x);
+}
+
+TEST(VertexCompressionTests, pos_norm_tex_data_round_trip)
+{
+    sim::PosNormTexData data;
+    data.vbo = {{{-2, 1, 10}, {0, 0, 1}, {0, 0}},
+                {{3, 1.5f, 10}, {0, 1, 0}, {1, 1}},
+                {{0.25f, 4, 10}, {1, 0, 0}, {0.3f, 0.7f}},
+                {{1, 2, 10}, {0, 0, -1}, {-0.5f, 1.5f}}}; // tiling texture coordinates
+    data.ibo = {0, 1, 2, 3};
+
+    glm::mat4 localFromQuantized;
+    EXPECT_THROW(sim::pack_pos_norm_tex_data(data, &localFromQuantized), std::runtime_error);
+
+    glm::vec4 texFromQuantized;
+    const sim::PackedPosNormTexData packed = sim::pack_pos_norm_tex_data(data, &localFromQuantized, &texFromQuantized);
+
+    ASSERT_EQ(data.vbo.size(), packed.vbo.size());
+    EXPECT_EQ(data.ibo, packed.ibo);
+
+    // error bound: half a step over the extent of each axis
+    const glm::vec3 extent{5, 3, 1}; // z is flat so it gets a unit scale
+    for (std::size_t i = 0; i < data.vbo.size(); ++i) {
+        const sim::PackedPosNormTexVertex &vertex = packed.vbo[i];
+        const glm::vec4 quantized{sim::unpack_unorm16(vertex.position[0]),
+                                  sim::unpack_unorm16(vertex.position[1]),
+                                  sim::unpack_unorm16(vertex.position[2]),
+                                  1.0f};
+        const glm::vec4 local = localFromQuantized * quantized;
+
+        for (int a = 0; a < 3; ++a) {
+            EXPECT_NEAR(data.vbo[i].position[a], local[a], extent[a] * 0.5f / 65535.0f + 1e-5f) << i;
+        }
+        EXPECT_EQ(0u, vertex.padding);
+
+        const glm::vec3 normal = sim::unpack_snorm_2_10_10_10_rev(vertex.normal);
+        for (int a = 0; a < 3; ++a) {
+            EXPECT_NEAR(data.vbo[i].normal[a], normal[a], 0.5f / 511.0f + 1e-6f) << i;
+        }
+    }
+
+    // the texture range is [-0.5, 1] x [0, 1.5]
+    EXPECT_EQ(glm::vec4(1.5f, 1.5f, -0.5f, 0.0f), texFromQuantized);
+    EXPECT_EQ(0u, packed.vbo[3].texCoords[0]);
+    EXPECT_EQ(65535u, packed.vbo[3].texCoords[1]);
+    for (std::size_t i = 0; i < data.vbo.size(); ++i) {
+        for (int a = 0; a < 2; ++a) {
+            const float tex = sim::unpack_unorm16(packed.vbo[i].texCoords[a]) * texFromQuantized[a]
+                + texFromQuantized[a + 2];
+            EXPECT_NEAR(data.vbo[i].texCoords[a], tex, 1.5f * 0.5f / 65535.0f + 1e-6f) << i;
+        }
+    }
+}
+
+TEST(VertexCompressionTests, texture_coordinates_in_unit_range_are_unscaled)
+{
+    sim::PosNormTexData data;
+    data.vbo = {{{0, 0, 0}, {0, 0, 1}, {0, 0.25f}}, {{1, 1, 1}, {0, 0, 1}, {1, 0.75f}}};
+
+    glm::mat4 localFromQuantized;
+    glm::vec4 texFromQuantized;
+    const sim::PackedPosNormTexData packed = sim::pack_pos_norm_tex_data(data, &localFromQuantized, &texFromQuantized);
+
+    EXPECT_EQ(glm::vec4(1, 1, 0, 0), texFromQuantized);
+    EXPECT_EQ(sim::pack_unorm16(0.25f), packed.vbo[0].texCoords[1]);
+    EXPECT_EQ(sim::pack_unorm16(1.0f), packed.vbo[1].texCoords[0]);
+}
+
+TEST(VertexCompressionTests, degenerate_bounds_stay_invertible)
+{
+    // a single point: zero extent on every axis
+    sim::PosNormTexData data;
+    data.vbo = {{{7, -3, 2}, {0, 1, 0}, {0.5f, 0.5f}}};
+
+    glm::mat4 localFromQuantized;
+    const sim::PackedPosNormTexData packed = sim::pack_pos_norm_tex_data(data, &localFromQuantized);
+
+    for (int a = 0; a < 3; ++a) {
+        EXPECT_EQ(0u, packed.vbo[0].position[a]);
+        EXPECT_EQ(1.0f, localFromQuantized[a][a]);
+        EXPECT_EQ(data.vbo[0].position[a], localFromQuantized[3][a]);
+    }
+
+    // no vertices at all
+    const sim::PackedPosNormTexData empty = sim::pack_pos_norm_tex_data({}, &localFromQuantized);
+    EXPECT_TRUE(empty.vbo.empty());
+    EXPECT_EQ(glm::vec4(0, 0, 0, 1), localFromQuantized[3]);
+    for (int a = 0; a < 3; ++a) {
+        EXPECT_FALSE(std::isnan(localFromQuantized[a][a]));
+        EXPECT_EQ(1.0f, localFromQuantized[a][a]);
+    }
+}
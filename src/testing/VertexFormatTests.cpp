@@ -0,0 +1,79 @@
+#include <sim-driver/VertexFormat.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+
+struct CustomVertex
+{
+    float position[3];
+    unsigned char color[4];
+    int id[1];
+};
+
+} // namespace
+
+namespace sim {
+
+template <>
+struct VertexFormat<CustomVertex>
+{
+    static constexpr std::array<VertexAttrib, 3> attributes()
+    {
+        return {{
+            make_vertex_attrib<decltype(CustomVertex::position)>(0, offsetof(CustomVertex, position)),
+            make_vertex_attrib<decltype(CustomVertex::color)>(3, offsetof(CustomVertex, color), GL_TRUE),
+            make_vertex_attrib<decltype(CustomVertex::id)>(4, offsetof(CustomVertex, id)),
+        }};
+    }
+};
+
+} // namespace sim
+
+TEST(VertexFormatTests, pos_norm_tex_layout_is_derived_at_compile_time)
+{
+    constexpr auto attribs = sim::VertexFormat<sim::PosNormTexVertex>::attributes();
+
+    static_assert(attribs.size() == 3, "");
+    static_assert(attribs[0].location == 0 && attribs[0].size == 3 && attribs[0].offset == 0, "");
+    static_assert(attribs[1].location == 1 && attribs[1].size == 3 && attribs[1].offset == sizeof(float) * 3, "");
+    static_assert(attribs[2].location == 2 && attribs[2].size == 2 && attribs[2].offset == sizeof(float) * 6, "");
+
+    for (const auto &attrib : attribs) {
+        EXPECT_EQ(static_cast<GLenum>(GL_FLOAT), attrib.type);
+        EXPECT_EQ(GL_FALSE, attrib.normalized);
+    }
+}
+
+TEST(VertexFormatTests, custom_vertex_types_only_need_a_specialization)
+{
+    constexpr auto attribs = sim::VertexFormat<CustomVertex>::attributes();
+
+    EXPECT_EQ(static_cast<GLenum>(GL_FLOAT), attribs[0].type);
+
+    EXPECT_EQ(static_cast<GLenum>(GL_UNSIGNED_BYTE), attribs[1].type);
+    EXPECT_EQ(4, attribs[1].size);
+    EXPECT_EQ(GL_TRUE, attribs[1].normalized);
+    EXPECT_EQ(offsetof(CustomVertex, color), attribs[1].offset);
+
+    EXPECT_EQ(static_cast<GLenum>(GL_INT), attribs[2].type);
+    EXPECT_EQ(1, attribs[2].size);
+    EXPECT_EQ(4u, attribs[2].location);
+}
+
+TEST(VertexFormatTests, instance_data_advances_once_per_instance)
+{
+    constexpr auto attribs = sim::VertexFormat<sim::InstanceData>::attributes();
+
+    static_assert(attribs.size() == 5, "");
+
+    for (std::size_t i = 0; i < attribs.size(); ++i) {
+        EXPECT_EQ(3u + i, attribs[i].location); // after the per vertex attributes
+        EXPECT_EQ(4, attribs[i].size);
+        EXPECT_EQ(1u, attribs[i].divisor);
+        EXPECT_EQ(i * sizeof(float) * 4, attribs[i].offset);
+    }
+
+    for (const auto &attrib : sim::VertexFormat<sim::PosNormTexVertex>::attributes()) {
+        EXPECT_EQ(0u, attrib.divisor);
+    }
+}
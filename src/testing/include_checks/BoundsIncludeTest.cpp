@@ -0,0 +1,7 @@
+#include <sim-driver/Bounds.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, Bounds)
+{
+    EXPECT_TRUE(true);
+}
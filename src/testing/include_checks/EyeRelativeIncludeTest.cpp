@@ -0,0 +1,7 @@
+#include <sim-driver/EyeRelative.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, EyeRelative)
+{
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,7 @@
+#include <sim-driver/Frustum.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, Frustum)
+{
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,7 @@
+#include <sim-driver/MappedFile.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, MappedFile)
+{
+    EXPECT_TRUE(true);
+}
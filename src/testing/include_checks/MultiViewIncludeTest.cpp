@@ -0,0 +1,7 @@
+#include <sim-driver/MultiView.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, MultiView)
+{
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,7 @@
+#include <sim-driver/ParallelFor.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, ParallelFor)
+{
+    EXPECT_TRUE(true);
+}
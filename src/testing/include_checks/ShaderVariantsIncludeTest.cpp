@@ -0,0 +1,7 @@
+#include <sim-driver/ShaderVariants.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, ShaderVariants)
+{
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,7 @@
+#include <sim-driver/StateInterpolator.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, StateInterpolator)
+{
+    EXPECT_TRUE(true);
+}
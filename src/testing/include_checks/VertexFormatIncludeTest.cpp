@@ -0,0 +1,7 @@
+#include <sim-driver/VertexFormat.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, VertexFormat)
+{
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,7 @@
+#include <sim-driver/meshes/AsyncLodBuilder.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, AsyncLodBuilder)
+{
+    EXPECT_TRUE(true);
+}
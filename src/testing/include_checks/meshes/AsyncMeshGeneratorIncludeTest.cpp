@@ -0,0 +1,7 @@
+#include <sim-driver/meshes/AsyncMeshGenerator.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, AsyncMeshGenerator)
+{
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,7 @@
+#include <sim-driver/meshes/MeshBvh.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, MeshBvh)
+{
+    EXPECT_TRUE(true);
+}
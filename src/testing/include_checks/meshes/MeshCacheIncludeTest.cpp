@@ -0,0 +1,7 @@
+#include <sim-driver/meshes/MeshCache.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, MeshCache)
+{
+    EXPECT_TRUE(true);
+}
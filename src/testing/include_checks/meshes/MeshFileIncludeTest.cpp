@@ -0,0 +1,7 @@
+#include <sim-driver/meshes/MeshFile.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, MeshFile)
+{
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,7 @@
+#include <sim-driver/meshes/MeshImport.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, MeshImport)
+{
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,7 @@
+#include <sim-driver/meshes/MeshNormals.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, MeshNormals)
+{
+    EXPECT_TRUE(true);
+}
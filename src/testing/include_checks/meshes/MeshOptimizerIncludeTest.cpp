@@ -0,0 +1,7 @@
+#include <sim-driver/meshes/MeshOptimizer.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, MeshOptimizer)
+{
+    EXPECT_TRUE(true);
+}
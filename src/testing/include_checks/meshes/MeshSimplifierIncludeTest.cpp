@@ -0,0 +1,7 @@
+#include <sim-driver/meshes/MeshSimplifier.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, MeshSimplifier)
+{
+    EXPECT_TRUE(true);
+}
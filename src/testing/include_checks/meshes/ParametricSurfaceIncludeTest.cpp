@@ -0,0 +1,7 @@
+#include <sim-driver/meshes/ParametricSurface.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, ParametricSurface)
+{
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,7 @@
+#include <sim-driver/meshes/VertexCompression.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, VertexCompression)
+{
+    EXPECT_TRUE(true);
+}
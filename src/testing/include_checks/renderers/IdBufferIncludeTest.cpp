@@ -0,0 +1,7 @@
+#include <sim-driver/renderers/IdBuffer.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, IdBuffer)
+{
+    EXPECT_TRUE(true);
+}
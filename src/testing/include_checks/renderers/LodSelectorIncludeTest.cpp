@@ -0,0 +1,7 @@
+#include <sim-driver/renderers/LodSelector.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, LodSelector)
+{
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,7 @@
+#include <sim-driver/renderers/MeshPool.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, MeshPool)
+{
+    EXPECT_TRUE(true);
+}
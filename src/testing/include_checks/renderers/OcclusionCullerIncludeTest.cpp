@@ -0,0 +1,7 @@
+#include <sim-driver/renderers/OcclusionCuller.hpp>
+#include <gtest/gtest.h>
+
+TEST(IncludesCheck, OcclusionCuller)
+{
+    EXPECT_TRUE(true);
+}